@@ -0,0 +1,5 @@
+#include "ALUTables.h"
+
+//the lookups bind references to the tables, before C++17 that needs a definition outside the struct
+constexpr ALUTables::ShiftTable ALUTables::Tables::s_Shift;
+constexpr ALUTables::DecimalAdjustTable ALUTables::Tables::s_DecimalAdjust;
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Types.h"
+
+//Result and carry out of the 8 bit ops whose flags used to be worked out bit by bit. Z follows from
+//the result, N and H are fixed for all of them, so one load gives everything the CPU stores
+struct GBALUResult
+{
+	uint8 Result;
+	bool Carry;
+};
+
+namespace ALUTables
+{
+	//in CB opcode order, bits 3-5 of the opcode
+	enum EShift : uint8
+	{
+		RLC,
+		RRC,
+		RL,
+		RR,
+		SLA,
+		SRA,
+		SWAP,
+		SRL,
+		ShiftCount
+	};
+
+	constexpr GBALUResult Shift(uint32 Operation, uint8 Value, bool CarryIn)
+	{
+		bool Low = (Value & 0x01) != 0;
+		bool High = (Value & 0x80) != 0;
+		switch (Operation)
+		{
+		case RLC:
+			return { uint8((Value << 1) | (High ? 0x01 : 0)), High };
+		case RRC:
+			return { uint8((Value >> 1) | (Low ? 0x80 : 0)), Low };
+		case RL:
+			return { uint8((Value << 1) | (CarryIn ? 0x01 : 0)), High };
+		case RR:
+			return { uint8((Value >> 1) | (CarryIn ? 0x80 : 0)), Low };
+		case SLA:
+			return { uint8(Value << 1), High };
+		case SRA:
+			return { uint8((Value >> 1) | (Value & 0x80)), Low };
+		case SWAP:
+			return { uint8((Value << 4) | (Value >> 4)), false };
+		default:
+			return { uint8(Value >> 1), Low };
+		}
+	}
+
+	//C is only ever set here, DAA leaves a carry that was already there
+	constexpr GBALUResult DecimalAdjust(uint8 A, bool N, bool H, bool C)
+	{
+		int32 Value = A;
+		if (!N)
+		{
+			if (H || ((Value & 0x0F) > 9))
+			{
+				Value += 0x06;
+			}
+
+			if (C || (Value > 0x9F))
+			{
+				Value += 0x60;
+			}
+		}
+		else
+		{
+			if (H)
+			{
+				Value = (Value - 0x06) & 0xFF;
+			}
+
+			if (C)
+			{
+				Value -= 0x60;
+			}
+		}
+		return { uint8(Value), C || ((Value & 0x100) != 0) };
+	}
+
+	//carry in on bit 8 of the index, only RL and RR look at it
+	struct ShiftTable
+	{
+		GBALUResult Entries[ShiftCount][512];
+	};
+
+	constexpr ShiftTable MakeShiftTable()
+	{
+		ShiftTable Table = {};
+		for (uint32 Operation = 0; Operation < ShiftCount; ++Operation)
+		{
+			for (uint32 i = 0; i < 512; ++i)
+			{
+				Table.Entries[Operation][i] = Shift(Operation, uint8(i), i >= 256);
+			}
+		}
+		return Table;
+	}
+
+	//indexed by A | N << 8 | H << 9 | C << 10
+	struct DecimalAdjustTable
+	{
+		GBALUResult Entries[2048];
+	};
+
+	constexpr DecimalAdjustTable MakeDecimalAdjustTable()
+	{
+		DecimalAdjustTable Table = {};
+		for (uint32 i = 0; i < 2048; ++i)
+		{
+			Table.Entries[i] = DecimalAdjust(uint8(i), (i & 0x100) != 0, (i & 0x200) != 0, (i & 0x400) != 0);
+		}
+		return Table;
+	}
+
+	//static members instead of inline variables so this builds as C++14, defined in ALUTables.cpp
+	struct Tables
+	{
+		static constexpr ShiftTable s_Shift = MakeShiftTable();
+		static constexpr DecimalAdjustTable s_DecimalAdjust = MakeDecimalAdjustTable();
+	};
+
+	inline const GBALUResult& LookupShift(EShift Operation, uint8 Value, bool CarryIn)
+	{
+		return Tables::s_Shift.Entries[Operation][(CarryIn ? 0x100 : 0) | Value];
+	}
+
+	inline const GBALUResult& LookupDecimalAdjust(uint8 A, bool N, bool H, bool C)
+	{
+		return Tables::s_DecimalAdjust.Entries[A | (N ? 0x100 : 0) | (H ? 0x200 : 0) | (C ? 0x400 : 0)];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "AudioRing.h"
+#include <algorithm>
+
+AudioRing::AudioRing(uint32 Capacity) :
+	m_WriteIndex(0)
+	, m_ReadIndex(0)
+	, m_Underruns(0)
+{
+	uint32 size = 1;
+	while (size < Capacity)
+	{
+		size <<= 1;
+	}
+
+	m_Samples.resize(size);
+	m_Mask = size - 1;
+}
+
+uint32 AudioRing::Push(const GBSoundSample* Samples, uint32 Count)
+{
+	uint32 write = m_WriteIndex.load(std::memory_order_relaxed);
+	uint32 read = m_ReadIndex.load(std::memory_order_acquire);
+
+	uint32 freeSpace = GetCapacity() - (write - read);
+	Count = std::min(Count, freeSpace);
+
+	//copy in at most two pieces around the end of the storage
+	uint32 start = write & m_Mask;
+	uint32 firstPart = std::min(Count, GetCapacity() - start);
+	std::copy(Samples, Samples + firstPart, m_Samples.begin() + start);
+	std::copy(Samples + firstPart, Samples + Count, m_Samples.begin());
+
+	m_WriteIndex.store(write + Count, std::memory_order_release);
+	return Count;
+}
+
+uint32 AudioRing::Pop(GBSoundSample* Samples, uint32 Count)
+{
+	uint32 read = m_ReadIndex.load(std::memory_order_relaxed);
+	uint32 write = m_WriteIndex.load(std::memory_order_acquire);
+
+	uint32 available = write - read;
+	if (available < Count)
+	{
+		m_Underruns.fetch_add(1, std::memory_order_relaxed);
+		Count = available;
+	}
+
+	uint32 start = read & m_Mask;
+	uint32 firstPart = std::min(Count, GetCapacity() - start);
+	std::copy(m_Samples.begin() + start, m_Samples.begin() + start + firstPart, Samples);
+	std::copy(m_Samples.begin(), m_Samples.begin() + (Count - firstPart), Samples + firstPart);
+
+	m_ReadIndex.store(read + Count, std::memory_order_release);
+	return Count;
+}
+
+uint32 AudioRing::GetFillLevel() const
+{
+	uint32 write = m_WriteIndex.load(std::memory_order_acquire);
+	uint32 read = m_ReadIndex.load(std::memory_order_acquire);
+	return write - read;
+}
\ No newline at end of file
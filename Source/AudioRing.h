@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Types.h"
+#include "Platform.h"
+#include <atomic>
+#include <vector>
+
+//Lock-free single producer / single consumer ring of stereo samples.
+//The emulation thread pushes, the audio device thread pops and neither of them ever blocks.
+class AudioRing
+{
+public:
+	//Capacity is rounded up to a power of two
+	explicit AudioRing(uint32 Capacity = 8192);
+
+	//producer side, returns how many samples fit, the rest is dropped
+	uint32 Push(const GBSoundSample* Samples, uint32 Count);
+
+	//consumer side, returns how many samples were copied
+	uint32 Pop(GBSoundSample* Samples, uint32 Count);
+
+	//callable from both sides, the other side may have moved on by the time it's used
+	uint32 GetFillLevel() const;
+	uint32 GetCapacity() const { return m_Mask + 1; }
+	uint32 GetUnderrunCount() const { return m_Underruns.load(std::memory_order_relaxed); }
+
+private:
+	std::vector<GBSoundSample> m_Samples;
+	uint32 m_Mask = 0;
+
+	//free running indices, wrapped with m_Mask on access. Kept apart so the two threads don't share a cache line
+	ALIGN(64) std::atomic<uint32> m_WriteIndex;
+	ALIGN(64) std::atomic<uint32> m_ReadIndex;
+	std::atomic<uint32> m_Underruns;
+};
\ No newline at end of file
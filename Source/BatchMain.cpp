@@ -0,0 +1,206 @@
+#include "BatchRunner.h"
+#include "CompositorCheck.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	void PrintUsage()
+	{
+		fprintf(stderr,
+			"usage: GameboyBatch (-roms LIST | -rom ROM -movies LIST) [-frames N] [-threads N]\n"
+			"                    [-jit [-verify]] [-out FILE]\n"
+			"       GameboyBatch -check-compositor\n"
+			"  -roms LIST     text file with one ROM path per line\n"
+			"  -rom ROM       run ROM once per movie listed in -movies\n"
+			"  -movies LIST   text file with one input movie path per line\n"
+			"  -frames N      frame limit per job, default 3600\n"
+			"  -threads N     worker threads, default one per core\n"
+			"  -jit           translate hot blocks to native code where supported\n"
+			"  -verify        with -jit, check every native run against an interpreted copy\n"
+			"  -out FILE      CSV results, default stdout\n"
+			"  -check-compositor  compare the vector scanline paths against the scalar one\n");
+	}
+
+	bool ReadList(const char* FileName, std::vector<std::string>& Lines)
+	{
+		std::ifstream File(FileName);
+		if (!File)
+		{
+			fprintf(stderr, "can't open %s\n", FileName);
+			return false;
+		}
+
+		std::string Line;
+		while (std::getline(File, Line))
+		{
+			//tolerate CRLF lists and blank lines
+			while (!Line.empty() && ((Line.back() == '\r') || (Line.back() == ' ')))
+			{
+				Line.pop_back();
+			}
+
+			if (!Line.empty() && (Line[0] != '#'))
+			{
+				Lines.push_back(Line);
+			}
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* romList = nullptr;
+	const char* rom = nullptr;
+	const char* movieList = nullptr;
+	const char* outName = nullptr;
+	uint32 frameLimit = 3600;
+	uint32 threads = 0;
+	bool recompile = false;
+	bool verify = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = (i + 1 < argc);
+		if (hasValue && (strcmp(argv[i], "-roms") == 0))
+		{
+			romList = argv[++i];
+		}
+		else if (hasValue && (strcmp(argv[i], "-rom") == 0))
+		{
+			rom = argv[++i];
+		}
+		else if (hasValue && (strcmp(argv[i], "-movies") == 0))
+		{
+			movieList = argv[++i];
+		}
+		else if (hasValue && (strcmp(argv[i], "-frames") == 0))
+		{
+			frameLimit = uint32(strtoul(argv[++i], nullptr, 10));
+		}
+		else if (hasValue && (strcmp(argv[i], "-threads") == 0))
+		{
+			threads = uint32(strtoul(argv[++i], nullptr, 10));
+		}
+		else if (strcmp(argv[i], "-jit") == 0)
+		{
+			recompile = true;
+		}
+		else if (strcmp(argv[i], "-verify") == 0)
+		{
+			verify = true;
+		}
+		else if (hasValue && (strcmp(argv[i], "-out") == 0))
+		{
+			outName = argv[++i];
+		}
+		else if (strcmp(argv[i], "-check-compositor") == 0)
+		{
+			return RunCompositorCheck() ? 0 : 4;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	std::vector<GBBatchJob> jobs;
+	if (romList != nullptr)
+	{
+		std::vector<std::string> roms;
+		if (!ReadList(romList, roms))
+		{
+			return 1;
+		}
+
+		for (const std::string& romPath : roms)
+		{
+			GBBatchJob job;
+			job.RomPath = romPath;
+			job.FrameLimit = frameLimit;
+			job.Recompile = recompile;
+			job.Verify = verify;
+			jobs.push_back(job);
+		}
+	}
+	else if ((rom != nullptr) && (movieList != nullptr))
+	{
+		std::vector<std::string> movies;
+		if (!ReadList(movieList, movies))
+		{
+			return 1;
+		}
+
+		for (const std::string& moviePath : movies)
+		{
+			GBBatchJob job;
+			job.RomPath = rom;
+			job.MoviePath = moviePath;
+			job.FrameLimit = frameLimit;
+			job.Recompile = recompile;
+			job.Verify = verify;
+			jobs.push_back(job);
+		}
+	}
+	else
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	FILE* out = stdout;
+	if (outName != nullptr)
+	{
+		out = fopen(outName, "w");
+		if (out == nullptr)
+		{
+			fprintf(stderr, "can't write %s\n", outName);
+			return 1;
+		}
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+	GBBatchRunner runner;
+	runner.SetThreads(threads);
+	std::vector<GBBatchResult> results;
+	runner.Run(jobs, results);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	uint32 failed = 0;
+	uint32 diverged = 0;
+	uint64 frames = 0;
+	fprintf(out, "rom,movie,status,frames,frame_hash,ram_hash,seconds\n");
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		const GBBatchResult& result = results[i];
+		fprintf(out, "%s,%s,%s,%u,%016llx,%016llx,%.3f\n", jobs[i].RomPath.c_str(), jobs[i].MoviePath.c_str(),
+			GBBatchRunner::GetStatusName(result.Status), result.Frames, result.FrameHash, result.RAMHash, result.Seconds);
+
+		failed += (result.Status == EBatchStatus::LoadFailed) ? 1 : 0;
+		if (result.Status == EBatchStatus::Diverged)
+		{
+			fprintf(stderr, "%s %s: native code diverged at cycle %llu, PC %04x\n", jobs[i].RomPath.c_str(),
+				jobs[i].MoviePath.c_str(), result.DivergedCycle, result.DivergedPC);
+			diverged++;
+		}
+		frames += result.Frames;
+	}
+
+	if (out != stdout)
+	{
+		fclose(out);
+	}
+
+	fprintf(stderr, "%zu jobs, %u failed to load, %u diverged, %llu frames in %.2fs\n", jobs.size(), failed, diverged,
+		frames, seconds);
+	if (failed > 0)
+	{
+		return 2;
+	}
+	return (diverged > 0) ? 3 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "BatchRunner.h"
+#include "CPU.h"
+#include "Cartridge.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <fstream>
+
+namespace
+{
+	uint64 HashBytes(const void* Data, size_t Size)
+	{
+		const uint8* Bytes = static_cast<const uint8*>(Data);
+		uint64 Hash = 0xCBF29CE484222325ull;
+		for (size_t i = 0; i < Size; ++i)
+		{
+			Hash ^= Bytes[i];
+			Hash *= 0x100000001B3ull;
+		}
+		return Hash;
+	}
+}
+
+bool GBMovieInput::LoadFile(const std::string& FileName)
+{
+	std::ifstream File(FileName, std::ios::binary | std::ios::ate);
+	if (!File)
+	{
+		return false;
+	}
+
+	std::streamsize Size = File.tellg();
+	File.seekg(0, std::ios::beg);
+	m_Frames.resize(size_t(Size));
+	return (Size == 0) || bool(File.read(reinterpret_cast<char*>(m_Frames.data()), Size));
+}
+
+void GBMovieInput::GetInputState(uint8& Joypad, uint8& Buttons)
+{
+	if (m_Frame < GetLength())
+	{
+		Joypad = m_Frames[m_Frame * 2];
+		Buttons = m_Frames[m_Frame * 2 + 1];
+	}
+	else
+	{
+		Joypad = JOYPAD_NONE;
+		Buttons = JOYPAD_NONE;
+	}
+}
+
+const char* GBBatchRunner::GetStatusName(EBatchStatus Status)
+{
+	switch (Status)
+	{
+	case EBatchStatus::FrameLimit:
+		return "frame_limit";
+	case EBatchStatus::Stopped:
+		return "stopped";
+	case EBatchStatus::Diverged:
+		return "diverged";
+	default:
+		return "load_failed";
+	}
+}
+
+void GBBatchRunner::Run(const std::vector<GBBatchJob>& Jobs, std::vector<GBBatchResult>& Results)
+{
+	Results.assign(Jobs.size(), GBBatchResult());
+
+	//every ROM is read once, a sweep of movies over one game doesn't load it per job
+	std::unordered_map<std::string, std::unique_ptr<Cartridge>> ROMs;
+	for (const GBBatchJob& Job : Jobs)
+	{
+		std::unique_ptr<Cartridge>& ROM = ROMs[Job.RomPath];
+		if (!ROM)
+		{
+			ROM = std::make_unique<Cartridge>();
+			ROM->LoadFile(Job.RomPath);
+		}
+	}
+
+	GBThreadPool Pool(m_Threads);
+	for (size_t i = 0; i < Jobs.size(); ++i)
+	{
+		const GBBatchJob& Job = Jobs[i];
+		const Cartridge* ROM = ROMs[Job.RomPath].get();
+		GBBatchResult& Result = Results[i];
+		Pool.Submit([&Job, ROM, &Result]() { RunJob(Job, ROM, Result); });
+	}
+	Pool.Wait();
+}
+
+void GBBatchRunner::RunJob(const GBBatchJob& Job, const Cartridge* ROM, GBBatchResult& Result)
+{
+	auto StartTime = std::chrono::steady_clock::now();
+
+	GBMovieInput Movie;
+	if (!ROM->IsLoaded() || (!Job.MoviePath.empty() && !Movie.LoadFile(Job.MoviePath)))
+	{
+		Result.Status = EBatchStatus::LoadFailed;
+		return;
+	}
+
+	Cartridge Cart;
+	GameBoyCPU CPU;
+	StartCPU(CPU, Cart, ROM, Movie);
+	CPU.SetRecompiler(Job.Recompile);
+
+	//the reference machine only exists for Verify jobs, both are traced a frame at a time
+	bool Verify = Job.Recompile && Job.Verify && CPU.IsRecompiling();
+	Cartridge ReferenceCart;
+	std::unique_ptr<GameBoyCPU> Reference;
+	std::vector<GBTraceEntry> ReferenceTrace;
+	std::vector<GBTraceEntry> Trace;
+	if (Verify)
+	{
+		Reference = std::make_unique<GameBoyCPU>();
+		StartCPU(*Reference, ReferenceCart, ROM, Movie);
+		Reference->SetTrace(&ReferenceTrace);
+		CPU.SetTrace(&Trace);
+	}
+
+	Result.Status = EBatchStatus::FrameLimit;
+	while (Result.Frames < Job.FrameLimit)
+	{
+		Movie.SetFrame(Result.Frames);
+		CPU.RunFrame();
+		if (Verify)
+		{
+			Reference->RunFrame();
+			bool Same = CompareTraces(ReferenceTrace, Trace, Result);
+			if (Same && (HashBytes(CPU.m_Memory.GetInternalRAM(), GameBoyMemory::InternalRAMSize) !=
+				HashBytes(Reference->m_Memory.GetInternalRAM(), GameBoyMemory::InternalRAMSize)))
+			{
+				//every step matched but a store went to the wrong place, blame the end of the frame
+				Result.DivergedCycle = Reference->GetCycleCount();
+				Result.DivergedPC = Reference->GetPC();
+				Same = false;
+			}
+			ReferenceTrace.clear();
+			Trace.clear();
+
+			if (!Same)
+			{
+				Result.Status = EBatchStatus::Diverged;
+				break;
+			}
+		}
+		Result.Frames++;
+
+		if (IsStopped(CPU))
+		{
+			Result.Status = EBatchStatus::Stopped;
+			break;
+		}
+	}
+
+	Result.FrameHash = HashBytes(CPU.GetFrameBuffer(), ScreenData::SizeX * ScreenData::SizeY * sizeof(GBColor));
+	Result.RAMHash = HashBytes(CPU.m_Memory.GetInternalRAM(), GameBoyMemory::InternalRAMSize);
+	Result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+}
+
+void GBBatchRunner::StartCPU(GameBoyCPU& CPU, Cartridge& Cart, const Cartridge* ROM, GBMovieInput& Movie)
+{
+	Cart.ShareROM(*ROM);
+
+	GBPlatform Platform;
+	Platform.Input = &Movie;
+	CPU.SetPlatform(Platform);
+	CPU.SetCartridge(&Cart);
+	CPU.SetAudioMuted(true);
+	CPU.TurnOn();
+	CPU.Boot(true);
+}
+
+bool GBBatchRunner::CompareTraces(const std::vector<GBTraceEntry>& Reference, const std::vector<GBTraceEntry>& Trace,
+	GBBatchResult& Result)
+{
+	//a native run is one entry standing for several interpreted steps, the ones in between are skipped
+	size_t ReferenceIndex = 0;
+	for (const GBTraceEntry& Entry : Trace)
+	{
+		//steps that take no cycles share theirs with the next one
+		while ((ReferenceIndex < Reference.size()) && ((Reference[ReferenceIndex].Cycles < Entry.Cycles) ||
+			((Reference[ReferenceIndex].Cycles == Entry.Cycles) && !(Reference[ReferenceIndex] == Entry))))
+		{
+			ReferenceIndex++;
+		}
+
+		if ((ReferenceIndex < Reference.size()) && (Reference[ReferenceIndex] == Entry))
+		{
+			continue;
+		}
+
+		//no matching step at that cycle, the interpreter got elsewhere with the step before
+		size_t Step = (ReferenceIndex > 0) ? ReferenceIndex - 1 : 0;
+		Result.DivergedCycle = Reference.empty() ? Entry.Cycles : Reference[Step].Cycles;
+		Result.DivergedPC = Reference.empty() ? Entry.PC : Reference[Step].PC;
+		return false;
+	}
+	return true;
+}
+
+bool GBBatchRunner::IsStopped(GameBoyCPU& CPU)
+{
+	//with interrupts off nothing can get the CPU out of jr -2 or a jp to itself
+	if (CPU.AreInterruptsEnabled())
+	{
+		return false;
+	}
+
+	//only memory that reads without side effects is looked at, an I/O read can sync the timer and
+	//the job has to run the same as one nobody watches
+	auto Peek = [&CPU](uint16 Address, uint8& Value)
+	{
+		const uint8* Page = CPU.m_Memory.GetReadPage(Address);
+		Value = (Page != nullptr) ? Page[Address & 0xFF] : 0;
+		return Page != nullptr;
+	};
+
+	uint16 PC = CPU.GetPC();
+	uint8 Opcode = 0;
+	uint8 Low = 0;
+	uint8 High = 0;
+	if (!Peek(PC, Opcode) || !Peek(uint16(PC + 1), Low))
+	{
+		return false;
+	}
+
+	if (Opcode == 0x18)
+	{
+		return Low == 0xFE;
+	}
+
+	if ((Opcode == 0xC3) && Peek(uint16(PC + 2), High))
+	{
+		return uint16(Low | (High << 8)) == PC;
+	}
+	return false;
+}
\ No newline at end of file
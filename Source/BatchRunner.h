@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Types.h"
+#include "Platform.h"
+
+class GameBoyCPU;
+class Cartridge;
+struct GBTraceEntry;
+
+struct GBBatchJob
+{
+	std::string RomPath;
+	//optional input movie, empty runs without input
+	std::string MoviePath;
+	uint32 FrameLimit = 3600;
+	//runs hot blocks as native code, see Recompiler.h
+	bool Recompile = false;
+	//with Recompile, runs an interpreting copy alongside and stops at the first step they disagree on
+	bool Verify = false;
+};
+
+enum class EBatchStatus : uint8
+{
+	FrameLimit,		// ran the whole frame limit
+	Stopped,		// spinning on a jump to itself with interrupts off, how test ROMs end
+	LoadFailed,		// ROM or movie couldn't be read
+	Diverged		// the recompiled run left the interpreted one, see DivergedCycle
+};
+
+struct GBBatchResult
+{
+	EBatchStatus Status = EBatchStatus::LoadFailed;
+	uint32 Frames = 0;
+	//FNV-1a of the last frame and of internal RAM, compared against a known good run
+	uint64 FrameHash = 0;
+	uint64 RAMHash = 0;
+	double Seconds = 0.0;
+	//first step the two runs of a Verify job disagree on, by the interpreter's trace
+	uint64 DivergedCycle = 0;
+	uint16 DivergedPC = 0;
+};
+
+//Input movie: two bytes per frame, the JOYPAD_INPUT_* then the JOYPAD_BUTTONS_* bits held
+//during that frame. Nothing is held past the end
+class GBMovieInput : public IInputSource
+{
+public:
+	bool LoadFile(const std::string& FileName);
+	void SetFrame(uint32 Frame) { m_Frame = Frame; }
+	uint32 GetLength() const { return uint32(m_Frames.size() / 2); }
+
+	virtual void GetInputState(uint8& Joypad, uint8& Buttons) override;
+	virtual bool PollEvents() override { return true; }
+
+private:
+	std::vector<uint8> m_Frames;
+	uint32 m_Frame = 0;
+};
+
+//Runs jobs headless on a work stealing pool, one job per task. Jobs on the same ROM share it
+class GBBatchRunner
+{
+public:
+	//0 uses every hardware thread
+	void SetThreads(uint32 Threads) { m_Threads = Threads; }
+
+	//Results come back in job order
+	void Run(const std::vector<GBBatchJob>& Jobs, std::vector<GBBatchResult>& Results);
+
+	static const char* GetStatusName(EBatchStatus Status);
+
+private:
+	static void RunJob(const GBBatchJob& Job, const Cartridge* ROM, GBBatchResult& Result);
+	static void StartCPU(GameBoyCPU& CPU, Cartridge& Cart, const Cartridge* ROM, GBMovieInput& Movie);
+	static bool IsStopped(GameBoyCPU& CPU);
+	//false at the first recompiled entry that doesn't match the interpreted step at its cycle
+	static bool CompareTraces(const std::vector<GBTraceEntry>& Reference, const std::vector<GBTraceEntry>& Trace,
+		GBBatchResult& Result);
+
+	uint32 m_Threads = 0;
+};
\ No newline at end of file
@@ -2,6 +2,10 @@
 
 #include "Types.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace BinaryOps
 {
 	template<typename TYPE>
@@ -22,4 +26,16 @@ namespace BinaryOps
 	{
 		return (oldValue & ~mask) | (newValue & mask);
 	}
+
+	//index of the lowest set bit, value must not be 0
+	static inline uint32 LowestSetBit(uint64 value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return index;
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "BlipBuffer.h"
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+BlipBuffer::BlipBuffer()
+{
+	BuildKernel();
+}
+
+void BlipBuffer::BuildKernel()
+{
+	static constexpr double Pi = 3.14159265358979323846;
+	//a bit below nyquist so the transition band stays inside the kernel
+	static constexpr double Cutoff = 0.45;
+	static constexpr int32 Unit = 1 << KernelBits;
+
+	for (int32 phase = 0; phase < PhaseCount; ++phase)
+	{
+		double taps[KernelWidth];
+		double sum = 0.0;
+		double center = double(KernelWidth / 2) + double(phase) / double(PhaseCount);
+
+		for (int32 i = 0; i < KernelWidth; ++i)
+		{
+			//windowed sinc impulse, integrated on read it becomes a band-limited step
+			double t = double(i) - center;
+			double sinc = (t == 0.0) ? 2.0 * Cutoff : std::sin(2.0 * Pi * Cutoff * t) / (Pi * t);
+			double window = 0.0;
+			if (std::abs(t) < KernelWidth / 2)
+			{
+				double x = 2.0 * Pi * t / double(KernelWidth);
+				window = 0.42 + 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+			}
+			taps[i] = sinc * window;
+			sum += taps[i];
+		}
+
+		//every phase must add up to exactly one unit or steps would drift
+		int32 total = 0;
+		for (int32 i = 0; i < KernelWidth; ++i)
+		{
+			m_Kernel[phase][i] = int16(std::lround(taps[i] * Unit / sum));
+			total += m_Kernel[phase][i];
+		}
+		m_Kernel[phase][KernelWidth / 2] += int16(Unit - total);
+	}
+}
+
+void BlipBuffer::SetRates(uint32 ClockRate, uint32 SampleRate, uint32 MaxSamples)
+{
+	m_Factor = ((uint64(SampleRate) << TimeBits) + ClockRate / 2) / ClockRate;
+	m_Buffer.assign(MaxSamples + KernelWidth, 0);
+	Clear();
+}
+
+void BlipBuffer::SetSampleRate(uint32 ClockRate, double SampleRate)
+{
+	m_Factor = uint64(SampleRate * double(1ull << TimeBits) / double(ClockRate) + 0.5);
+}
+
+void BlipBuffer::Clear()
+{
+	std::fill(m_Buffer.begin(), m_Buffer.end(), 0);
+	m_Offset = 0;
+	m_Integrator = 0;
+}
+
+void BlipBuffer::AddDelta(uint32 ClockTime, int32 Delta)
+{
+	uint64 position = uint64(ClockTime) * m_Factor + m_Offset;
+	uint32 index = uint32(position >> TimeBits);
+	int32 phase = int32(position >> (TimeBits - PhaseBits)) & (PhaseCount - 1);
+
+	assert(index + KernelWidth <= m_Buffer.size());
+	if (index + KernelWidth > m_Buffer.size())
+	{
+		return;
+	}
+
+	int64* out = &m_Buffer[index];
+	const int16* kernel = m_Kernel[phase];
+	for (int32 i = 0; i < KernelWidth; ++i)
+	{
+		out[i] += int64(kernel[i]) * Delta;
+	}
+}
+
+void BlipBuffer::EndFrame(uint32 ClockDuration)
+{
+	m_Offset += uint64(ClockDuration) * m_Factor;
+	assert(GetSamplesAvailable() + KernelWidth <= m_Buffer.size());
+}
+
+uint32 BlipBuffer::ReadSamples(int32* Out, uint32 MaxSamples)
+{
+	uint32 available = GetSamplesAvailable();
+	uint32 count = std::min(available, MaxSamples);
+
+	for (uint32 i = 0; i < count; ++i)
+	{
+		m_Integrator += m_Buffer[i];
+		int64 sample = m_Integrator >> KernelBits;
+		Out[i] = int32(sample);
+		m_Integrator -= sample << (KernelBits - BassShift);
+	}
+
+	//keep the unread samples and the tails of the kernels that reach past them
+	uint32 remaining = (available - count) + KernelWidth;
+	std::copy(m_Buffer.begin() + count, m_Buffer.begin() + count + remaining, m_Buffer.begin());
+	std::fill(m_Buffer.begin() + remaining, m_Buffer.end(), 0);
+	m_Offset -= uint64(count) << TimeBits;
+
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+
+//Band-limited step synthesis. Sources add amplitude deltas at clock timestamps inside the
+//current frame, EndFrame turns the elapsed clocks into output samples which are then read
+//in bulk. Output quality no longer depends on how often the source is updated.
+class BlipBuffer
+{
+public:
+	static constexpr int32 PhaseBits = 6;
+	static constexpr int32 PhaseCount = 1 << PhaseBits;
+	static constexpr int32 KernelWidth = 16;
+	static constexpr int32 KernelBits = 15;
+	//high pass applied by the integrator, removes the DC offset of the unipolar channels
+	static constexpr int32 BassShift = 9;
+
+	BlipBuffer();
+
+	//MaxSamples is the most samples a single frame may produce before it's read
+	void SetRates(uint32 ClockRate, uint32 SampleRate, uint32 MaxSamples);
+	//only changes the ratio, safe to call between frames for rate control
+	void SetSampleRate(uint32 ClockRate, double SampleRate);
+	void Clear();
+
+	void AddDelta(uint32 ClockTime, int32 Delta);
+	void EndFrame(uint32 ClockDuration);
+
+	uint32 GetSamplesAvailable() const { return uint32(m_Offset >> TimeBits); }
+	uint32 ReadSamples(int32* Out, uint32 MaxSamples);
+
+private:
+	static constexpr int32 TimeBits = 32;
+
+	void BuildKernel();
+
+	//clocks to output samples, TimeBits fixed point
+	uint64 m_Factor = 0;
+	uint64 m_Offset = 0;
+	int64 m_Integrator = 0;
+
+	std::vector<int64> m_Buffer;
+	int16 m_Kernel[PhaseCount][KernelWidth];
+};
\ No newline at end of file
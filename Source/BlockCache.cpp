@@ -0,0 +1,193 @@
+#include "BlockCache.h"
+#include "MemoryModel.h"
+#include <algorithm>
+
+namespace
+{
+	struct OpcodeInfo
+	{
+		uint8 Length[256];
+		bool EndsBlock[256];
+	};
+
+	constexpr OpcodeInfo MakeOpcodeInfo()
+	{
+		OpcodeInfo Info = {};
+		for (uint32 i = 0; i < 256; ++i)
+		{
+			Info.Length[i] = 1;
+		}
+
+		//bytes the handlers fetch after the opcode
+		constexpr uint8 TwoBytes[] = { 0x06, 0x0E, 0x16, 0x1E, 0x26, 0x2E, 0x36, 0x3E, 0x18, 0x20, 0x28, 0x30, 0x38,
+			0xC6, 0xCB, 0xCE, 0xD6, 0xDE, 0xE0, 0xE6, 0xE8, 0xEE, 0xF0, 0xF6, 0xF8, 0xFE };
+		constexpr uint8 ThreeBytes[] = { 0x01, 0x08, 0x11, 0x21, 0x31, 0xC2, 0xC3, 0xC4, 0xCA, 0xCC, 0xCD, 0xD2, 0xD4,
+			0xDA, 0xDC, 0xEA, 0xFA };
+		for (uint8 Opcode : TwoBytes)
+		{
+			Info.Length[Opcode] = 2;
+		}
+		for (uint8 Opcode : ThreeBytes)
+		{
+			Info.Length[Opcode] = 3;
+		}
+
+		//jumps, calls, returns, RST, HALT/STOP and the opcodes that don't exist
+		constexpr uint8 Enders[] = { 0x10, 0x18, 0x20, 0x28, 0x30, 0x38, 0x76, 0xC0, 0xC2, 0xC3, 0xC4, 0xC7, 0xC8, 0xC9,
+			0xCA, 0xCC, 0xCD, 0xCF, 0xD0, 0xD2, 0xD3, 0xD4, 0xD7, 0xD8, 0xD9, 0xDA, 0xDB, 0xDC, 0xDD, 0xDF, 0xE3, 0xE4,
+			0xE7, 0xE9, 0xEB, 0xEC, 0xED, 0xEF, 0xF4, 0xF7, 0xFC, 0xFD, 0xFF };
+		for (uint8 Opcode : Enders)
+		{
+			Info.EndsBlock[Opcode] = true;
+		}
+		return Info;
+	}
+
+	constexpr OpcodeInfo s_OpcodeInfo = MakeOpcodeInfo();
+
+	constexpr uint16 RAMStart = 0xC000;
+	constexpr uint16 RAMEnd = 0xFE00; //echo included
+}
+
+const GBDecodedOp GBBlockCache::s_EndOfBlock = { 0x10000, 0, 0, 0 };
+
+uint8 GBBlockCache::GetLength(uint8 Opcode)
+{
+	return s_OpcodeInfo.Length[Opcode];
+}
+
+GBDecodedBlock* GBBlockCache::FindBlock(uint16 PC, bool BootSequence)
+{
+	bool IsROM = PC < 0x8000;
+	bool IsRAM = (PC >= RAMStart) && (PC < RAMEnd);
+	if (!IsROM && !IsRAM)
+	{
+		return nullptr;
+	}
+
+	uint32 RAMPage = ((PC - RAMStart) & (GameBoyMemory::InternalRAMSize - 1)) / GameBoyMemory::PageSize;
+	if ((IsROM && BootSequence && (PC < 0x100)) || (IsRAM && (m_UncachedRAMPages & (1u << RAMPage))))
+	{
+		return nullptr;
+	}
+
+	const uint8* Page = m_Memory.GetReadPage(PC);
+	if (Page == nullptr)
+	{
+		return nullptr;
+	}
+
+	const uint8* Host = Page + (PC & 0xFF);
+	Block*& Recent = m_Recent[GetRecentSlot(PC)];
+	if ((Recent == nullptr) || (Recent->Host != Host) || (Recent->StartPC != PC))
+	{
+		//whatever ran before this lookup has finished with its op
+		m_Retired.clear();
+
+		std::unique_ptr<Block>& Entry = m_Blocks[Host];
+		if (Entry && (Entry->StartPC != PC))
+		{
+			//same memory seen at another address, RAM and its echo
+			Retire(Entry);
+		}
+
+		if (!Entry)
+		{
+			Entry = std::make_unique<Block>();
+			Decode(*Entry, Host, PC);
+			if (IsRAM)
+			{
+				m_RAMBlocks[RAMPage].push_back(Host);
+				m_Memory.ProtectRAMPage(RAMPage);
+			}
+		}
+		Recent = Entry.get();
+	}
+
+	//the first instruction already runs over the page end
+	return (Recent->Ops[0].PC == PC) ? Recent : nullptr;
+}
+
+void GBBlockCache::Decode(Block& Target, const uint8* Host, uint16 PC)
+{
+	Target.Host = Host;
+	Target.StartPC = PC;
+
+	uint32 Offset = 0;
+	uint32 Count = 0;
+	uint32 PageLeft = GameBoyMemory::PageSize - (PC & 0xFF);
+	//the page ends the block, nothing past it is read
+	while ((Count < Block::MaxOps) && (Offset < PageLeft))
+	{
+		uint8 Opcode = Host[Offset];
+		uint8 Length = s_OpcodeInfo.Length[Opcode];
+		if (Offset + Length > PageLeft)
+		{
+			break;
+		}
+
+		GBDecodedOp& Op = Target.Ops[Count++];
+		Op.PC = uint16(PC + Offset);
+		Op.Opcode = Opcode;
+		Op.Length = Length;
+		Op.Operand = (Length > 1) ? Host[Offset + 1] : 0;
+		if (Length > 2)
+		{
+			Op.Operand |= Host[Offset + 2] << 8;
+		}
+
+		Offset += Length;
+		if (s_OpcodeInfo.EndsBlock[Opcode])
+		{
+			break;
+		}
+	}
+	Target.Ops[Count] = s_EndOfBlock;
+}
+
+void GBBlockCache::Retire(std::unique_ptr<Block>& Old)
+{
+	Block*& Recent = m_Recent[GetRecentSlot(Old->StartPC)];
+	if (Recent == Old.get())
+	{
+		Recent = nullptr;
+	}
+	m_Retired.push_back(std::move(Old));
+}
+
+void GBBlockCache::InvalidateRAM(uint16 Address)
+{
+	uint32 RAMPage = ((Address - RAMStart) & (GameBoyMemory::InternalRAMSize - 1)) / GameBoyMemory::PageSize;
+	for (const uint8* Host : m_RAMBlocks[RAMPage])
+	{
+		auto It = m_Blocks.find(Host);
+		if (It != m_Blocks.end())
+		{
+			if (It->second)
+			{
+				Retire(It->second);
+			}
+			m_Blocks.erase(It);
+		}
+	}
+	m_RAMBlocks[RAMPage].clear();
+
+	if (++m_RAMRewrites[RAMPage] >= MaxRAMRewrites)
+	{
+		m_UncachedRAMPages |= 1u << RAMPage;
+	}
+}
+
+void GBBlockCache::Flush()
+{
+	m_Memory.UnprotectAllRAM();
+	m_Blocks.clear();
+	m_Retired.clear();
+	std::fill(m_Recent, m_Recent + RecentSize, nullptr);
+	for (uint32 RAMPage = 0; RAMPage < RAMPages; ++RAMPage)
+	{
+		m_RAMBlocks[RAMPage].clear();
+		m_RAMRewrites[RAMPage] = 0;
+	}
+	m_UncachedRAMPages = 0;
+}
\ No newline at end of file
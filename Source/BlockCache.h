@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Types.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class GameBoyMemory;
+struct GBJitContext;
+
+//One instruction with its operand bytes already read
+struct GBDecodedOp
+{
+	//uint32 so the end marker can hold a PC no instruction has
+	uint32 PC;
+	uint16 Operand;
+	uint8 Opcode;
+	uint8 Length;
+};
+
+//Instructions from StartPC up to the first jump, call, return or HALT, never across a 256 byte page
+struct GBDecodedBlock
+{
+	static constexpr uint32 MaxOps = 16;
+
+	const uint8* Host;
+	uint16 StartPC;
+	GBDecodedOp Ops[MaxOps + 1];
+
+	//filled by the recompiler, the native code returns the index of the op to continue at
+	using NativeCode = uint32 (*)(GBJitContext* Context);
+	NativeCode Native = nullptr;
+	//the most cycles one run of the native code takes, and the ops it covers
+	uint32 NativeCycles = 0;
+	uint8 NativeOps = 0;
+	uint16 Hits = 0;
+	uint8 SideExits = 0;
+	bool NoNative = false;
+};
+
+//Straight runs of instructions decoded once and replayed by the CPU. Blocks are keyed by the host memory
+//they were decoded from, so every ROM bank gets its own blocks and a bank switch only changes which
+//ones PC finds. Internal RAM pages holding blocks are write protected, a write throws their blocks away
+class GBBlockCache
+{
+public:
+	//past this many rewrites a RAM page is treated as data that happens to run and is left undecoded
+	static constexpr uint32 MaxRAMRewrites = 8;
+
+	//follows the last op of every block, its PC never matches
+	static const GBDecodedOp s_EndOfBlock;
+
+	explicit GBBlockCache(GameBoyMemory& Memory) : m_Memory(Memory) {}
+
+	//ops of the block starting at PC, ending with s_EndOfBlock. nullptr if the code there isn't cached:
+	//the boot ROM, I/O, VRAM, cartridge RAM and high RAM are decoded by the caller every time
+	const GBDecodedOp* Find(uint16 PC, bool BootSequence)
+	{
+		GBDecodedBlock* Found = FindBlock(PC, BootSequence);
+		return (Found != nullptr) ? Found->Ops : nullptr;
+	}
+	GBDecodedBlock* FindBlock(uint16 PC, bool BootSequence);
+
+	//a protected RAM page was written
+	void InvalidateRAM(uint16 Address);
+	void Flush();
+
+	static uint8 GetLength(uint8 Opcode);
+
+private:
+	using Block = GBDecodedBlock;
+
+	static constexpr uint32 RecentSize = 4096;
+	static constexpr uint32 RAMPages = 0x20;
+
+	static uint32 GetRecentSlot(uint16 PC) { return (PC ^ (PC >> 12)) & (RecentSize - 1); }
+	void Decode(Block& Target, const uint8* Host, uint16 PC);
+	void Retire(std::unique_ptr<Block>& Old);
+
+	GameBoyMemory& m_Memory;
+	std::unordered_map<const uint8*, std::unique_ptr<Block>> m_Blocks;
+	//direct mapped front of m_Blocks, most lookups after a jump end here
+	Block* m_Recent[RecentSize] = {};
+
+	//blocks thrown away while an op of theirs might still be executing, freed on the next lookup
+	std::vector<std::unique_ptr<Block>> m_Retired;
+
+	std::vector<const uint8*> m_RAMBlocks[RAMPages];
+	uint8 m_RAMRewrites[RAMPages] = {};
+	uint32 m_UncachedRAMPages = 0;
+};
\ No newline at end of file
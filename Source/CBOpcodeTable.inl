@@ -0,0 +1,289 @@
+//Every CB prefixed opcode in order as GB_CB_OPCODE(Opcode, Body), expanded the same way as OpcodeTable.inl
+
+//00
+GB_CB_OPCODE(0x00, { RLC_8BIT(B); }) // RLC B
+GB_CB_OPCODE(0x01, { RLC_8BIT(C); }) // RLC C
+GB_CB_OPCODE(0x02, { RLC_8BIT(D); }) // RLC D
+GB_CB_OPCODE(0x03, { RLC_8BIT(E); }) // RLC E
+GB_CB_OPCODE(0x04, { RLC_8BIT(H); }) // RLC H
+GB_CB_OPCODE(0x05, { RLC_8BIT(L); }) // RLC L
+GB_CB_OPCODE(0x06, { ModifyHL([this](uint8& Val) { RLC_8BIT(Val, 4); }); }) // RLC (HL)
+GB_CB_OPCODE(0x07, { RLC_8BIT(A); }) // RLC A
+GB_CB_OPCODE(0x08, { RRC_8BIT(B); }) // RRC B
+GB_CB_OPCODE(0x09, { RRC_8BIT(C); }) // RRC C
+GB_CB_OPCODE(0x0A, { RRC_8BIT(D); }) // RRC D
+GB_CB_OPCODE(0x0B, { RRC_8BIT(E); }) // RRC E
+GB_CB_OPCODE(0x0C, { RRC_8BIT(H); }) // RRC H
+GB_CB_OPCODE(0x0D, { RRC_8BIT(L); }) // RRC L
+GB_CB_OPCODE(0x0E, { ModifyHL([this](uint8& Val) { RRC_8BIT(Val, 4); }); }) // RRC (HL)
+GB_CB_OPCODE(0x0F, { RRC_8BIT(A); }) // RRC A
+
+//10
+GB_CB_OPCODE(0x10, { RL_8BIT(B); }) // RL B
+GB_CB_OPCODE(0x11, { RL_8BIT(C); }) // RL C
+GB_CB_OPCODE(0x12, { RL_8BIT(D); }) // RL D
+GB_CB_OPCODE(0x13, { RL_8BIT(E); }) // RL E
+GB_CB_OPCODE(0x14, { RL_8BIT(H); }) // RL H
+GB_CB_OPCODE(0x15, { RL_8BIT(L); }) // RL L
+GB_CB_OPCODE(0x16, { ModifyHL([this](uint8& Val) { RL_8BIT(Val, 4); }); }) // RL (HL)
+GB_CB_OPCODE(0x17, { RL_8BIT(A); }) // RL A
+GB_CB_OPCODE(0x18, { RR_8BIT(B); }) // RR B
+GB_CB_OPCODE(0x19, { RR_8BIT(C); }) // RR C
+GB_CB_OPCODE(0x1A, { RR_8BIT(D); }) // RR D
+GB_CB_OPCODE(0x1B, { RR_8BIT(E); }) // RR E
+GB_CB_OPCODE(0x1C, { RR_8BIT(H); }) // RR H
+GB_CB_OPCODE(0x1D, { RR_8BIT(L); }) // RR L
+GB_CB_OPCODE(0x1E, { ModifyHL([this](uint8& Val) { RR_8BIT(Val, 4); }); }) // RR (HL)
+GB_CB_OPCODE(0x1F, { RR_8BIT(A); }) // RR A
+
+//20
+GB_CB_OPCODE(0x20, { SLA_8BIT(B); }) // SLA B
+GB_CB_OPCODE(0x21, { SLA_8BIT(C); }) // SLA C
+GB_CB_OPCODE(0x22, { SLA_8BIT(D); }) // SLA D
+GB_CB_OPCODE(0x23, { SLA_8BIT(E); }) // SLA E
+GB_CB_OPCODE(0x24, { SLA_8BIT(H); }) // SLA H
+GB_CB_OPCODE(0x25, { SLA_8BIT(L); }) // SLA L
+GB_CB_OPCODE(0x26, { ModifyHL([this](uint8& Val) { SLA_8BIT(Val, 4); }); }) // SLA (HL)
+GB_CB_OPCODE(0x27, { SLA_8BIT(A); }) // SLA A
+GB_CB_OPCODE(0x28, { SRA_8BIT(B); }) // SRA B
+GB_CB_OPCODE(0x29, { SRA_8BIT(C); }) // SRA C
+GB_CB_OPCODE(0x2A, { SRA_8BIT(D); }) // SRA D
+GB_CB_OPCODE(0x2B, { SRA_8BIT(E); }) // SRA E
+GB_CB_OPCODE(0x2C, { SRA_8BIT(H); }) // SRA H
+GB_CB_OPCODE(0x2D, { SRA_8BIT(L); }) // SRA L
+GB_CB_OPCODE(0x2E, { ModifyHL([this](uint8& Val) { SRA_8BIT(Val, 4); }); }) // SRA (HL)
+GB_CB_OPCODE(0x2F, { SRA_8BIT(A); }) // SRA A
+
+//30
+GB_CB_OPCODE(0x30, { SWAP_8BIT(B); }) // SWAP B
+GB_CB_OPCODE(0x31, { SWAP_8BIT(C); }) // SWAP C
+GB_CB_OPCODE(0x32, { SWAP_8BIT(D); }) // SWAP D
+GB_CB_OPCODE(0x33, { SWAP_8BIT(E); }) // SWAP E
+GB_CB_OPCODE(0x34, { SWAP_8BIT(H); }) // SWAP H
+GB_CB_OPCODE(0x35, { SWAP_8BIT(L); }) // SWAP L
+GB_CB_OPCODE(0x36, { ModifyHL([this](uint8& Val) { SWAP_8BIT(Val, 4); }); }) // SWAP (HL)
+GB_CB_OPCODE(0x37, { SWAP_8BIT(A); }) // SWAP A
+GB_CB_OPCODE(0x38, { SRL_8BIT(B); }) // SRL B
+GB_CB_OPCODE(0x39, { SRL_8BIT(C); }) // SRL C
+GB_CB_OPCODE(0x3A, { SRL_8BIT(D); }) // SRL D
+GB_CB_OPCODE(0x3B, { SRL_8BIT(E); }) // SRL E
+GB_CB_OPCODE(0x3C, { SRL_8BIT(H); }) // SRL H
+GB_CB_OPCODE(0x3D, { SRL_8BIT(L); }) // SRL L
+GB_CB_OPCODE(0x3E, { ModifyHL([this](uint8& Val) { SRL_8BIT(Val, 4); }); }) // SRL (HL)
+GB_CB_OPCODE(0x3F, { SRL_8BIT(A); }) // SRL A
+
+//40
+GB_CB_OPCODE(0x40, { BIT_8BIT(0, B); }) // BIT 0, B
+GB_CB_OPCODE(0x41, { BIT_8BIT(0, C); }) // BIT 0, C
+GB_CB_OPCODE(0x42, { BIT_8BIT(0, D); }) // BIT 0, D
+GB_CB_OPCODE(0x43, { BIT_8BIT(0, E); }) // BIT 0, E
+GB_CB_OPCODE(0x44, { BIT_8BIT(0, H); }) // BIT 0, H
+GB_CB_OPCODE(0x45, { BIT_8BIT(0, L); }) // BIT 0, L
+GB_CB_OPCODE(0x46, { BIT_8BIT(0, ReadMemory(HL)); }) // BIT 0, (HL)
+GB_CB_OPCODE(0x47, { BIT_8BIT(0, A); }) // BIT 0, A
+GB_CB_OPCODE(0x48, { BIT_8BIT(1, B); }) // BIT 1, B
+GB_CB_OPCODE(0x49, { BIT_8BIT(1, C); }) // BIT 1, C
+GB_CB_OPCODE(0x4A, { BIT_8BIT(1, D); }) // BIT 1, D
+GB_CB_OPCODE(0x4B, { BIT_8BIT(1, E); }) // BIT 1, E
+GB_CB_OPCODE(0x4C, { BIT_8BIT(1, H); }) // BIT 1, H
+GB_CB_OPCODE(0x4D, { BIT_8BIT(1, L); }) // BIT 1, L
+GB_CB_OPCODE(0x4E, { BIT_8BIT(1, ReadMemory(HL)); }) // BIT 1, (HL)
+GB_CB_OPCODE(0x4F, { BIT_8BIT(1, A); }) // BIT 1, A
+
+//50
+GB_CB_OPCODE(0x50, { BIT_8BIT(2, B); }) // BIT 2, B
+GB_CB_OPCODE(0x51, { BIT_8BIT(2, C); }) // BIT 2, C
+GB_CB_OPCODE(0x52, { BIT_8BIT(2, D); }) // BIT 2, D
+GB_CB_OPCODE(0x53, { BIT_8BIT(2, E); }) // BIT 2, E
+GB_CB_OPCODE(0x54, { BIT_8BIT(2, H); }) // BIT 2, H
+GB_CB_OPCODE(0x55, { BIT_8BIT(2, L); }) // BIT 2, L
+GB_CB_OPCODE(0x56, { BIT_8BIT(2, ReadMemory(HL)); }) // BIT 2, (HL)
+GB_CB_OPCODE(0x57, { BIT_8BIT(2, A); }) // BIT 2, A
+GB_CB_OPCODE(0x58, { BIT_8BIT(3, B); }) // BIT 3, B
+GB_CB_OPCODE(0x59, { BIT_8BIT(3, C); }) // BIT 3, C
+GB_CB_OPCODE(0x5A, { BIT_8BIT(3, D); }) // BIT 3, D
+GB_CB_OPCODE(0x5B, { BIT_8BIT(3, E); }) // BIT 3, E
+GB_CB_OPCODE(0x5C, { BIT_8BIT(3, H); }) // BIT 3, H
+GB_CB_OPCODE(0x5D, { BIT_8BIT(3, L); }) // BIT 3, L
+GB_CB_OPCODE(0x5E, { BIT_8BIT(3, ReadMemory(HL)); }) // BIT 3, (HL)
+GB_CB_OPCODE(0x5F, { BIT_8BIT(3, A); }) // BIT 3, A
+
+//60
+GB_CB_OPCODE(0x60, { BIT_8BIT(4, B); }) // BIT 4, B
+GB_CB_OPCODE(0x61, { BIT_8BIT(4, C); }) // BIT 4, C
+GB_CB_OPCODE(0x62, { BIT_8BIT(4, D); }) // BIT 4, D
+GB_CB_OPCODE(0x63, { BIT_8BIT(4, E); }) // BIT 4, E
+GB_CB_OPCODE(0x64, { BIT_8BIT(4, H); }) // BIT 4, H
+GB_CB_OPCODE(0x65, { BIT_8BIT(4, L); }) // BIT 4, L
+GB_CB_OPCODE(0x66, { BIT_8BIT(4, ReadMemory(HL)); }) // BIT 4, (HL)
+GB_CB_OPCODE(0x67, { BIT_8BIT(4, A); }) // BIT 4, A
+GB_CB_OPCODE(0x68, { BIT_8BIT(5, B); }) // BIT 5, B
+GB_CB_OPCODE(0x69, { BIT_8BIT(5, C); }) // BIT 5, C
+GB_CB_OPCODE(0x6A, { BIT_8BIT(5, D); }) // BIT 5, D
+GB_CB_OPCODE(0x6B, { BIT_8BIT(5, E); }) // BIT 5, E
+GB_CB_OPCODE(0x6C, { BIT_8BIT(5, H); }) // BIT 5, H
+GB_CB_OPCODE(0x6D, { BIT_8BIT(5, L); }) // BIT 5, L
+GB_CB_OPCODE(0x6E, { BIT_8BIT(5, ReadMemory(HL)); }) // BIT 5, (HL)
+GB_CB_OPCODE(0x6F, { BIT_8BIT(5, A); }) // BIT 5, A
+
+//70
+GB_CB_OPCODE(0x70, { BIT_8BIT(6, B); }) // BIT 6, B
+GB_CB_OPCODE(0x71, { BIT_8BIT(6, C); }) // BIT 6, C
+GB_CB_OPCODE(0x72, { BIT_8BIT(6, D); }) // BIT 6, D
+GB_CB_OPCODE(0x73, { BIT_8BIT(6, E); }) // BIT 6, E
+GB_CB_OPCODE(0x74, { BIT_8BIT(6, H); }) // BIT 6, H
+GB_CB_OPCODE(0x75, { BIT_8BIT(6, L); }) // BIT 6, L
+GB_CB_OPCODE(0x76, { BIT_8BIT(6, ReadMemory(HL)); }) // BIT 6, (HL)
+GB_CB_OPCODE(0x77, { BIT_8BIT(6, A); }) // BIT 6, A
+GB_CB_OPCODE(0x78, { BIT_8BIT(7, B); }) // BIT 7, B
+GB_CB_OPCODE(0x79, { BIT_8BIT(7, C); }) // BIT 7, C
+GB_CB_OPCODE(0x7A, { BIT_8BIT(7, D); }) // BIT 7, D
+GB_CB_OPCODE(0x7B, { BIT_8BIT(7, E); }) // BIT 7, E
+GB_CB_OPCODE(0x7C, { BIT_8BIT(7, H); }) // BIT 7, H
+GB_CB_OPCODE(0x7D, { BIT_8BIT(7, L); }) // BIT 7, L
+GB_CB_OPCODE(0x7E, { BIT_8BIT(7, ReadMemory(HL)); }) // BIT 7, (HL)
+GB_CB_OPCODE(0x7F, { BIT_8BIT(7, A); }) // BIT 7, A
+
+//80
+GB_CB_OPCODE(0x80, { RES_8BIT(0, B); }) // RES 0, B
+GB_CB_OPCODE(0x81, { RES_8BIT(0, C); }) // RES 0, C
+GB_CB_OPCODE(0x82, { RES_8BIT(0, D); }) // RES 0, D
+GB_CB_OPCODE(0x83, { RES_8BIT(0, E); }) // RES 0, E
+GB_CB_OPCODE(0x84, { RES_8BIT(0, H); }) // RES 0, H
+GB_CB_OPCODE(0x85, { RES_8BIT(0, L); }) // RES 0, L
+GB_CB_OPCODE(0x86, { ModifyHL([this](uint8& Val) { RES_8BIT(0, Val, 4); }); }) // RES 0, (HL)
+GB_CB_OPCODE(0x87, { RES_8BIT(0, A); }) // RES 0, A
+GB_CB_OPCODE(0x88, { RES_8BIT(1, B); }) // RES 1, B
+GB_CB_OPCODE(0x89, { RES_8BIT(1, C); }) // RES 1, C
+GB_CB_OPCODE(0x8A, { RES_8BIT(1, D); }) // RES 1, D
+GB_CB_OPCODE(0x8B, { RES_8BIT(1, E); }) // RES 1, E
+GB_CB_OPCODE(0x8C, { RES_8BIT(1, H); }) // RES 1, H
+GB_CB_OPCODE(0x8D, { RES_8BIT(1, L); }) // RES 1, L
+GB_CB_OPCODE(0x8E, { ModifyHL([this](uint8& Val) { RES_8BIT(1, Val, 4); }); }) // RES 1, (HL)
+GB_CB_OPCODE(0x8F, { RES_8BIT(1, A); }) // RES 1, A
+
+//90
+GB_CB_OPCODE(0x90, { RES_8BIT(2, B); }) // RES 2, B
+GB_CB_OPCODE(0x91, { RES_8BIT(2, C); }) // RES 2, C
+GB_CB_OPCODE(0x92, { RES_8BIT(2, D); }) // RES 2, D
+GB_CB_OPCODE(0x93, { RES_8BIT(2, E); }) // RES 2, E
+GB_CB_OPCODE(0x94, { RES_8BIT(2, H); }) // RES 2, H
+GB_CB_OPCODE(0x95, { RES_8BIT(2, L); }) // RES 2, L
+GB_CB_OPCODE(0x96, { ModifyHL([this](uint8& Val) { RES_8BIT(2, Val, 4); }); }) // RES 2, (HL)
+GB_CB_OPCODE(0x97, { RES_8BIT(2, A); }) // RES 2, A
+GB_CB_OPCODE(0x98, { RES_8BIT(3, B); }) // RES 3, B
+GB_CB_OPCODE(0x99, { RES_8BIT(3, C); }) // RES 3, C
+GB_CB_OPCODE(0x9A, { RES_8BIT(3, D); }) // RES 3, D
+GB_CB_OPCODE(0x9B, { RES_8BIT(3, E); }) // RES 3, E
+GB_CB_OPCODE(0x9C, { RES_8BIT(3, H); }) // RES 3, H
+GB_CB_OPCODE(0x9D, { RES_8BIT(3, L); }) // RES 3, L
+GB_CB_OPCODE(0x9E, { ModifyHL([this](uint8& Val) { RES_8BIT(3, Val, 4); }); }) // RES 3, (HL)
+GB_CB_OPCODE(0x9F, { RES_8BIT(3, A); }) // RES 3, A
+
+//A0
+GB_CB_OPCODE(0xA0, { RES_8BIT(4, B); }) // RES 4, B
+GB_CB_OPCODE(0xA1, { RES_8BIT(4, C); }) // RES 4, C
+GB_CB_OPCODE(0xA2, { RES_8BIT(4, D); }) // RES 4, D
+GB_CB_OPCODE(0xA3, { RES_8BIT(4, E); }) // RES 4, E
+GB_CB_OPCODE(0xA4, { RES_8BIT(4, H); }) // RES 4, H
+GB_CB_OPCODE(0xA5, { RES_8BIT(4, L); }) // RES 4, L
+GB_CB_OPCODE(0xA6, { ModifyHL([this](uint8& Val) { RES_8BIT(4, Val, 4); }); }) // RES 4, (HL)
+GB_CB_OPCODE(0xA7, { RES_8BIT(4, A); }) // RES 4, A
+GB_CB_OPCODE(0xA8, { RES_8BIT(5, B); }) // RES 5, B
+GB_CB_OPCODE(0xA9, { RES_8BIT(5, C); }) // RES 5, C
+GB_CB_OPCODE(0xAA, { RES_8BIT(5, D); }) // RES 5, D
+GB_CB_OPCODE(0xAB, { RES_8BIT(5, E); }) // RES 5, E
+GB_CB_OPCODE(0xAC, { RES_8BIT(5, H); }) // RES 5, H
+GB_CB_OPCODE(0xAD, { RES_8BIT(5, L); }) // RES 5, L
+GB_CB_OPCODE(0xAE, { ModifyHL([this](uint8& Val) { RES_8BIT(5, Val, 4); }); }) // RES 5, (HL)
+GB_CB_OPCODE(0xAF, { RES_8BIT(5, A); }) // RES 5, A
+
+//B0
+GB_CB_OPCODE(0xB0, { RES_8BIT(6, B); }) // RES 6, B
+GB_CB_OPCODE(0xB1, { RES_8BIT(6, C); }) // RES 6, C
+GB_CB_OPCODE(0xB2, { RES_8BIT(6, D); }) // RES 6, D
+GB_CB_OPCODE(0xB3, { RES_8BIT(6, E); }) // RES 6, E
+GB_CB_OPCODE(0xB4, { RES_8BIT(6, H); }) // RES 6, H
+GB_CB_OPCODE(0xB5, { RES_8BIT(6, L); }) // RES 6, L
+GB_CB_OPCODE(0xB6, { ModifyHL([this](uint8& Val) { RES_8BIT(6, Val, 4); }); }) // RES 6, (HL)
+GB_CB_OPCODE(0xB7, { RES_8BIT(6, A); }) // RES 6, A
+GB_CB_OPCODE(0xB8, { RES_8BIT(7, B); }) // RES 7, B
+GB_CB_OPCODE(0xB9, { RES_8BIT(7, C); }) // RES 7, C
+GB_CB_OPCODE(0xBA, { RES_8BIT(7, D); }) // RES 7, D
+GB_CB_OPCODE(0xBB, { RES_8BIT(7, E); }) // RES 7, E
+GB_CB_OPCODE(0xBC, { RES_8BIT(7, H); }) // RES 7, H
+GB_CB_OPCODE(0xBD, { RES_8BIT(7, L); }) // RES 7, L
+GB_CB_OPCODE(0xBE, { ModifyHL([this](uint8& Val) { RES_8BIT(7, Val, 4); }); }) // RES 7, (HL)
+GB_CB_OPCODE(0xBF, { RES_8BIT(7, A); }) // RES 7, A
+
+//C0
+GB_CB_OPCODE(0xC0, { SET_8BIT(0, B); }) // SET 0, B
+GB_CB_OPCODE(0xC1, { SET_8BIT(0, C); }) // SET 0, C
+GB_CB_OPCODE(0xC2, { SET_8BIT(0, D); }) // SET 0, D
+GB_CB_OPCODE(0xC3, { SET_8BIT(0, E); }) // SET 0, E
+GB_CB_OPCODE(0xC4, { SET_8BIT(0, H); }) // SET 0, H
+GB_CB_OPCODE(0xC5, { SET_8BIT(0, L); }) // SET 0, L
+GB_CB_OPCODE(0xC6, { ModifyHL([this](uint8& Val) { SET_8BIT(0, Val, 4); }); }) // SET 0, (HL)
+GB_CB_OPCODE(0xC7, { SET_8BIT(0, A); }) // SET 0, A
+GB_CB_OPCODE(0xC8, { SET_8BIT(1, B); }) // SET 1, B
+GB_CB_OPCODE(0xC9, { SET_8BIT(1, C); }) // SET 1, C
+GB_CB_OPCODE(0xCA, { SET_8BIT(1, D); }) // SET 1, D
+GB_CB_OPCODE(0xCB, { SET_8BIT(1, E); }) // SET 1, E
+GB_CB_OPCODE(0xCC, { SET_8BIT(1, H); }) // SET 1, H
+GB_CB_OPCODE(0xCD, { SET_8BIT(1, L); }) // SET 1, L
+GB_CB_OPCODE(0xCE, { ModifyHL([this](uint8& Val) { SET_8BIT(1, Val, 4); }); }) // SET 1, (HL)
+GB_CB_OPCODE(0xCF, { SET_8BIT(1, A); }) // SET 1, A
+
+//D0
+GB_CB_OPCODE(0xD0, { SET_8BIT(2, B); }) // SET 2, B
+GB_CB_OPCODE(0xD1, { SET_8BIT(2, C); }) // SET 2, C
+GB_CB_OPCODE(0xD2, { SET_8BIT(2, D); }) // SET 2, D
+GB_CB_OPCODE(0xD3, { SET_8BIT(2, E); }) // SET 2, E
+GB_CB_OPCODE(0xD4, { SET_8BIT(2, H); }) // SET 2, H
+GB_CB_OPCODE(0xD5, { SET_8BIT(2, L); }) // SET 2, L
+GB_CB_OPCODE(0xD6, { ModifyHL([this](uint8& Val) { SET_8BIT(2, Val, 4); }); }) // SET 2, (HL)
+GB_CB_OPCODE(0xD7, { SET_8BIT(2, A); }) // SET 2, A
+GB_CB_OPCODE(0xD8, { SET_8BIT(3, B); }) // SET 3, B
+GB_CB_OPCODE(0xD9, { SET_8BIT(3, C); }) // SET 3, C
+GB_CB_OPCODE(0xDA, { SET_8BIT(3, D); }) // SET 3, D
+GB_CB_OPCODE(0xDB, { SET_8BIT(3, E); }) // SET 3, E
+GB_CB_OPCODE(0xDC, { SET_8BIT(3, H); }) // SET 3, H
+GB_CB_OPCODE(0xDD, { SET_8BIT(3, L); }) // SET 3, L
+GB_CB_OPCODE(0xDE, { ModifyHL([this](uint8& Val) { SET_8BIT(3, Val, 4); }); }) // SET 3, (HL)
+GB_CB_OPCODE(0xDF, { SET_8BIT(3, A); }) // SET 3, A
+
+//E0
+GB_CB_OPCODE(0xE0, { SET_8BIT(4, B); }) // SET 4, B
+GB_CB_OPCODE(0xE1, { SET_8BIT(4, C); }) // SET 4, C
+GB_CB_OPCODE(0xE2, { SET_8BIT(4, D); }) // SET 4, D
+GB_CB_OPCODE(0xE3, { SET_8BIT(4, E); }) // SET 4, E
+GB_CB_OPCODE(0xE4, { SET_8BIT(4, H); }) // SET 4, H
+GB_CB_OPCODE(0xE5, { SET_8BIT(4, L); }) // SET 4, L
+GB_CB_OPCODE(0xE6, { ModifyHL([this](uint8& Val) { SET_8BIT(4, Val, 4); }); }) // SET 4, (HL)
+GB_CB_OPCODE(0xE7, { SET_8BIT(4, A); }) // SET 4, A
+GB_CB_OPCODE(0xE8, { SET_8BIT(5, B); }) // SET 5, B
+GB_CB_OPCODE(0xE9, { SET_8BIT(5, C); }) // SET 5, C
+GB_CB_OPCODE(0xEA, { SET_8BIT(5, D); }) // SET 5, D
+GB_CB_OPCODE(0xEB, { SET_8BIT(5, E); }) // SET 5, E
+GB_CB_OPCODE(0xEC, { SET_8BIT(5, H); }) // SET 5, H
+GB_CB_OPCODE(0xED, { SET_8BIT(5, L); }) // SET 5, L
+GB_CB_OPCODE(0xEE, { ModifyHL([this](uint8& Val) { SET_8BIT(5, Val, 4); }); }) // SET 5, (HL)
+GB_CB_OPCODE(0xEF, { SET_8BIT(5, A); }) // SET 5, A
+
+//F0
+GB_CB_OPCODE(0xF0, { SET_8BIT(6, B); }) // SET 6, B
+GB_CB_OPCODE(0xF1, { SET_8BIT(6, C); }) // SET 6, C
+GB_CB_OPCODE(0xF2, { SET_8BIT(6, D); }) // SET 6, D
+GB_CB_OPCODE(0xF3, { SET_8BIT(6, E); }) // SET 6, E
+GB_CB_OPCODE(0xF4, { SET_8BIT(6, H); }) // SET 6, H
+GB_CB_OPCODE(0xF5, { SET_8BIT(6, L); }) // SET 6, L
+GB_CB_OPCODE(0xF6, { ModifyHL([this](uint8& Val) { SET_8BIT(6, Val, 4); }); }) // SET 6, (HL)
+GB_CB_OPCODE(0xF7, { SET_8BIT(6, A); }) // SET 6, A
+GB_CB_OPCODE(0xF8, { SET_8BIT(7, B); }) // SET 7, B
+GB_CB_OPCODE(0xF9, { SET_8BIT(7, C); }) // SET 7, C
+GB_CB_OPCODE(0xFA, { SET_8BIT(7, D); }) // SET 7, D
+GB_CB_OPCODE(0xFB, { SET_8BIT(7, E); }) // SET 7, E
+GB_CB_OPCODE(0xFC, { SET_8BIT(7, H); }) // SET 7, H
+GB_CB_OPCODE(0xFD, { SET_8BIT(7, L); }) // SET 7, L
+GB_CB_OPCODE(0xFE, { ModifyHL([this](uint8& Val) { SET_8BIT(7, Val, 4); }); }) // SET 7, (HL)
+GB_CB_OPCODE(0xFF, { SET_8BIT(7, A); }) // SET 7, A
\ No newline at end of file
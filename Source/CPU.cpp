@@ -2,8 +2,15 @@
 #include "Cartridge.h"
 #include "Log.h"
 #include <assert.h>
+#include <algorithm>
 #include "Timer.h"
-#include "SDL.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+//labels as values, the interpreter jumps from handler to handler without going back through a switch
+#define GB_COMPUTED_GOTO 1
+#else
+#define GB_COMPUTED_GOTO 0
+#endif
 
 std::string GameBoyCPU::FlagsToString()
 {
@@ -18,7 +25,7 @@ std::string GameBoyCPU::RegistersToString()
 {
 #if DEBUG
 	char buffer[10 * 1024];
-	sprintf_s(buffer, 10 * 1024, "A:0x%02x F:0x%02x B:0x%02x C:0x%02x D:0x%02x E:0x%02x H:0x%02x L:0x%02x SP:0x%04x", A, F, B, C, D, E, H, L, SP);
+	snprintf(buffer, sizeof(buffer), "A:0x%02x F:0x%02x B:0x%02x C:0x%02x D:0x%02x E:0x%02x H:0x%02x L:0x%02x SP:0x%04x", A, PackFlags(), B, C, D, E, H, L, SP);
 	return std::string(buffer);
 #else
 	return std::string();
@@ -71,7 +78,11 @@ void GameBoyCPU::DebugExecution(const std::string& Instruction, uint16 SixteenBi
 
 GameBoyCPU::GameBoyCPU()
 {
-
+	m_Platform.Clock = &m_DefaultClock;
+	m_DefaultPacer.SetClock(m_Platform.Clock);
+	m_FramePacer = &m_DefaultPacer;
+	m_Memory.SetCodeWatcher(this);
+	m_UncachedOp[1] = GBBlockCache::s_EndOfBlock;
 }
 
 GameBoyCPU::~GameBoyCPU()
@@ -84,17 +95,89 @@ void GameBoyCPU::SetCartridge(Cartridge* cart)
 	m_FitCartridge = cart;
 }
 
-void GameBoyCPU::TurnOn()
+void GameBoyCPU::SetPlatform(const GBPlatform& platform)
 {
-	if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
+	m_Platform = platform;
+	if (m_Platform.Clock == nullptr)
 	{
-		return;
+		m_Platform.Clock = &m_DefaultClock;
+	}
+	m_DefaultPacer.SetClock(m_Platform.Clock);
+}
+
+void GameBoyCPU::SetFramePacer(IFramePacer* Pacer)
+{
+	m_FramePacer = (Pacer != nullptr) ? Pacer : &m_DefaultPacer;
+}
+
+bool GameBoyCPU::SetAudioSync(double LatencySeconds)
+{
+	IAudioSink* Sink = m_Platform.Audio;
+	if ((Sink == nullptr) || (Sink->GetBufferCapacity() == 0) || (LatencySeconds <= 0.0))
+	{
+		return false;
+	}
+
+	//at least one flush plus one device callback in flight, and room left for the next flush
+	uint32 Target = uint32(LatencySeconds * Sink->GetSampleRate());
+	Target = std::max(Target, GBSound::BufferSize + GBSound::BufferSize / 2);
+	Target = std::min(Target, Sink->GetBufferCapacity() - GBSound::BufferSize);
+	m_AudioSyncTarget = Target;
+
+	m_DefaultPacer.SetAudioSink(Sink, Target);
+	m_DefaultPacer.SetMode(EPacingMode::AudioSync);
+
+	if (m_GameboySound)
+	{
+		m_GameboySound->SetRateControl(Target);
+	}
+	return true;
+}
+
+void GameBoyCPU::SetFrameSkip(uint32 Skip)
+{
+	m_FrameSkip = Skip;
+	if (m_GBGPU)
+	{
+		m_GBGPU->GetRendering().SetFrameSkip(Skip);
 	}
+}
+
+void GameBoyCPU::SetAutoFrameSkip(bool Enabled)
+{
+	m_AutoFrameSkip = Enabled;
+	if (m_GBGPU && !Enabled)
+	{
+		m_GBGPU->GetRendering().SetBehindSchedule(false);
+	}
+}
 
+void GameBoyCPU::SetAudioMuted(bool Muted)
+{
+	m_AudioMuted = Muted;
+	if (m_GameboySound)
+	{
+		m_GameboySound->SetMuted(Muted);
+	}
+}
+
+void GameBoyCPU::TurnOn()
+{
 	m_GameboyTimer = std::make_unique<GBTimer>(this);
 	m_GBGPU = std::make_unique<GPU>(this);
+	if (m_ThreadedRendering)
+	{
+		m_RenderThread = std::make_unique<GBRenderThread>();
+		m_GBGPU->SetRenderThread(m_RenderThread.get());
+	}
+	m_GBGPU->GetRendering().SetFrameSkip(m_FrameSkip);
 	m_GameboyInput = std::make_unique<GBInput>(this);
 	m_GameboySound = std::make_unique<GBSound>(this);
+	m_GameboySound->SetRateControl(m_AudioSyncTarget);
+	m_GameboySound->SetMuted(m_AudioMuted);
+
+	m_Scheduler.SetHandler(GBEvents::FrameEnd, this);
+	m_Scheduler.Schedule(GBEvents::FrameEnd, m_FullCycles + Timings::FrameCycles);
 
 	//setup memory
 	m_Memory.RegisterElementRange(0x0000, 0x7FFF, m_FitCartridge);
@@ -128,40 +211,7 @@ void GameBoyCPU::TurnOn()
 
 	m_BootSequence = true;
 	PC = 0;
-}
-
-uint8& GameBoyCPU::ReadMemory(uint16 address, bool skipCycles)
-{
-	if (!skipCycles)
-	{
-		m_Cycles += 4;
-	}
-	
-	if (m_BootSequence)
-	{
-		if (Between<uint16>(0x0000, 0x00ff, address))
-		{
-			return s_Firmware[address];
-		}
-		else
-		{
-			return m_Memory.Read(address);
-		}
-	}
-	else
-	{
-		return m_Memory.Read(address);
-	}
-}
-
-void GameBoyCPU::WriteMemory(uint16 address, uint8 value, bool skipCycles)
-{
-	if (!skipCycles)
-	{
-		m_Cycles += 4;
-	}
-
-	m_Memory.Write(address, value);
+	FlushBlockCache();
 }
 
 void GameBoyCPU::FireInterrupt(uint8 InterruptCode)
@@ -245,7 +295,7 @@ void GameBoyCPU::RenderScanline()
 	m_GBGPU->RenderScanline();
 }
 
-void GameBoyCPU::Run(bool SkipBootstrap)
+void GameBoyCPU::Boot(bool SkipBootstrap)
 {
 	if (SkipBootstrap)
 	{
@@ -291,54 +341,246 @@ void GameBoyCPU::Run(bool SkipBootstrap)
 		m_Memory.Write(0xFF4B, 0x00); // WX
 		m_Memory.Write(0xFFFF, 0x00); // IE
 	}
+}
+
+bool GameBoyCPU::RunFrame()
+{
+	m_FrameDone = false;
+	while (!m_FrameDone)
+	{
+		//F is written by setup, save states and debuggers between runs, the interpreter works unpacked
+		LoadFlags();
+		if ((m_Trace != nullptr) || (m_Recompiler && !GB_COMPUTED_GOTO))
+		{
+			InterpretSteps();
+		}
+		else
+		{
+			Interpret();
+		}
+		StoreFlags();
+		m_Scheduler.RunDueEvents(m_FullCycles);
+	}
 
-	int32 instrCount = 0;
+	return m_GameboyInput->PollEvents();
+}
 
-	bool goOn = true;
-	Timer FrameTimer;
-	FrameTimer.Start();
-	while (goOn)
+void GameBoyCPU::SaveState(GBSaveState& State) const
+{
+	GBMachineState& Machine = State.Machine;
+
+	Machine.CPU.AF = AF;
+	Machine.CPU.BC = BC;
+	Machine.CPU.DE = DE;
+	Machine.CPU.HL = HL;
+	Machine.CPU.PC = PC;
+	Machine.CPU.SP = SP;
+	Machine.CPU.BootSequence = m_BootSequence;
+	Machine.CPU.InterruptEnabled = m_InterruptEnabled;
+	Machine.CPU.IsHalted = m_IsHalted;
+	Machine.CPU.FullCycles = m_FullCycles;
+
+	m_Scheduler.SaveState(Machine.Scheduler);
+	m_Memory.SaveState(Machine.Memory);
+	m_GBGPU->SaveState(Machine.GPU);
+	m_GameboyTimer->SaveState(Machine.Timer);
+	m_GameboyInput->SaveState(Machine.Input);
+	m_GameboySound->SaveState(Machine.Sound);
+
+	if (m_FitCartridge != nullptr)
 	{
-		m_Cycles = 0;
+		m_FitCartridge->SaveState(State);
+	}
+	else
+	{
+		memset(&Machine.Cartridge, 0, sizeof(GBCartridgeState));
+		State.CartridgeRAM.clear();
+	}
+}
 
-		ManageInterrupts();
-		ExecutePC();
+bool GameBoyCPU::LoadState(const GBSaveState& State)
+{
+	//the cartridge is the only part that can refuse a state, it goes first
+	if (m_FitCartridge != nullptr)
+	{
+		if (!m_FitCartridge->LoadState(State))
+		{
+			return false;
+		}
+	}
+	else if (!State.CartridgeRAM.empty())
+	{
+		return false;
+	}
 
-		m_FullCycles += m_Cycles;
-		m_FrameCycles += m_Cycles;
-		CheckRegisters();
-		m_GBGPU->Update(m_Cycles);
-		m_GameboyTimer->Update(m_Cycles);
-		m_GameboySound->Update(m_Cycles);
-		instrCount++;
+	const GBMachineState& Machine = State.Machine;
+
+	AF = Machine.CPU.AF;
+	BC = Machine.CPU.BC;
+	DE = Machine.CPU.DE;
+	HL = Machine.CPU.HL;
+	PC = Machine.CPU.PC;
+	SP = Machine.CPU.SP;
+	m_BootSequence = Machine.CPU.BootSequence != 0;
+	m_InterruptEnabled = Machine.CPU.InterruptEnabled != 0;
+	m_IsHalted = Machine.CPU.IsHalted != 0;
+	m_FullCycles = Machine.CPU.FullCycles;
+
+	m_Memory.LoadState(Machine.Memory);
+	m_GBGPU->LoadState(Machine.GPU);
+	m_GameboyTimer->LoadState(Machine.Timer);
+	m_GameboyInput->LoadState(Machine.Input);
+	m_GameboySound->LoadState(Machine.Sound);
+	m_Scheduler.LoadState(Machine.Scheduler);
+	//blocks are keyed by host memory, ROM blocks stay valid whatever banks the state maps and
+	//RAM pages with other code in them were invalidated by the memory restore
+	m_NextOp = &GBBlockCache::s_EndOfBlock;
+	return true;
+}
 
-		if (m_FrameCycles >= Timings::FrameCycles)
+void GameBoyCPU::FlushBlockCache()
+{
+	m_BlockCache.Flush();
+	if (m_Recompiler)
+	{
+		m_Recompiler->Reset();
+	}
+	m_NextOp = &GBBlockCache::s_EndOfBlock;
+}
+
+bool GameBoyCPU::SetRecompiler(bool Enabled)
+{
+	if (Enabled && !m_Recompiler && GBRecompiler::IsSupported())
+	{
+		m_Recompiler = std::make_unique<GBRecompiler>();
+		if (m_Recompiler->IsFull())
 		{
-			m_GameboyInput->Update();
-			goOn = m_GBGPU->PollEvents();
-			m_FrameCycles = 0;
+			//no executable memory
+			m_Recompiler.reset();
+		}
+	}
+	else if (!Enabled)
+	{
+		m_Recompiler.reset();
+	}
 
-			while (true)
-			{
-				double Time = FrameTimer.End();
-				if (Time >= (1.0f / 60.0f))
-				{ 
-					FrameTimer.Start();
-					break;
-				}
-			}
+	//blocks can't keep pointers into code that is gone
+	FlushBlockCache();
+	return m_Recompiler != nullptr;
+}
+
+void GameBoyCPU::OnCodeWritten(uint16 Address)
+{
+	m_BlockCache.InvalidateRAM(Address);
+	m_NextOp = &GBBlockCache::s_EndOfBlock;
+}
+
+const GBDecodedOp* GameBoyCPU::DecodeAt(uint16 Address)
+{
+	const GBDecodedOp* ops = m_BlockCache.Find(Address, m_BootSequence);
+	if (ops != nullptr)
+	{
+		return ops;
+	}
+
+	GBDecodedOp& op = m_UncachedOp[0];
+	op.PC = Address;
+	op.Opcode = ReadMemory(Address, true);
+	op.Length = GBBlockCache::GetLength(op.Opcode);
+	op.Operand = (op.Length > 1) ? ReadMemory(uint16(Address + 1), true) : 0;
+	if (op.Length > 2)
+	{
+		op.Operand |= ReadMemory(uint16(Address + 2), true) << 8;
+	}
+	return m_UncachedOp;
+}
+
+void GameBoyCPU::OnEvent(uint8 /*EventId*/, uint64 Deadline, uint64 /*Now*/)
+{
+	m_GameboyInput->Update();
+	m_FrameDone = true;
+	//from the deadline, so the instruction overrun does not add up over frames
+	m_Scheduler.Schedule(GBEvents::FrameEnd, Deadline + Timings::FrameCycles);
+}
+
+void GameBoyCPU::Run(bool SkipBootstrap)
+{
+	Boot(SkipBootstrap);
+
+	bool goOn = true;
+	m_FramePacer->Reset();
+	while (goOn)
+	{
+		UpdateRewind();
+		goOn = (m_RunAheadFrames > 0) ? RunFrameAhead() : RunFrame();
+		m_FramePacer->WaitForNextFrame();
+
+		if (m_AutoFrameSkip)
+		{
+			m_GBGPU->GetRendering().SetBehindSchedule(m_FramePacer->IsBehindSchedule());
 		}
 	}
+
+	//nothing presents what the render thread draws once Run is over
+	if (m_RenderThread)
+	{
+		m_RenderThread->Stop();
+	}
 }
 
-bool GameBoyCPU::CheckHalfCarry(uint8 val1, uint8 val2)
+bool GameBoyCPU::PresentRenderedFrame(uint32 WaitMilliseconds)
 {
-	return (((val1 & 0xf) + (val2 & 0xf)) & 0x10) == 0x10;
+	if (!m_RenderThread)
+	{
+		return false;
+	}
+	return m_RenderThread->PresentFinishedFrame(m_Platform.Video, WaitMilliseconds);
 }
 
-bool GameBoyCPU::CheckHalfCarry(uint16 val1, uint16 val2)
+bool GameBoyCPU::RunFrameAhead()
 {
-	return (((val1 & 0xff) + (val2 & 0xff)) & 0x100) == 0x100;
+	GBRendering& Rendering = m_GBGPU->GetRendering();
+
+	//the real frame: heard, not seen
+	Rendering.SetPresentSuppressed(true);
+	bool goOn = RunFrame();
+	SaveState(m_RunAheadState);
+
+	//the hidden frames: seen (only the last one), never heard
+	m_GameboySound->SetMuted(true);
+	for (uint32 i = 0; i < m_RunAheadFrames; ++i)
+	{
+		Rendering.SetPresentSuppressed(i + 1 < m_RunAheadFrames);
+		goOn = RunFrame() && goOn;
+	}
+
+	LoadState(m_RunAheadState);
+	m_GameboySound->SetMuted(m_AudioMuted);
+	Rendering.SetPresentSuppressed(false);
+	return goOn;
+}
+
+void GameBoyCPU::UpdateRewind()
+{
+	if (m_RewindBuffer == nullptr)
+	{
+		return;
+	}
+
+	//rewinding restores the start of the previous frame and runs it again so it's shown,
+	//every held frame steps one frame further back until the history runs out
+	IInputSource* Input = m_Platform.Input;
+	if ((Input != nullptr) && Input->IsRewindHeld())
+	{
+		if (m_RewindBuffer->Pop(m_RewindState))
+		{
+			LoadState(m_RewindState);
+		}
+		return;
+	}
+
+	SaveState(m_RewindState);
+	m_RewindBuffer->Push(m_RewindState);
 }
 
 void GameBoyCPU::Push(uint16 value)
@@ -362,554 +604,237 @@ uint16 GameBoyCPU::Pull()
 	return val;
 }
 
-void GameBoyCPU::ExecutePC()
+namespace
 {
-	if (m_IsHalted)
+	constexpr uint32 s_OpcodeOrder[] =
+	{
+#define GB_OPCODE(Code, ...) Code,
+#include "OpcodeTable.inl"
+#undef GB_OPCODE
+	};
+
+	constexpr uint32 s_CBOpcodeOrder[] =
+	{
+#define GB_CB_OPCODE(Code, ...) Code,
+#include "CBOpcodeTable.inl"
+#undef GB_CB_OPCODE
+	};
+
+	constexpr bool IsInOpcodeOrder(const uint32* Codes, uint32 Count)
+	{
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			if (Codes[i] != i)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//the tables below are indexed by opcode, so the list has to be complete and sorted
+	static_assert((sizeof(s_OpcodeOrder) == 256 * sizeof(uint32)) && IsInOpcodeOrder(s_OpcodeOrder, 256), "OpcodeTable.inl must list all 256 opcodes in order");
+	static_assert((sizeof(s_CBOpcodeOrder) == 256 * sizeof(uint32)) && IsInOpcodeOrder(s_CBOpcodeOrder, 256), "CBOpcodeTable.inl must list all 256 opcodes in order");
+}
+
+#define GB_OPCODE(Code, ...) void GameBoyCPU::Opcode_##Code() __VA_ARGS__
+#include "OpcodeTable.inl"
+#undef GB_OPCODE
+
+const GameBoyCPU::OpcodeHandler GameBoyCPU::s_OpcodeHandlers[256] =
+{
+#define GB_OPCODE(Code, ...) &GameBoyCPU::Opcode_##Code,
+#include "OpcodeTable.inl"
+#undef GB_OPCODE
+};
+
+void GameBoyCPU::Interpret()
+{
+#if GB_COMPUTED_GOTO
+	static void* const s_Labels[256] =
+	{
+#define GB_OPCODE(Code, ...) &&Label_##Code,
+#include "OpcodeTable.inl"
+#undef GB_OPCODE
+	};
+
+	const bool Native = (m_Recompiler != nullptr);
+
+	//every handler ends in its own copy of this, so each opcode gets its own indirect jump and the
+	//predictor learns which opcode tends to follow which. Only the common case is inlined: anything
+	//that needs a look (boot ROM, HALT, a pending interrupt, the deadline, a block start with the
+	//recompiler on) goes through Retire
+#define GB_DISPATCH() \
+	m_FullCycles += m_Cycles; \
+	if (!m_BootSequence && !m_IsHalted && !(m_InterruptEnabled && m_Memory.HasPendingInterrupt()) \
+		&& (m_FullCycles < m_Scheduler.GetNextDeadline()) && (!Native || (m_NextOp->PC == PC))) \
+	{ \
+		m_Cycles = 0; \
+		goto *s_Labels[FetchInstruction()]; \
+	} \
+	goto Retire;
+
+	goto Next;
+
+Retire:
+	if (m_BootSequence)
+	{
+		CheckRegisters();
+	}
+
+Next:
+	//register writes can move deadlines earlier, so the next one is re-read every instruction
+	if (m_FullCycles >= m_Scheduler.GetNextDeadline())
 	{
-		NOP();
 		return;
 	}
 
-	uint8 Instruction = FetchInstruction();
-	switch (Instruction)
-	{
-
-	// 00
-	case 0x00: // NOP 
-	{ NOP(); } break;
-	case 0x01: // LD BC, NN
-	{ LD_16REG_NN(BC, "BC"); }	break;
-	case 0x02: // LD (BC), A
-	{ LD_PTR_8REG(BC, A, "(BC), A"); } break;
-	case 0x03: // INC BC
-	{ INC_16REG(BC, "BC"); } break;
-	case 0x04: // INC B
-	{ INC_8REG(B, "B");	} break;
-	case 0x05: // DEC B
-	{ DEC_8REG(B, "B");	} break;
-	case 0x06: // LD B, N
-	{ LD_8REG_N(B, "B"); } break;
-	case 0x07: //RLCA
-	{ RLCA(); } break;
-	case 0x08: //LD (NN), SP
-	{ LD_PTR_16REG(Fetch16BitParameter(), SP, "SP"); } break;
-	case 0x09: // ADD HL, BC
-	{ ADD_16BIT_16BIT(HL, BC, "HL, BC"); } break;
-	case 0x0A: // LD A, (BC)
-	{ LD_8REG_PTR(A, BC, "A, (HL)"); } break;
-	case 0x0B: //DEC BC
-	{ DEC_16REG(BC, "BC"); } break;
-	case 0x0C: // INC C
-	{ INC_8REG(C, "C");	} break;
-	case 0x0D: // DEC C
-	{ DEC_8REG(C, "C");	} break;
-	case 0x0E: // LD C, N
-	{ LD_8REG_N(C, "C"); } break;
-	case 0x0F: // LD C, N
-	{ RRCA(); } break;
-
-	//10
-	case 0x10: // STOP
-	{ STOP(); } break;
-	case 0x11: // LD DE, NN
-	{ LD_16REG_NN(DE, "DE"); }	break;
-	case 0x12: // LD (DE), A
-	{ LD_PTR_8REG(DE, A, "(DE), A"); } break;
-	case 0x13: // INC DE
-	{ INC_16REG(DE, "DE"); } break;
-	case 0x14: // INC D
-	{ INC_8REG(D, "D");	} break;
-	case 0x15: // DEC D
-	{ DEC_8REG(D, "D");	} break;
-	case 0x19: // ADD HL, DE
-	{ ADD_16BIT_16BIT(HL, DE, "HL, DE"); } break;
-	case 0x1B: //DEC DE
-	{ DEC_16REG(DE, "DE"); } break;
-	case 0x1C: // INC E
-	{ INC_8REG(E, "E");	} break;
-	case 0x1D: // DEC E
-	{ DEC_8REG(E, "E");	} break;
-	case 0x16: // LD D, N
-	{ LD_8REG_N(D, "D"); } break;
-	case 0x17: //RLA
-	{ RLA(); }	break;
-	case 0x18: // JR Address
-	{ JR(); } break;
-	case 0x1A: // LD A, (DE)
-	{ LD_8REG_PTR(A, DE, "A, (DE)"); } break;
-	case 0x1E: // LD E, N
-	{ LD_8REG_N(E, "E"); } break;
-	case 0x1F: // RRA
-	{ RRA(); } break;
-
-	//20
-	case 0x20: // JR NZ, Address
-	{ JR_Flag_NN(EFlagMask::FZ, false, "NZ"); }	break;
-	case 0x21: // LD HL, NN
-	{ LD_16REG_NN(HL, "HL"); }	break;
-	case 0x22: // LD (HL+), A
-	{ LD_HLP_A(); }	break;
-	case 0x23: // INC HL
-	{ INC_16REG(HL, "HL"); } break;
-	case 0x24: // INC H
-	{ INC_8REG(H, "H");	} break;
-	case 0x25: // DEC H
-	{ DEC_8REG(H, "H");	} break;
-	case 0x26: // LD H, N
-	{ LD_8REG_N(H, "H"); } break;
-	case 0x27: //DAA
-	{ DAA(); } break;
-	case 0x28: // JR Z, Address
-	{ JR_Flag_NN(EFlagMask::FZ, true, "Z"); } break;
-	case 0x29: // ADD HL, HL
-	{ ADD_16BIT_16BIT(HL, HL, "HL, HL"); } break;
-	case 0x2A : //LD A, (HL+)
-	{ LD_A_HLP(); } break;
-	case 0x2B: //DEC HL
-	{ DEC_16REG(HL, "HL"); } break;
-	case 0x2C: // INC L
-	{ INC_8REG(L, "L");	} break;
-	case 0x2D: // DEC L
-	{ DEC_8REG(L, "L");	} break;
-	case 0x2E: // LD L, N
-	{ LD_8REG_N(L, "H"); } break;
-	case 0x2F: //CPL
-	{ CPL(); } break;
-
-	//30
-	case 0x30: // JR NC, Address
-	{ JR_Flag_NN(EFlagMask::FC, false, "Z"); } break;
-	case 0x31: // LD SP, NN
-	{ LD_16REG_NN(SP, "SP"); }	break;
-	case 0x32: // LD (HL-), A
-	{ LD_HLM_A(); }	break;
-	case 0x33: // INC SP
-	{ INC_16REG(SP, "SP"); } break;
-	case 0x34: // INC (HL)
-	{ INC_8REG(ReadMemory(HL), "Memory[HL]", 4); } break;
-	case 0x35: // DEC (HL)
-	{ DEC_8REG(ReadMemory(HL), "Memory[HL]", 4); } break;
-	case 0x36: // LD (HL), N
-	{ LD_PTR_8REG(HL, Fetch8BitParameter(), "(HL), N"); } break;
-	case 0x37: // SCF
-	{ SCF(); } break;
-	case 0x38: // JR C, Address
-	{ JR_Flag_NN(EFlagMask::FC, true, "Z"); } break;
-	case 0x39: // ADD HL, SP
-	{ ADD_16BIT_16BIT(HL, SP, "HL, SP"); } break;
-	case 0x3A: //LD A, (HL-)
-	{ LD_A_HLM(); } break;
-	case 0x3B: //DEC SP
-	{ DEC_16REG(SP, "SP"); } break;
-	case 0x3C: // INC A
-	{ INC_8REG(A, "A");	} break;
-	case 0x3D: // DEC A
-	{ DEC_8REG(A, "A");	} break;
-	case 0x3E: // LD A, N
-	{ LD_8REG_N(A, "A"); } break;
-	case 0x3F: // CCF
-	{ CCF(); } break;
-
-	//40
-	case 0x40: // LD B, B
-	{ LD_8BIT_8BIT(B, B, "B, B"); }	break;
-	case 0x41: // LD B, C
-	{ LD_8BIT_8BIT(B, C, "B, C"); }	break;
-	case 0x42: // LD B, D
-	{ LD_8BIT_8BIT(B, D, "B, D"); }	break;
-	case 0x43: // LD B, E
-	{ LD_8BIT_8BIT(B, E, "B, E"); }	break;
-	case 0x44: // LD B, H
-	{ LD_8BIT_8BIT(B, H, "B, H"); }	break;
-	case 0x45: // LD B, L
-	{ LD_8BIT_8BIT(B, L, "B, L"); }	break;
-	case 0x46: // LD B, (HL)
-	{ LD_8BIT_8BIT(B, ReadMemory(HL), "B, (HL)"); }	break;
-	case 0x47: // LD B, A
-	{ LD_8BIT_8BIT(B, A, "B, A"); }	break;
-	case 0x48: // LD C, B
-	{ LD_8BIT_8BIT(C, B, "C, B"); }	break;
-	case 0x49: // LD C, C
-	{ LD_8BIT_8BIT(C, C, "C, C"); }	break;
-	case 0x4A: // LD C, D
-	{ LD_8BIT_8BIT(C, D, "C, D"); }	break;
-	case 0x4B: // LD C, E
-	{ LD_8BIT_8BIT(C, E, "C, E"); }	break;
-	case 0x4C: // LD C, H
-	{ LD_8BIT_8BIT(C, H, "C, H"); }	break;
-	case 0x4D: // LD C, L
-	{ LD_8BIT_8BIT(C, L, "C, L"); }	break;
-	case 0x4E: // LD C, (HL)
-	{ LD_8BIT_8BIT(C, ReadMemory(HL), "C, (HL)"); }	break;
-	case 0x4F: // LD C, A
-	{ LD_8BIT_8BIT(C, A, "C, A"); }	break;
-
-	//50
-	case 0x50: // LD D, B
-	{ LD_8BIT_8BIT(D, B, "D, B"); }	break;
-	case 0x51: // LD D, C
-	{ LD_8BIT_8BIT(D, C, "D, C"); }	break;
-	case 0x52: // LD D, D
-	{ LD_8BIT_8BIT(D, D, "D, D"); }	break;
-	case 0x53: // LD D, E
-	{ LD_8BIT_8BIT(D, E, "D, E"); }	break;
-	case 0x54: // LD D, H
-	{ LD_8BIT_8BIT(D, H, "D, H"); }	break;
-	case 0x55: // LD D, L
-	{ LD_8BIT_8BIT(D, L, "D, L"); }	break;
-	case 0x56: // LD D, (HL)
-	{ LD_8BIT_8BIT(D, ReadMemory(HL), "D, (HL)"); }	break;
-	case 0x57: // LD D, A
-	{ LD_8BIT_8BIT(D, A, "D, A"); }	break;
-	case 0x58: // LD E, B
-	{ LD_8BIT_8BIT(E, B, "E, B"); }	break;
-	case 0x59: // LD E, C
-	{ LD_8BIT_8BIT(E, C, "E, C"); }	break;
-	case 0x5A: // LD E, D
-	{ LD_8BIT_8BIT(E, D, "E, D"); }	break;
-	case 0x5B: // LD E, E
-	{ LD_8BIT_8BIT(E, E, "E, E"); }	break;
-	case 0x5C: // LD E, H
-	{ LD_8BIT_8BIT(E, H, "E, H"); }	break;
-	case 0x5D: // LD E, L
-	{ LD_8BIT_8BIT(E, L, "E, L"); }	break;
-	case 0x5E: // LD E, (HL)
-	{ LD_8BIT_8BIT(E, ReadMemory(HL), "E, (HL)"); }	break;
-	case 0x5F: // LD E, A
-
-	//60
-	{ LD_8BIT_8BIT(E, A, "E, A"); }	break;
-	case 0x60: // LD H, B
-	{ LD_8BIT_8BIT(H, B, "H, B"); }	break;
-	case 0x61: // LD H, C
-	{ LD_8BIT_8BIT(H, C, "H, C"); }	break;
-	case 0x62: // LD H, D
-	{ LD_8BIT_8BIT(H, D, "H, D"); }	break;
-	case 0x63: // LD H, E
-	{ LD_8BIT_8BIT(H, E, "H, E"); }	break;
-	case 0x64: // LD H, H
-	{ LD_8BIT_8BIT(H, H, "H, H"); }	break;
-	case 0x65: // LD H, L
-	{ LD_8BIT_8BIT(H, L, "H, L"); }	break;
-	case 0x66: // LD H, (HL)
-	{ LD_8BIT_8BIT(H, ReadMemory(HL), "H, (HL)"); }	break;
-	case 0x67: // LD H, A
-	{ LD_8BIT_8BIT(H, A, "H, A"); }	break;
-	case 0x68: // LD L, B
-	{ LD_8BIT_8BIT(L, B, "L, B"); }	break;
-	case 0x69: // LD L, C
-	{ LD_8BIT_8BIT(L, C, "L, C"); }	break;
-	case 0x6A: // LD L, D
-	{ LD_8BIT_8BIT(L, D, "L, D"); }	break;
-	case 0x6B: // LD L, E
-	{ LD_8BIT_8BIT(L, E, "L, E"); }	break;
-	case 0x6C: // LD L, H
-	{ LD_8BIT_8BIT(L, H, "L, H"); }	break;
-	case 0x6D: // LD L, L
-	{ LD_8BIT_8BIT(L, L, "L, L"); }	break;
-	case 0x6E: // LD L, (HL)
-	{ LD_8BIT_8BIT(L, ReadMemory(HL), "L, (HL)"); }	break;
-	case 0x6F: // LD L, A
-	{ LD_8BIT_8BIT(L, A, "L, A"); }	break;
-
-	//70
-	case 0x70: // LD (HL), B
-	{ LD_PTR_8REG(HL, B, "(HL), B"); } break;
-	case 0x71: // LD (HL), C
-	{ LD_PTR_8REG(HL, C, "(HL), C"); } break;
-	case 0x72: // LD (HL), D
-	{ LD_PTR_8REG(HL, D, "(HL), D"); } break;
-	case 0x73: // LD (HL), E
-	{ LD_PTR_8REG(HL, E, "(HL), E"); } break;
-	case 0x74: // LD (HL), H
-	{ LD_PTR_8REG(HL, H, "(HL), H"); } break;
-	case 0x75: // LD (HL), L
-	{ LD_PTR_8REG(HL, L, "(HL), L"); } break;
-	case 0x76: //HALT
-	{ HALT(); } break;
-	case 0x77: // LD (HL), A
-	{ LD_PTR_8REG(HL, A, "(HL), A"); } break;
-	case 0x78: // LD A, B
-	{ LD_8BIT_8BIT(A, B, "A, B"); }	break;
-	case 0x79: // LD A, C
-	{ LD_8BIT_8BIT(A, C, "A, C"); }	break;
-	case 0x7A: // LD A, D
-	{ LD_8BIT_8BIT(A, D, "A, D"); }	break;
-	case 0x7B: // LD A, E
-	{ LD_8BIT_8BIT(A, E, "A, E"); }	break;
-	case 0x7C: // LD A, H
-	{ LD_8BIT_8BIT(A, H, "A, H"); }	break;
-	case 0x7D: // LD A, L
-	{ LD_8BIT_8BIT(A, L, "A, L"); }	break;
-	case 0x7E: // LD A, (HL)
-	{ LD_8REG_PTR(A, HL, "A, (HL)"); } break;
-	case 0x7F: // LD A, A
-	{
-		//A = A;
-		m_Cycles += 4;
-		DebugExecution("LD A, A");
-	}
-	break;
-
-	//80
-	case 0x80: // ADD A, B
-	{ ADD_8BIT_8BIT(A, B, "A, B"); } break;
-	case 0x81: // ADD A, C
-	{ ADD_8BIT_8BIT(A, C, "A, C"); } break;
-	case 0x82: // ADD A, D
-	{ ADD_8BIT_8BIT(A, D, "A, D"); } break;
-	case 0x83: // ADD A, E
-	{ ADD_8BIT_8BIT(A, E, "A, E"); } break;
-	case 0x84: // ADD A, H
-	{ ADD_8BIT_8BIT(A, H, "A, H"); } break;
-	case 0x85: // ADD A, L
-	{ ADD_8BIT_8BIT(A, L, "A, L"); } break;
-	case 0x86: // ADD A, (HL)
-	{ ADD_8BIT_8BIT(A, ReadMemory(HL), "A, (HL)"); } break;
-	case 0x87: // ADD A, A
-	{ ADD_8BIT_8BIT(A, A, "A, A"); } break;
-	case 0x88: // ADC A, B
-	{ ADC_A_8BIT(B); } break;
-	case 0x89: // ADC A, C
-	{ ADC_A_8BIT(C); } break;
-	case 0x8A: // ADC A, D
-	{ ADC_A_8BIT(D); } break;
-	case 0x8B: // ADC A, E
-	{ ADC_A_8BIT(E); } break;
-	case 0x8C: // ADC A, H
-	{ ADC_A_8BIT(H); } break;
-	case 0x8D: // ADC A, L
-	{ ADC_A_8BIT(L); } break;
-	case 0x8E: // ADC A, (HL)
-	{ ADC_A_8BIT(ReadMemory(HL)); } break;
-	case 0x8F: // ADC A, A
-	{ ADC_A_8BIT(A); } break;
-
-	//90
-	case 0x90: // SUB B
-	{ SUB_8BIT(B, "B"); } break;
-	case 0x91: // SUB C
-	{ SUB_8BIT(C, "C"); } break;
-	case 0x92: // SUB D
-	{ SUB_8BIT(D, "D"); } break;
-	case 0x93: // SUB E
-	{ SUB_8BIT(E, "E"); } break;
-	case 0x94: // SUB H
-	{ SUB_8BIT(H, "H"); } break;
-	case 0x95: // SUB L
-	{ SUB_8BIT(L, "L"); } break;
-	case 0x96: // SUB (HL)
-	{ SUB_8BIT(ReadMemory(HL), "(HL)"); } break;
-	case 0x97: // SUB A
-	{ SUB_8BIT(A, "A"); } break;
-	case 0x98: // SBC B
-	{ SBC_8BIT(B, "B"); } break;
-	case 0x99: // SBC C
-	{ SBC_8BIT(C, "C"); } break;
-	case 0x9A: // SBC D
-	{ SBC_8BIT(D, "D"); } break;
-	case 0x9B: // SBC E
-	{ SBC_8BIT(E, "E"); } break;
-	case 0x9C: // SBC H
-	{ SBC_8BIT(H, "H"); } break;
-	case 0x9D: // SBC L
-	{ SBC_8BIT(L, "L"); } break;
-	case 0x9E: // SBC (HL)
-	{ SBC_8BIT(ReadMemory(HL), "(HL)"); } break;
-	case 0x9F: // SBC A
-	{ SBC_8BIT(A, "A"); } break;
-
-	//A0
-	case 0xA0: // AND B
-	{ AND_8BIT(B, "B"); } break;
-	case 0xA1: // AND C
-	{ AND_8BIT(C, "C"); } break;
-	case 0xA2: // AND D
-	{ AND_8BIT(D, "D"); } break;
-	case 0xA3: // AND E
-	{ AND_8BIT(E, "E"); } break;
-	case 0xA4: // AND H
-	{ AND_8BIT(H, "H"); } break;
-	case 0xA5: // AND L
-	{ AND_8BIT(L, "L"); } break;
-	case 0xA6: // AND (HL)
-	{ AND_8BIT(ReadMemory(HL), "(HL)"); } break;
-	case 0xA7: // AND A
-	{ AND_8BIT(A, "A"); } break;
-	case 0xA8: // XOR B
-	{ XOR_8BIT(B, "B");	} break;
-	case 0xA9: // XOR C
-	{ XOR_8BIT(C, "C");	} break;
-	case 0xAA: // XOR D
-	{ XOR_8BIT(D, "D");	} break;
-	case 0xAB: // XOR E
-	{ XOR_8BIT(E, "E");	} break;
-	case 0xAC: // XOR H
-	{ XOR_8BIT(H, "H");	} break;
-	case 0xAD: // XOR L
-	{ XOR_8BIT(L, "L");	} break;
-	case 0xAE: // XOR (HL)
-	{ XOR_8BIT(ReadMemory(HL), "(HL)");	} break;
-	case 0xAF: // XOR A
-	{ XOR_8BIT(A, "A");	} break;
-
-	//B0
-	case 0xB0: //OR B
-	{ OR_8BIT(B, "B"); } break;
-	case 0xB1: //OR C
-	{ OR_8BIT(C, "C"); } break;
-	case 0xB2: //OR D
-	{ OR_8BIT(D, "D"); } break;
-	case 0xB3: //OR E
-	{ OR_8BIT(E, "E"); } break;
-	case 0xB4: //OR H
-	{ OR_8BIT(H, "H"); } break;
-	case 0xB5: //OR L
-	{ OR_8BIT(L, "L"); } break;
-	case 0xB6: //OR (HL)
-	{ OR_8BIT(ReadMemory(HL), "A"); } break;
-	case 0xB7: //OR A
-	{ OR_8BIT(A, "A"); } break;
-	case 0xB8: // CP B
-	{ CP(B, "B"); }	break;
-	case 0xB9: // CP C
-	{ CP(C, "C"); }	break;
-	case 0xBA: // CP D
-	{ CP(D, "D"); }	break;
-	case 0xBB: // CP E
-	{ CP(E, "E"); }	break;
-	case 0xBC: // CP H
-	{ CP(H, "H"); }	break;
-	case 0xBD: // CP L
-	{ CP(L, "L"); }	break;
-	case 0xBE: // CP (HL)
-	{ CP(ReadMemory(HL), "(HL)"); }	break;
-	case 0xBF: // CP A
-
-	//C0
-	{ CP(A, "A"); }	break;
-	case 0xC0: // RET NZ
-	{ RET_FLAG(EFlagMask::FZ, false); }	break;
-	case 0xC1: // POP BC
-	{ POP(BC, "BC"); } break;
-	case 0xC2: //JP NZ, NN
-	{ JP_Flag_NN(EFlagMask::FZ, false); } break;
-	case 0xC3: // JP NN
-	{ JP(); } break;
-	case 0xC4: // CALL NZ, NN
-	{ CALL_FLAG(EFlagMask::FZ, false); } break;
-	case 0xC5: // PUSH BC
-	{ PUSH(BC, "BC"); }	break;
-	case 0xC6: // ADD A, N
-	{ ADD_8BIT_N(A, "A"); }	break;
-	case 0xC7: //RST 00h
-	{ RST(0x00); } break;
-	case 0xC8: // RET Z
-	{ RET_FLAG(EFlagMask::FZ, true); }	break;
-	case 0xC9: // RET
-	{ RET(); }	break;
-	case 0xCA: //JP Z, NN
-	{ JP_Flag_NN(EFlagMask::FZ, true); } break;
-	case 0xCB: // CB instructions
-	{
-		uint8 secondPart = Fetch8BitParameter(true);
-		ManageCBInstruction(secondPart);
-		DEBUGTEXT("CB instruction", secondPart);
-	}
-	break;
-	case 0xCC: // CALL Z, NN
-	{ CALL_FLAG(EFlagMask::FZ, true); } break;
-	case 0xCD: // CALL NN
-	{ CALL(); }	break;
-	case 0xCE: // ADC A, N
-	{ ADC_A_8BIT(Fetch8BitParameter()); } break;
-	case 0xCF: //RST 08h
-	{ RST(0x08); } break;
-
-	//D0
-	case 0xD0: // RET NC
-	{ RET_FLAG(EFlagMask::FC, false); }	break;
-	case 0xD1: // POP DE
-	{ POP(DE, "DE"); } break;
-	case 0xD2: //JP NC, NN
-	{ JP_Flag_NN(EFlagMask::FC, false); } break;
-	case 0xD4: // CALL NC, NN
-	{ CALL_FLAG(EFlagMask::FC, false); } break;
-	case 0xD5: // PUSH DE
-	{ PUSH(DE, "DE"); }	break;
-	case 0xD6: // SUB N
-	{ SUB_8BIT(Fetch8BitParameter(), "NN"); } break;
-	case 0xD7: //RST 10h
-	{ RST(0x10); } break;
-	case 0xD8: // RET C
-	{ RET_FLAG(EFlagMask::FC, true); }	break;
-	case 0xD9: // RETI
-	{ RETI(); }	break;
-	case 0xDA: //JP C, NN
-	{ JP_Flag_NN(EFlagMask::FC, true); } break;
-	case 0xDC: // CALL C, NN
-	{ CALL_FLAG(EFlagMask::FC, true); } break;
-	case 0xDE: // SBC N
-	{ SBC_8BIT(Fetch8BitParameter(), "N"); } break;
-	case 0xDF: //RST 18h
-	{ RST(0x18); } break;
-
-	//E0
-	case 0xE0: // LD ($FF00+N),A
-	{ LD_FF00_A(Fetch8BitParameter(), ""); } break;
-	case 0xE1: // POP HL
-	{ POP(HL, "HL"); } break;
-	case 0xE2: // LD ($FF00+C),A
-	{ LD_FF00_A(C, ""); } break;
-	case 0xE5: // PUSH HL
-	{ PUSH(HL, "HL"); }	break;
-	case 0xE6: // AND N
-	{ AND_8BIT(Fetch8BitParameter(), "N"); } break;
-	case 0xE7: //RST 20h
-	{ RST(0x20); } break;
-	case 0xE8: // ADD SP, n
-	{ ADD_16BIT_N(SP, int8(Fetch8BitParameter()), "ADD SP, N"); } break;
-	case 0xE9: //JP (HL)
-	{ JP_16BIT(HL); } break;
-	case 0xEA: // LD (NN), A
-	{ LD_PTR_8REG(Fetch16BitParameter(), A, "A"); }	break;
-	case 0xEC: //not existing
-	{ } break;
-	case 0xEE: // XOR #
-	{ XOR_8BIT(Fetch8BitParameter(), "N");	} break;
-	case 0xEF: //RST 28h
-	{ RST(0x28); } break;
-
-	//F0
-	case 0xF0: // LD A,($FF00+N)
-	{ LD_A_FF00(Fetch8BitParameter(), ""); } break;
-	case 0xF1: // POP AF
-	{ POP(AF, "AF"); } break;
-	case 0xF2: // LD A,($FF00+C)
-	{ LD_A_FF00(C, ""); } break;
-	case 0xF3: // DI
-	{ DI(); } break;
-	case 0xF5: // PUSH AF
-	{ PUSH(AF, "AF"); }	break;
-	case 0xF6: //OR N
-	{ OR_8BIT(Fetch8BitParameter(), "N"); } break;
-	case 0xF7: //RST 30h
-	{ RST(0x30); } break;
-	case 0xF8: //LD, HL, SP+n
-	{ LD_HL_SP_N(); } break;
-	case 0xF9: // LD SP, HL
-	{ LD_16BIT_16BIT(SP, HL, "SP, HL"); } break;
-	case 0xFA: // LD A, NN
-	{ LD_8BIT_8BIT(A, ReadMemory(Fetch16BitParameter()), "A, NN"); } break;
-	case 0xFB: // EI
-	{ EI(); } break;
-	case 0xFE: // CP N
-	{ CP(Fetch8BitParameter(), "N"); } break;
-	case 0xFF: //RST 0x38
-	{ RST(0x38); } break;
-	default:
-		assert(0);
-		break;
+	m_Cycles = 0;
+	ManageInterrupts();
+	if (m_IsHalted)
+	{
+		//only an event can wake the CPU up, skip straight to it in NOP steps
+		uint64 Remaining = m_Scheduler.GetNextDeadline() - m_FullCycles;
+		m_Cycles = static_cast<uint32>((Remaining + 3) & ~3ull);
+		m_FullCycles += m_Cycles;
+		goto Retire;
+	}
+
+	//native code is only entered at the start of a block
+	if (Native && !m_BootSequence && (m_NextOp->PC != PC) && RunNative())
+	{
+		m_FullCycles += m_Cycles;
+		goto Next;
+	}
+	goto *s_Labels[FetchInstruction()];
+
+#define GB_OPCODE(Code, ...) Label_##Code: __VA_ARGS__ GB_DISPATCH();
+#include "OpcodeTable.inl"
+#undef GB_OPCODE
+#undef GB_DISPATCH
+
+#else
+	//register writes can move deadlines earlier, so the next one is re-read every instruction
+	while (m_FullCycles < m_Scheduler.GetNextDeadline())
+	{
+		m_Cycles = 0;
+
+		ManageInterrupts();
+		if (m_IsHalted)
+		{
+			//only an event can wake the CPU up, skip straight to it in NOP steps
+			uint64 Remaining = m_Scheduler.GetNextDeadline() - m_FullCycles;
+			m_Cycles = static_cast<uint32>((Remaining + 3) & ~3ull);
+		}
+		else
+		{
+			(this->*s_OpcodeHandlers[FetchInstruction()])();
+		}
+
+		m_FullCycles += m_Cycles;
+		if (m_BootSequence)
+		{
+			CheckRegisters();
+		}
+	}
+#endif
+}
+
+void GameBoyCPU::InterpretSteps()
+{
+	while (m_FullCycles < m_Scheduler.GetNextDeadline())
+	{
+		m_Cycles = 0;
+
+		ManageInterrupts();
+		if (m_IsHalted)
+		{
+			uint64 Remaining = m_Scheduler.GetNextDeadline() - m_FullCycles;
+			m_Cycles = static_cast<uint32>((Remaining + 3) & ~3ull);
+		}
+		else
+		{
+			if (m_Trace != nullptr)
+			{
+				StoreFlags();
+				m_Trace->push_back({ m_FullCycles, PC, AF, BC, DE, HL, SP });
+			}
+
+			//native code is only entered at the start of a block
+			bool RanNative = m_Recompiler && !m_BootSequence && (m_NextOp->PC != PC) && RunNative();
+			if (!RanNative)
+			{
+				(this->*s_OpcodeHandlers[FetchInstruction()])();
+			}
+		}
+
+		m_FullCycles += m_Cycles;
+		if (m_BootSequence)
+		{
+			CheckRegisters();
+		}
+	}
+}
+
+bool GameBoyCPU::RunNative()
+{
+	GBDecodedBlock* Block = m_BlockCache.FindBlock(PC, false);
+	if ((Block == nullptr) || Block->NoNative)
+	{
+		return false;
+	}
+
+	if (Block->Native == nullptr)
+	{
+		if (++Block->Hits < GBRecompiler::HotBlockRuns)
+		{
+			return false;
+		}
+
+		if (m_Recompiler->IsFull())
+		{
+			//starting over is cheaper than tracking which blocks are still hot
+			FlushBlockCache();
+			return false;
+		}
+
+		if (!m_Recompiler->Compile(*Block))
+		{
+			Block->NoNative = true;
+			return false;
+		}
+	}
+
+	//events only run between steps, so the whole run has to fit before the next one
+	if (m_FullCycles + Block->NativeCycles > m_Scheduler.GetNextDeadline())
+	{
+		return false;
+	}
+
+	//native code works on F directly
+	StoreFlags();
+	GBJitContext Context = { AF, BC, DE, HL, SP, PC, 0, m_Memory.GetReadPages(), m_Memory.GetWritePages() };
+	uint32 Next = Block->Native(&Context);
+	AF = Context.AF;
+	LoadFlags();
+	BC = Context.BC;
+	DE = Context.DE;
+	HL = Context.HL;
+	SP = Context.SP;
+	PC = Context.PC;
+	m_Cycles = Context.Cycles;
+	m_NextOp = &Block->Ops[Next];
+
+	if (Next < Block->NativeOps)
+	{
+		//left before a memory access the native code can't make
+		if (++Block->SideExits >= GBRecompiler::MaxSideExits)
+		{
+			Block->Native = nullptr;
+			Block->NoNative = true;
+		}
 	}
 
+	//nothing ran if it left before the first op, the interpreter takes this step
+	return Next > 0;
 }
\ No newline at end of file
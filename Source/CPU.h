@@ -6,14 +6,39 @@
 #include "GBTimer.h"
 #include "GBSound.h"
 #include "MemoryModel.h"
+#include "ALUTables.h"
 #include "GPU.h"
 #include <vector>
 #include <memory.h>
 #include "Constants.h"
 #include "Input.h"
+#include "Platform.h"
+#include "FramePacer.h"
+#include "Scheduler.h"
+#include "SaveState.h"
+#include "Rewind.h"
+#include "BlockCache.h"
+#include "Recompiler.h"
+
+//Machine state at the start of an instruction, or of a run of native code
+struct GBTraceEntry
+{
+	uint64 Cycles;
+	uint16 PC;
+	uint16 AF;
+	uint16 BC;
+	uint16 DE;
+	uint16 HL;
+	uint16 SP;
+
+	bool operator==(const GBTraceEntry& Other) const
+	{
+		return (Cycles == Other.Cycles) && (PC == Other.PC) && (AF == Other.AF) && (BC == Other.BC)
+			&& (DE == Other.DE) && (HL == Other.HL) && (SP == Other.SP);
+	}
+};
 
-
-class GameBoyCPU
+class GameBoyCPU : public IEventHandler, public ICodeWatcher
 {
 public:
 	friend class GBRendering;
@@ -22,9 +47,76 @@ public:
 	GameBoyCPU();
 	~GameBoyCPU();
 
+	//Sinks must be set before TurnOn and outlive the CPU, null sinks run headless
+	void SetPlatform(const GBPlatform& platform);
+	const GBPlatform& GetPlatform() const { return m_Platform; }
+
+	//Run waits on this after every frame, nullptr restores the default real time pacer
+	void SetFramePacer(IFramePacer* Pacer);
+	FramePacer& GetDefaultPacer() { return m_DefaultPacer; }
+
+	//Paces the default pacer off the audio sink and bends the resampling ratio to hold the given latency,
+	//returns false if the sink cannot report its fill level. Call after SetPlatform
+	bool SetAudioSync(double LatencySeconds);
+
 	void TurnOn();
 	void SetCartridge(class Cartridge* cart);
 	void Run(bool SkipBootstrap);
+
+	//0 draws every frame, N draws one frame out of N + 1. Automatic skipping drops frames while the
+	//pacer reports running late. Timing, LY/STAT and interrupts are exact either way
+	void SetFrameSkip(uint32 Skip);
+	void SetAutoFrameSkip(bool Enabled);
+
+	//Draws on a separate thread. The video sink is then only called from PresentRenderedFrame, by the
+	//frontend thread while Run goes on another one. Set before TurnOn. GetFrameBuffer doesn't work in
+	//this mode, headless runs should leave it off
+	void SetThreadedRendering(bool Enabled) { m_ThreadedRendering = Enabled; }
+	//presents the newest frame the render thread finished, waiting up to WaitMilliseconds for one
+	bool PresentRenderedFrame(uint32 WaitMilliseconds);
+
+	//The APU keeps running for the game but synthesizes nothing, for headless runs that don't listen
+	void SetAudioMuted(bool Muted);
+
+	//Headless stepping: Boot once after TurnOn, then RunFrame returns after every emulated frame
+	void Boot(bool SkipBootstrap);
+	bool RunFrame();
+	//last frame the GPU finished at VBlank, ScreenData::SizeY rows of ScreenData::SizeX colors
+	const GBColor* GetFrameBuffer() const { return m_GBGPU->GetFrameBuffer(); }
+
+	//Whole machine snapshot, only between frames (after RunFrame returned) and after TurnOn.
+	//Loading fails and changes nothing if the cartridge RAM size doesn't match the inserted cartridge
+	void SaveState(GBSaveState& State) const;
+	bool LoadState(const GBSaveState& State);
+
+	//Run records a snapshot every frame into History and plays it back while the input source
+	//holds rewind. nullptr turns it off, the buffer must outlive Run
+	void SetRewindBuffer(GBRewindBuffer* History) { m_RewindBuffer = History; }
+
+	//Run-ahead: every frame is emulated, saved, then Frames more are run with the current input and
+	//only the last one is shown before restoring. Input shows up Frames frames earlier, at the
+	//cost of running Frames + 1 frames per frame. Audio only comes from the real frame
+	void SetRunAhead(uint32 Frames) { m_RunAheadFrames = Frames; }
+	bool RunFrameAhead();
+
+	//Translates hot blocks to native code on x86-64 builds, see Recompiler.h. Returns whether it is on,
+	//elsewhere the CPU keeps interpreting. Switch between frames
+	bool SetRecompiler(bool Enabled);
+	bool IsRecompiling() const { return m_Recompiler != nullptr; }
+
+	//Appends an entry before every instruction, or every native run with the recompiler on, so both
+	//can be compared step by step. nullptr stops tracing, the vector must outlive the frames run
+	void SetTrace(std::vector<GBTraceEntry>* Trace) { m_Trace = Trace; }
+
+	//Cycles elapsed up to the start of the instruction being executed
+	uint64 GetCycleCount() const { return m_FullCycles; }
+	//for tools watching the machine between frames
+	uint16 GetPC() const { return PC; }
+	bool AreInterruptsEnabled() const { return m_InterruptEnabled; }
+	GBScheduler& GetScheduler() { return m_Scheduler; }
+	virtual void OnEvent(uint8 EventId, uint64 Deadline, uint64 Now) override;
+	virtual void OnCodeWritten(uint16 Address) override;
+	virtual void OnPagesRemapped() override { m_NextOp = &GBBlockCache::s_EndOfBlock; }
 private:
 	//registers
 	//double registers are inverted to accommodate PC byte order
@@ -75,140 +167,213 @@ private:
 	uint16 PC = 0x100;
 	uint16 SP = 0;
 
+	//unpacked F, see PackFlags. Z is set while m_FlagZero is 0, H is bit 4 of m_FlagHalf
+	uint8 m_FlagZero = 1;
+	uint8 m_FlagHalf = 0;
+	bool m_FlagN = false;
+	bool m_FlagC = false;
+
 	class Cartridge* m_FitCartridge = nullptr;
 
-	void ExecutePC();
+	//runs instructions until the next scheduler deadline
+	void Interpret();
+	//same one step at a time, for tracing and the recompiler without computed goto
+	void InterpretSteps();
+	//runs the native code of the block at PC if there is any and it finishes before the deadline
+	bool RunNative();
+
+	//one handler per opcode, generated from OpcodeTable.inl and CBOpcodeTable.inl
+	using OpcodeHandler = void (GameBoyCPU::*)();
+	static const OpcodeHandler s_OpcodeHandlers[256];
+	static const OpcodeHandler s_CBOpcodeHandlers[256];
+#define GB_OPCODE(Code, ...) void Opcode_##Code();
+#include "OpcodeTable.inl"
+#undef GB_OPCODE
+#define GB_CB_OPCODE(Code, ...) void CBOpcode_##Code();
+#include "CBOpcodeTable.inl"
+#undef GB_CB_OPCODE
+
+	//instructions come pre-decoded from the block cache, operands are taken from the decoded op
+	//but still cost their read cycles
 	uint8 FetchInstruction()
 	{
-		uint8 instruction = ReadMemory(PC, true);
+		const GBDecodedOp* op = m_NextOp;
+		if (op->PC != PC)
+		{
+			op = DecodeAt(PC);
+		}
+
+		m_DecodedOp = op;
+		m_NextOp = op + 1;
 		PC++;
-		return instruction;
+		return op->Opcode;
 	}
+	const GBDecodedOp* DecodeAt(uint16 Address);
 
 	uint16 Fetch16BitParameter()
 	{
-		uint16 param;
-		uint8 low = ReadMemory(PC);
-		uint8 high = ReadMemory(PC + 1);
-
-		param = low + (high << 8);
+		m_Cycles += 8;
 		PC += 2;
-		return param;
+		return m_DecodedOp->Operand;
 	}
 	uint8 Fetch8BitParameter(bool skipCycles = false)
 	{
-		uint8 param = ReadMemory(PC, skipCycles);
+		if (!skipCycles)
+		{
+			m_Cycles += 4;
+		}
+
 		PC++;
-		return param;
+		return uint8(m_DecodedOp->Operand);
 	}
 
 	void Push(uint16 value);
 	uint16 Pull();
 
-	bool CheckHalfCarry(uint8 val1, uint8 val2);
-	bool CheckHalfCarry(uint16 val1, uint16 val2);
-
 	void ManageCBInstruction(uint8 secondPart);
 
+	//read-modify-write on (HL), the result goes back through WriteMemory so memory elements see it.
+	//Operations count the write cycle themselves
+	template<typename OPERATION>
+	void ModifyHL(OPERATION Operation)
+	{
+		uint8 Value = ReadMemory(HL);
+		Operation(Value);
+		WriteMemory(HL, Value, true);
+	}
+
 	template<typename TYPE>
 	bool Between(TYPE A, TYPE B, TYPE val)
 	{
 		return ((val >= A) && (val <= B));
 	}
 
+	//While instructions run the flags live unpacked in m_Flag*, F is only current outside the
+	//interpreter. ALU ops store what the flags are computed from, Z and H are only worked out when
+	//something tests them, most never are before the next op overwrites them
+	uint8 PackFlags() const
+	{
+		return (GetZ() ? EFlagMask::FZ : 0) | (GetN() ? EFlagMask::FN : 0) | (GetH() ? EFlagMask::FH : 0) |
+			(GetC() ? EFlagMask::FC : 0);
+	}
+
+	void StoreFlags()
+	{
+		F = PackFlags();
+	}
+
+	void LoadFlags()
+	{
+		m_FlagZero = (F & EFlagMask::FZ) ? 0 : 1;
+		m_FlagN = !!(F & EFlagMask::FN);
+		m_FlagHalf = (F & EFlagMask::FH) ? 0x10 : 0;
+		m_FlagC = !!(F & EFlagMask::FC);
+	}
+
+	//Z from the result of the op, N and C as they are, H from bit 4 of operand ^ operand ^ result
+	void SetFlagsResult(uint8 Result, bool N, uint8 Half, bool Carry)
+	{
+		m_FlagZero = Result;
+		m_FlagN = N;
+		m_FlagHalf = Half;
+		m_FlagC = Carry;
+	}
+
 	void SetFlagZ()
 	{
-		F |= 0x80;
+		m_FlagZero = 0;
 	}
 
 	void SetFlagN()
 	{
-		F |= 0x40;
+		m_FlagN = true;
 	}
 
 	void SetFlagH()
 	{
-		F |= 0x20;
+		m_FlagHalf = 0x10;
 	}
 
 	void SetFlagC()
 	{
-		F |= 0x10;
+		m_FlagC = true;
 	}
 
 	void ResetFlagZ()
 	{
-		F &= ~0x80;
+		m_FlagZero = 1;
 	}
 
 	void ResetFlagN()
 	{
-		F &= ~0x40;
+		m_FlagN = false;
 	}
 
 	void ResetFlagH()
 	{
-		F &= ~0x20;
+		m_FlagHalf = 0;
 	}
 
 	void ResetFlagC()
 	{
-		F &= ~0x10;
-	}
-
-	bool GetZ()
-	{
-		return F & EFlagMask::FZ;
-	}
-
-	bool GetN()
-	{
-		return F & EFlagMask::FN;
+		m_FlagC = false;
 	}
 
-	bool GetH()
+	bool GetZ() const
 	{
-		return F & EFlagMask::FH;
+		return m_FlagZero == 0;
 	}
 
-	bool GetC()
+	bool GetN() const
 	{
-		return F & EFlagMask::FC;
+		return m_FlagN;
 	}
 
-	void SetFlags(uint8 mask)
+	bool GetH() const
 	{
-		F |= mask;
+		return !!(m_FlagHalf & 0x10);
 	}
 
-	void ResetFlags(uint8 mask)
+	bool GetC() const
 	{
-		F &= ~mask;
+		return m_FlagC;
 	}
 
-	bool GetFlag(uint8 mask)
+	bool GetFlag(uint8 mask) const
 	{
-		return !!(F & mask);
+		switch (mask)
+		{
+		case EFlagMask::FZ:
+			return GetZ();
+		case EFlagMask::FN:
+			return GetN();
+		case EFlagMask::FH:
+			return GetH();
+		case EFlagMask::FC:
+			return GetC();
+		default:
+			return !!(PackFlags() & mask);
+		}
 	}
 
 	void SetValZ(bool val)
 	{
-		val ? SetFlagZ() : ResetFlagZ();
+		m_FlagZero = val ? 0 : 1;
 	}
 
 	void SetValN(bool val)
 	{
-		val ? SetFlagN() : ResetFlagN();
+		m_FlagN = val;
 	}
 
 	void SetValH(bool val)
 	{
-		val ? SetFlagH() : ResetFlagH();
+		m_FlagHalf = val ? 0x10 : 0;
 	}
 
 	void SetValC(bool val)
 	{
-		val ? SetFlagC() : ResetFlagC();
+		m_FlagC = val;
 	}
 
 private:
@@ -216,6 +381,10 @@ private:
 	void RenderScanline();
 	void CheckRegisters();
 	void ManageInterrupts();
+	//once per frame in Run, before the frame
+	void UpdateRewind();
+	//after memory changed behind the cache's back
+	void FlushBlockCache();
 
 public:
 	__forceinline uint8& ReadMemory(uint16 address, bool skipCycles = false);
@@ -223,6 +392,7 @@ public:
 
 	GameBoyMemory m_Memory;
 	std::unique_ptr<GPU> m_GBGPU;
+	std::unique_ptr<GBRenderThread> m_RenderThread;
 
 	void FireInterrupt(uint8 InterruptCode);
 
@@ -303,6 +473,8 @@ private:
 	__forceinline void STOP();
 
 	//CB instructions
+	//result and carry of the rotates, shifts and SWAP from ALUTables, N and H cleared
+	__forceinline void ShiftALU(ALUTables::EShift Operation, uint8& Value);
 	__forceinline void SRL_8BIT(uint8& OutVal, int AdditionalCycles = 0);
 	__forceinline void RL_8BIT(uint8& OutVal, int AdditionalCycles = 0);
 	__forceinline void RR_8BIT(uint8& OutVal, int AdditionalCycles = 0);
@@ -315,7 +487,6 @@ private:
 
 	//DEBUG
 	uint64 m_FullCycles = 0;
-	uint32 m_FrameCycles = 0;
 	bool m_EnableDebug = false;
 	std::string FlagsToString();
 	std::string RegistersToString();
@@ -324,15 +495,78 @@ private:
 	void DebugExecution(const std::string& Instruction, int8 EightBitParam);
 	void DebugExecution(const std::string& Instruction, uint16 SixteenBitParam);
 
+	//components schedule their next state change here, the CPU runs straight until the earliest one
+	GBScheduler m_Scheduler;
+	bool m_FrameDone = false;
+
+	GBBlockCache m_BlockCache{ m_Memory };
+	//next op of the block being run, and the op executing now
+	const GBDecodedOp* m_NextOp = &GBBlockCache::s_EndOfBlock;
+	const GBDecodedOp* m_DecodedOp = &GBBlockCache::s_EndOfBlock;
+	//code the cache doesn't keep is decoded here one instruction at a time
+	GBDecodedOp m_UncachedOp[2] = {};
+
+	std::unique_ptr<GBRecompiler> m_Recompiler;
+	std::vector<GBTraceEntry>* m_Trace = nullptr;
+
 	//Timer
 	std::unique_ptr<GBTimer> m_GameboyTimer;
 	std::unique_ptr<GBInput> m_GameboyInput;
 	std::unique_ptr<GBSound> m_GameboySound;
 
+	GBPlatform m_Platform;
+	SteadyClock m_DefaultClock;
+	FramePacer m_DefaultPacer;
+	IFramePacer* m_FramePacer = nullptr;
+	uint32 m_AudioSyncTarget = 0;
+	uint32 m_FrameSkip = 0;
+	bool m_AutoFrameSkip = false;
+	bool m_ThreadedRendering = false;
+	bool m_AudioMuted = false;
+
+	GBRewindBuffer* m_RewindBuffer = nullptr;
+	GBSaveState m_RewindState;
+	uint32 m_RunAheadFrames = 0;
+	GBSaveState m_RunAheadState;
+
 	//PERFORMANCE
 	Timer m_RenderScanTimer;
 };
 
+inline uint8& GameBoyCPU::ReadMemory(uint16 address, bool skipCycles)
+{
+	if (!skipCycles)
+	{
+		m_Cycles += 4;
+	}
+	
+	if (m_BootSequence)
+	{
+		if (Between<uint16>(0x0000, 0x00ff, address))
+		{
+			return s_Firmware[address];
+		}
+		else
+		{
+			return m_Memory.Read(address);
+		}
+	}
+	else
+	{
+		return m_Memory.Read(address);
+	}
+}
+
+inline void GameBoyCPU::WriteMemory(uint16 address, uint8 value, bool skipCycles)
+{
+	if (!skipCycles)
+	{
+		m_Cycles += 4;
+	}
+
+	m_Memory.Write(address, value);
+}
+
 #define ENABLE_DEBUGTEXT 0
 
 #if DEBUG && ENABLE_DEBUGTEXT
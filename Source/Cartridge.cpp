@@ -1,5 +1,5 @@
 #include "Cartridge.h"
-#include <sys/stat.h>
+#include <fstream>
 
 Cartridge::~Cartridge()
 {
@@ -9,23 +9,29 @@ Cartridge::~Cartridge()
 
 void Cartridge::LoadFile(const std::string& filename)
 {
-	struct _stat stat_buf;
-	int rc = _stat(filename.c_str(), &stat_buf);
-	if (rc == 0)
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (file)
 	{
-		FILE *f = nullptr;
-		if (fopen_s(&f, filename.c_str(), TEXT("rb")) == 0)
-		{
-			m_Data = std::make_unique<uint8[]>(stat_buf.st_size);
-
-			fread_s(m_Data.get(), stat_buf.st_size, stat_buf.st_size, 1, f);
-			fclose(f);
+		std::streamsize size = file.tellg();
+		file.seekg(0, std::ios::beg);
 
+		m_Data = std::shared_ptr<uint8[]>(new uint8[size_t(size)]);
+		if (file.read(reinterpret_cast<char*>(m_Data.get()), size))
+		{
 			InitMBC();
 		}
 	}
 }
 
+void Cartridge::ShareROM(const Cartridge& Source)
+{
+	m_Data = Source.m_Data;
+	if (m_Data)
+	{
+		InitMBC();
+	}
+}
+
 void Cartridge::InitMBC()
 {
 	Type = CartrigeType(m_Data[MBCAddresses::CartridgeType]);
@@ -36,22 +42,31 @@ void Cartridge::InitMBC()
 	switch (RamSize)
 	{
 	case CartridgeRAMSize::_2KB:
-		m_RAM = std::make_unique<uint8[]>(2 * 1024);
+		m_RAMSize = 2 * 1024;
 		break;
 	case CartridgeRAMSize::_8KB:
-		m_RAM = std::make_unique<uint8[]>(8 * 1024);
+		m_RAMSize = 8 * 1024;
 		break;
 	case CartridgeRAMSize::_32KB:
-		m_RAM = std::make_unique<uint8[]>(32 * 1024);
+		m_RAMSize = 32 * 1024;
 		break;
 	case CartridgeRAMSize::_128KB:
-		m_RAM = std::make_unique<uint8[]>(128 * 1024);
+		m_RAMSize = 128 * 1024;
 		break;
 	default:
-		m_RAM.reset();
+		m_RAMSize = 0;
 		break;
 	}
 
+	if (m_RAMSize > 0)
+	{
+		m_RAM = std::make_unique<uint8[]>(m_RAMSize);
+	}
+	else
+	{
+		m_RAM.reset();
+	}
+
 	switch (Type)
 	{
 	case CartrigeType::ROMOnly:
@@ -65,7 +80,8 @@ void Cartridge::InitMBC()
 
 	case CartrigeType::ROM_MBC2:
 	case CartrigeType::ROM_MBC2_BATTERY:
-		m_RAM = std::make_unique<uint8[]>(0x200);
+		m_RAMSize = 0x200;
+		m_RAM = std::make_unique<uint8[]>(m_RAMSize);
 		m_MBC = std::make_unique<MEM_MBC2>(m_Data.get(), m_RAM.get());
 		break;
 
@@ -76,4 +92,38 @@ void Cartridge::InitMBC()
 	default:
 		break;
 	}
+}
+
+void Cartridge::SaveState(GBSaveState& State) const
+{
+	memset(&State.Machine.Cartridge, 0, sizeof(GBCartridgeState));
+	if (m_MBC)
+	{
+		m_MBC->SaveState(State.Machine.Cartridge);
+	}
+
+	State.CartridgeRAM.resize(m_RAMSize);
+	if (m_RAMSize > 0)
+	{
+		memcpy(State.CartridgeRAM.data(), m_RAM.get(), m_RAMSize);
+	}
+}
+
+bool Cartridge::LoadState(const GBSaveState& State)
+{
+	if (State.CartridgeRAM.size() != m_RAMSize)
+	{
+		return false;
+	}
+
+	if (m_RAMSize > 0)
+	{
+		memcpy(m_RAM.get(), State.CartridgeRAM.data(), m_RAMSize);
+	}
+
+	if (m_MBC)
+	{
+		m_MBC->LoadState(State.Machine.Cartridge);
+	}
+	return true;
 }
\ No newline at end of file
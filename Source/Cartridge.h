@@ -66,7 +66,11 @@ public:
 	~Cartridge();
 
 	void LoadFile(const std::string& filename);
+	//same ROM as Source without copying it, RAM and bank registers are this cartridge's own
+	void ShareROM(const Cartridge& Source);
 	uint8* GetData() { return m_Data.get(); }
+	//false if the file couldn't be read or its MBC isn't supported
+	bool IsLoaded() const { return m_MBC != nullptr; }
 
 	//Cartrige data
 	CartrigeType Type = CartrigeType::ROMOnly;
@@ -75,6 +79,10 @@ public:
 
 	void InitMBC();
 
+	//bank registers and cartridge RAM, loading fails if the RAM size doesn't match this cartridge
+	void SaveState(GBSaveState& State) const;
+	bool LoadState(const GBSaveState& State);
+
 	virtual uint8& ReadMemory(uint16 address) override
 	{
 		return m_MBC->ReadMemory(address);
@@ -85,9 +93,19 @@ public:
 		m_MBC->WriteMemory(address, value);
 	}
 
+	virtual void MapPages(GameBoyMemory* Memory) override
+	{
+		if (m_MBC)
+		{
+			m_MBC->BindPages(Memory, this);
+		}
+	}
+
 
 private:
-	std::unique_ptr<uint8[]> m_Data;
+	//ROM is read only, cartridges running the same game share it
+	std::shared_ptr<uint8[]> m_Data;
 	std::unique_ptr<uint8[]> m_RAM;
+	uint32 m_RAMSize = 0;
 	std::unique_ptr<IROMMemoryModel> m_MBC;
 };
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "CompositorCheck.h"
+#include "LineCompositor.h"
+#include "Rendering.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace
+{
+	struct CompositorPath
+	{
+		const char* Name;
+		void (*DecodeTile)(const uint8* TileData, uint8* Indices);
+		void (*ApplyPalette)(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count);
+		void (*DrawSpriteRow)(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out);
+	};
+
+	//all compared against the scalar functions, "selected" is what the renderer calls
+	const CompositorPath s_Paths[] =
+	{
+#if GB_SIMD_SSE2
+		{ "SSE2", &LineCompositor::DecodeTileSSE2, &LineCompositor::ApplyPaletteSSE2, &LineCompositor::DrawSpriteRowSSE2 },
+#endif
+#if GB_SIMD_AVX2
+		{ "AVX2", &LineCompositor::DecodeTileSSE2, &LineCompositor::ApplyPaletteAVX2, &LineCompositor::DrawSpriteRowAVX2 },
+#endif
+		{ "selected", &LineCompositor::DecodeTile, &LineCompositor::ApplyPalette, &LineCompositor::DrawSpriteRow },
+	};
+
+	//pixels past the end of a run must come back untouched
+	static constexpr int32 GuardPixels = 16;
+	static constexpr int32 MaxRun = ScreenData::SizeX + 16;
+	static constexpr uint32 PaletteRuns = 200000;
+
+	GBColor RandomColor(std::mt19937& Random)
+	{
+		//alpha too, the vector paths move whole 32 bit lanes
+		uint32 Lane = Random();
+		GBColor Color;
+		Color.A = uint8(Lane);
+		Color.B = uint8(Lane >> 8);
+		Color.G = uint8(Lane >> 16);
+		Color.R = uint8(Lane >> 24);
+		return Color;
+	}
+
+	void RandomPalette(std::mt19937& Random, GBColor* Palette)
+	{
+		for (int32 i = 0; i < 4; ++i)
+		{
+			Palette[i] = RandomColor(Random);
+		}
+	}
+
+	//false once a path has reported this many mismatches, the rest of that check is skipped
+	bool Report(uint32& Failures, const char* Path, const char* Function, const char* Detail)
+	{
+		fprintf(stderr, "%s %s mismatch: %s\n", Path, Function, Detail);
+		return ++Failures < 8;
+	}
+
+	uint32 CheckDecodeTile(const CompositorPath& Path)
+	{
+		//every row position sees every low/high bitplane pair
+		uint32 Failures = 0;
+		for (uint32 Value = 0; Value < 0x10000; ++Value)
+		{
+			uint8 Tile[16];
+			for (uint32 Row = 0; Row < 8; ++Row)
+			{
+				uint16 RowValue = uint16(Value + Row * 0x2F3B);
+				Tile[Row * 2] = uint8(RowValue);
+				Tile[Row * 2 + 1] = uint8(RowValue >> 8);
+			}
+
+			uint8 Expected[64];
+			uint8 Actual[64];
+			LineCompositor::DecodeTileScalar(Tile, Expected);
+			Path.DecodeTile(Tile, Actual);
+			if (memcmp(Expected, Actual, sizeof(Expected)) != 0)
+			{
+				char Detail[64];
+				snprintf(Detail, sizeof(Detail), "tile %04x", Value);
+				if (!Report(Failures, Path.Name, "DecodeTile", Detail))
+				{
+					break;
+				}
+			}
+		}
+		return Failures;
+	}
+
+	uint32 CheckApplyPalette(const CompositorPath& Path)
+	{
+		std::mt19937 Random(0x6B43);
+		uint32 Failures = 0;
+		for (uint32 Run = 0; Run < PaletteRuns; ++Run)
+		{
+			//every length up to a little over a line, then random ones
+			int32 Count = (Run <= uint32(MaxRun)) ? int32(Run) : int32(Random() % (MaxRun + 1));
+			uint8 Indices[MaxRun];
+			for (int32 i = 0; i < Count; ++i)
+			{
+				Indices[i] = uint8(Random() & 0x03);
+			}
+
+			GBColor Palette[4];
+			RandomPalette(Random, Palette);
+
+			GBColor Expected[MaxRun + GuardPixels];
+			for (int32 i = 0; i < MaxRun + GuardPixels; ++i)
+			{
+				Expected[i] = RandomColor(Random);
+			}
+			GBColor Actual[MaxRun + GuardPixels];
+			memcpy(Actual, Expected, sizeof(Actual));
+
+			LineCompositor::ApplyPaletteScalar(Indices, Palette, Expected, Count);
+			Path.ApplyPalette(Indices, Palette, Actual, Count);
+			if (memcmp(Expected, Actual, sizeof(Expected)) != 0)
+			{
+				char Detail[64];
+				snprintf(Detail, sizeof(Detail), "run %u of %d pixels", Run, Count);
+				if (!Report(Failures, Path.Name, "ApplyPalette", Detail))
+				{
+					break;
+				}
+			}
+		}
+		return Failures;
+	}
+
+	uint32 CheckDrawSpriteRow(const CompositorPath& Path)
+	{
+		//all 4^8 sprite rows, in front of the background and behind every mask of background color 0
+		std::mt19937 Random(0x5B12);
+		uint32 Failures = 0;
+		for (uint32 Pattern = 0; Pattern < 0x10000; ++Pattern)
+		{
+			uint8 Indices[8];
+			for (int32 X = 0; X < 8; ++X)
+			{
+				Indices[X] = uint8((Pattern >> (X * 2)) & 0x03);
+			}
+
+			GBColor Palette[4];
+			RandomPalette(Random, Palette);
+			GBColor Line[8 + GuardPixels];
+			for (int32 i = 0; i < 8 + GuardPixels; ++i)
+			{
+				Line[i] = RandomColor(Random);
+			}
+
+			//0x100 is the sprite in front, where the background doesn't matter
+			for (uint32 Mask = 0; Mask <= 0x100; ++Mask)
+			{
+				bool BehindBG = Mask < 0x100;
+				uint8 BGIndices[8];
+				for (int32 X = 0; X < 8; ++X)
+				{
+					BGIndices[X] = ((Mask >> X) & 1) ? uint8(1 + (Random() % 3)) : 0;
+				}
+
+				GBColor Expected[8 + GuardPixels];
+				GBColor Actual[8 + GuardPixels];
+				memcpy(Expected, Line, sizeof(Line));
+				memcpy(Actual, Line, sizeof(Line));
+
+				LineCompositor::DrawSpriteRowScalar(Indices, Palette, BehindBG, BGIndices, Expected);
+				Path.DrawSpriteRow(Indices, Palette, BehindBG, BGIndices, Actual);
+				if (memcmp(Expected, Actual, sizeof(Expected)) != 0)
+				{
+					char Detail[64];
+					snprintf(Detail, sizeof(Detail), "row %04x, background mask %03x", Pattern, Mask);
+					if (!Report(Failures, Path.Name, "DrawSpriteRow", Detail))
+					{
+						return Failures;
+					}
+				}
+			}
+		}
+		return Failures;
+	}
+}
+
+bool RunCompositorCheck()
+{
+	uint32 Failures = 0;
+	for (const CompositorPath& Path : s_Paths)
+	{
+		uint32 PathFailures = CheckDecodeTile(Path) + CheckApplyPalette(Path) + CheckDrawSpriteRow(Path);
+		fprintf(stderr, "%-8s %s\n", Path.Name, (PathFailures == 0) ? "matches scalar" : "MISMATCH");
+		Failures += PathFailures;
+	}
+
+#if !GB_SIMD_AVX2
+	fprintf(stderr, "AVX2 path not built, compile with AVX2 enabled to check it\n");
+#endif
+	return Failures == 0;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "Types.h"
+
+//Runs the scalar line compositor and every vector path this build has on the same inputs: all tile
+//rows, all sprite rows against all background masks and random palette runs. Mismatches go to stderr
+bool RunCompositorCheck();
\ No newline at end of file
@@ -83,7 +83,6 @@ namespace MemAreas
 namespace Timings
 {
 	static constexpr uint32 GBClockSpeed = 4194304;
-	static constexpr float GBClockTime = 1.0f / float(GBClockSpeed);
 	static constexpr uint32 VBlankCycles = 456;
 	static constexpr uint32 HBlankCycles = 204;
 	static constexpr uint32 ReadingOAMCycles = 80;
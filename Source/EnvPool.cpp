@@ -0,0 +1,182 @@
+#include "EnvPool.h"
+#include <algorithm>
+
+GBEnvPool::~GBEnvPool()
+{
+	StopWorkers();
+}
+
+bool GBEnvPool::Init(const std::string& RomPath, const GBEnvConfig& Config)
+{
+	StopWorkers();
+	m_Envs.clear();
+
+	uint32 Count = std::max(Config.Count, 1u);
+	m_FramesPerStep = std::max(Config.FramesPerStep, 1u);
+
+	for (uint32 i = 0; i < Count; ++i)
+	{
+		std::unique_ptr<Env> NewEnv = std::make_unique<Env>();
+		if (i == 0)
+		{
+			NewEnv->Cart.LoadFile(RomPath);
+		}
+		else
+		{
+			NewEnv->Cart.ShareROM(m_Envs[0]->Cart);
+		}
+
+		if (!NewEnv->Cart.IsLoaded())
+		{
+			m_Envs.clear();
+			return false;
+		}
+
+		GBPlatform Platform;
+		Platform.Input = &NewEnv->Input;
+		NewEnv->CPU.SetPlatform(Platform);
+		NewEnv->CPU.SetCartridge(&NewEnv->Cart);
+		NewEnv->CPU.SetAudioMuted(Config.MuteAudio);
+		NewEnv->CPU.TurnOn();
+		m_Envs.push_back(std::move(NewEnv));
+	}
+
+	//boot once, every instance starts from a copy
+	GameBoyCPU& First = m_Envs[0]->CPU;
+	First.Boot(Config.SkipBootstrap);
+	First.SaveState(m_InitialState);
+	m_InitialFrame.assign(First.GetFrameBuffer(), First.GetFrameBuffer() + FrameSize);
+
+	m_Frames.assign(size_t(Count) * FrameSize, GBColor());
+	m_RAM.assign(size_t(Count) * RAMSize, 0);
+
+	uint32 Threads = (Config.Threads > 0) ? Config.Threads : std::max(std::thread::hardware_concurrency(), 1u);
+	Threads = std::min(Threads, Count);
+	m_Stopping = false;
+	for (uint32 i = 1; i < Threads; ++i)
+	{
+		m_Workers.emplace_back(&GBEnvPool::WorkerMain, this);
+	}
+
+	ResetAll();
+	return true;
+}
+
+void GBEnvPool::Reset(uint32 Index)
+{
+	GameBoyCPU& CPU = m_Envs[Index]->CPU;
+	CPU.LoadState(m_InitialState);
+	//not Publish, the instance still holds the last frame of the previous episode
+	memcpy(&m_Frames[size_t(Index) * FrameSize], m_InitialFrame.data(), FrameSize * sizeof(GBColor));
+	memcpy(&m_RAM[size_t(Index) * RAMSize], CPU.m_Memory.GetInternalRAM(), RAMSize);
+}
+
+void GBEnvPool::ResetAll()
+{
+	ParallelFor([this](uint32 Index) { Reset(Index); });
+}
+
+void GBEnvPool::Step(const GBEnvAction* Actions)
+{
+	for (uint32 i = 0; i < GetCount(); ++i)
+	{
+		m_Envs[i]->Input.m_Action = Actions[i];
+	}
+
+	ParallelFor([this](uint32 Index) { StepEnv(Index); });
+}
+
+void GBEnvPool::StepEnv(uint32 Index)
+{
+	GameBoyCPU& CPU = m_Envs[Index]->CPU;
+	GBRendering& Rendering = CPU.m_GBGPU->GetRendering();
+
+	for (uint32 Frame = 0; Frame < m_FramesPerStep; ++Frame)
+	{
+		Rendering.SetPresentSuppressed(Frame + 1 < m_FramesPerStep);
+		CPU.RunFrame();
+	}
+
+	Publish(Index);
+}
+
+void GBEnvPool::Publish(uint32 Index)
+{
+	GameBoyCPU& CPU = m_Envs[Index]->CPU;
+	memcpy(&m_Frames[size_t(Index) * FrameSize], CPU.GetFrameBuffer(), FrameSize * sizeof(GBColor));
+	memcpy(&m_RAM[size_t(Index) * RAMSize], CPU.m_Memory.GetInternalRAM(), RAMSize);
+}
+
+void GBEnvPool::ParallelFor(const std::function<void(uint32)>& Job)
+{
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_Job = &Job;
+		m_NextIndex.store(0, std::memory_order_relaxed);
+		m_BusyWorkers = uint32(m_Workers.size());
+		m_Generation++;
+	}
+	m_WorkReady.notify_all();
+
+	RunJobs(Job);
+
+	//not only every instance done: every worker has to be out of RunJobs before the job and the
+	//index are reused, a late one would otherwise take an index of the next generation
+	std::unique_lock<std::mutex> Lock(m_Mutex);
+	m_WorkDone.wait(Lock, [this]() { return m_BusyWorkers == 0; });
+	m_Job = nullptr;
+}
+
+void GBEnvPool::RunJobs(const std::function<void(uint32)>& Job)
+{
+	//instances are handed out one at a time, a slow one doesn't hold up a whole slice
+	uint32 Count = GetCount();
+	uint32 Index;
+	while ((Index = m_NextIndex.fetch_add(1, std::memory_order_relaxed)) < Count)
+	{
+		Job(Index);
+	}
+}
+
+void GBEnvPool::WorkerMain()
+{
+	uint64 SeenGeneration = 0;
+	while (true)
+	{
+		const std::function<void(uint32)>* Job = nullptr;
+		{
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			m_WorkReady.wait(Lock, [&]() { return m_Stopping || (m_Generation != SeenGeneration); });
+			if (m_Stopping)
+			{
+				return;
+			}
+			SeenGeneration = m_Generation;
+			Job = m_Job;
+		}
+
+		RunJobs(*Job);
+
+		//the lock also hands this worker's instance results over to the thread in ParallelFor
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		if (--m_BusyWorkers == 0)
+		{
+			m_WorkDone.notify_all();
+		}
+	}
+}
+
+void GBEnvPool::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_WorkReady.notify_all();
+
+	for (std::thread& Worker : m_Workers)
+	{
+		Worker.join();
+	}
+	m_Workers.clear();
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Types.h"
+#include "Platform.h"
+#include "CPU.h"
+#include "Cartridge.h"
+#include "SaveState.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct GBEnvAction
+{
+	//JOYPAD_INPUT_* and JOYPAD_BUTTONS_* bits held for the whole step
+	uint8 Joypad = JOYPAD_NONE;
+	uint8 Buttons = JOYPAD_NONE;
+};
+
+struct GBEnvConfig
+{
+	uint32 Count = 1;
+	//0 uses every hardware thread, the calling thread counts as one of them
+	uint32 Threads = 0;
+	//frames emulated per Step with the same action, only the last one is presented
+	uint32 FramesPerStep = 1;
+	bool SkipBootstrap = true;
+	//headless instances usually don't listen, a muted APU costs next to nothing
+	bool MuteAudio = true;
+};
+
+//Batch of headless instances of one game for training agents. Step advances every instance by
+//one step on a worker pool and leaves all frames, then all internal RAM, in two contiguous arrays
+class GBEnvPool
+{
+public:
+	static constexpr uint32 FrameSize = ScreenData::SizeX * ScreenData::SizeY;
+	static constexpr uint32 RAMSize = GameBoyMemory::InternalRAMSize;
+
+	GBEnvPool() = default;
+	~GBEnvPool();
+
+	//false if the ROM can't be loaded. Instances share the ROM and start from the same booted state
+	bool Init(const std::string& RomPath, const GBEnvConfig& Config);
+
+	//Actions holds one entry per instance
+	void Step(const GBEnvAction* Actions);
+	//Back to the booted state, takes effect for the next Step. The frame buffer isn't part of a save
+	//state, the instance's slot gets the frame saved right after booting instead
+	void Reset(uint32 Index);
+	void ResetAll();
+
+	uint32 GetCount() const { return uint32(m_Envs.size()); }
+	//GetCount() frames of FrameSize colors, as of the last Step
+	const GBColor* GetFrames() const { return m_Frames.data(); }
+	//GetCount() copies of 0xC000-0xDFFF, as of the last Step
+	const uint8* GetRAM() const { return m_RAM.data(); }
+	GameBoyCPU& GetCPU(uint32 Index) { return m_Envs[Index]->CPU; }
+
+private:
+	class EnvInput : public IInputSource
+	{
+	public:
+		virtual void GetInputState(uint8& Joypad, uint8& Buttons) override
+		{
+			Joypad = m_Action.Joypad;
+			Buttons = m_Action.Buttons;
+		}
+		virtual bool PollEvents() override { return true; }
+
+		GBEnvAction m_Action;
+	};
+
+	struct Env
+	{
+		Cartridge Cart;
+		GameBoyCPU CPU;
+		EnvInput Input;
+	};
+
+	void StepEnv(uint32 Index);
+	void Publish(uint32 Index);
+
+	//runs Job for every instance on the workers and the calling thread, returns when all are done
+	void ParallelFor(const std::function<void(uint32)>& Job);
+	void WorkerMain();
+	void RunJobs(const std::function<void(uint32)>& Job);
+	void StopWorkers();
+
+	std::vector<std::unique_ptr<Env>> m_Envs;
+	GBSaveState m_InitialState;
+	std::vector<GBColor> m_InitialFrame;
+	uint32 m_FramesPerStep = 1;
+
+	std::vector<GBColor> m_Frames;
+	std::vector<uint8> m_RAM;
+
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkReady;
+	std::condition_variable m_WorkDone;
+	//job, generation and busy count only change under m_Mutex
+	const std::function<void(uint32)>* m_Job = nullptr;
+	uint64 m_Generation = 0;
+	uint32 m_BusyWorkers = 0;
+	bool m_Stopping = false;
+	std::atomic<uint32> m_NextIndex{ 0 };
+};
\ No newline at end of file
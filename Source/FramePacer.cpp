@@ -0,0 +1,92 @@
+#include "FramePacer.h"
+#include <chrono>
+#include <thread>
+
+void FramePacer::SetMode(EPacingMode Mode, double SpeedMultiplier)
+{
+	m_Mode = Mode;
+	m_SpeedMultiplier = (SpeedMultiplier > 0.0) ? SpeedMultiplier : 1.0;
+	Reset();
+}
+
+double FramePacer::GetFrameTime() const
+{
+	return (m_Mode == EPacingMode::Multiplier) ? FrameTime / m_SpeedMultiplier : FrameTime;
+}
+
+void FramePacer::Reset()
+{
+	if (m_Clock != nullptr)
+	{
+		m_NextFrameTime = m_Clock->GetSeconds() + GetFrameTime();
+	}
+}
+
+void FramePacer::SetAudioSink(IAudioSink* Sink, uint32 TargetSamples)
+{
+	m_AudioSink = Sink;
+	m_AudioTarget = TargetSamples;
+}
+
+bool FramePacer::WaitForAudio()
+{
+	if ((m_AudioSink == nullptr) || (m_AudioSink->GetBufferCapacity() == 0) || (m_AudioTarget == 0))
+	{
+		return false;
+	}
+
+	double SampleRate = double(m_AudioSink->GetSampleRate());
+	double Waited = 0.0;
+
+	//no spinning: sleep for as long as the device needs to play the excess, then check again
+	uint32 Fill = m_AudioSink->GetBufferedSamples();
+	m_IsBehind = Fill < (m_AudioTarget / 2);
+	while ((Fill > m_AudioTarget) && (Waited < MaxLag))
+	{
+		double Excess = double(Fill - m_AudioTarget) / SampleRate;
+		std::this_thread::sleep_for(std::chrono::duration<double>(Excess));
+		Waited += Excess;
+
+		Fill = m_AudioSink->GetBufferedSamples();
+	}
+
+	return true;
+}
+
+void FramePacer::WaitForNextFrame()
+{
+	m_IsBehind = false;
+	if ((m_Mode == EPacingMode::Unthrottled) || (m_Clock == nullptr))
+	{
+		return;
+	}
+
+	if ((m_Mode == EPacingMode::AudioSync) && WaitForAudio())
+	{
+		return;
+	}
+
+	double Now = m_Clock->GetSeconds();
+	double Remaining = m_NextFrameTime - Now;
+	m_IsBehind = Remaining < -0.5 * GetFrameTime();
+
+	//sleep for the bulk of the wait, then spin for the last bit
+	if (Remaining > SpinThreshold)
+	{
+		std::this_thread::sleep_for(std::chrono::duration<double>(Remaining - SpinThreshold));
+	}
+
+	while (m_Clock->GetSeconds() < m_NextFrameTime)
+	{
+		std::this_thread::yield();
+	}
+
+	//deadlines are accumulated so rounding errors don't drift
+	m_NextFrameTime += GetFrameTime();
+
+	Now = m_Clock->GetSeconds();
+	if ((Now - m_NextFrameTime) > MaxLag)
+	{
+		m_NextFrameTime = Now + GetFrameTime();
+	}
+}
\ No newline at end of file
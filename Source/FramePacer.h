@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Types.h"
+#include "Platform.h"
+#include "Constants.h"
+
+enum class EPacingMode : uint8
+{
+	RealTime,		// one emulated frame per real frame time
+	Unthrottled,	// no waiting at all, as fast as the host can go
+	Multiplier,		// real time scaled by a fixed speed multiplier
+	AudioSync		// sleeps until the audio sink drained down to its target fill level
+};
+
+class IFramePacer
+{
+public:
+	virtual ~IFramePacer() = default;
+
+	//called once before the first frame
+	virtual void Reset() = 0;
+	//called after every emulated frame, returns once the next one is due
+	virtual void WaitForNextFrame() = 0;
+	//true when the last wait found the emulation running late, drives automatic frame skipping
+	virtual bool IsBehindSchedule() const { return false; }
+};
+
+class FramePacer : public IFramePacer
+{
+public:
+	//Real frame time of the DMG, 70224 cycles at 4.19 MHz (~59.73 Hz)
+	static constexpr double FrameTime = double(Timings::FrameCycles) / double(Timings::GBClockSpeed);
+	//Below this we spin instead of sleeping, the OS scheduler is not precise enough
+	static constexpr double SpinThreshold = 0.002;
+	//If we fall behind by more than this, drop the backlog instead of rushing to catch up
+	static constexpr double MaxLag = 0.1;
+
+	FramePacer(IClock* Clock = nullptr) : m_Clock(Clock) {}
+
+	void SetClock(IClock* Clock) { m_Clock = Clock; }
+	void SetMode(EPacingMode Mode, double SpeedMultiplier = 1.0);
+	EPacingMode GetMode() const { return m_Mode; }
+
+	//AudioSync needs a sink that reports its fill level, otherwise it falls back to real time
+	void SetAudioSink(IAudioSink* Sink, uint32 TargetSamples);
+
+	virtual void Reset() override;
+	virtual void WaitForNextFrame() override;
+	virtual bool IsBehindSchedule() const override { return m_IsBehind; }
+
+private:
+	double GetFrameTime() const;
+	bool WaitForAudio();
+
+	IClock* m_Clock = nullptr;
+	EPacingMode m_Mode = EPacingMode::RealTime;
+	double m_SpeedMultiplier = 1.0;
+	double m_NextFrameTime = 0.0;
+	bool m_IsBehind = false;
+
+	IAudioSink* m_AudioSink = nullptr;
+	uint32 m_AudioTarget = 0;
+};
\ No newline at end of file
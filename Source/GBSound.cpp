@@ -1,17 +1,108 @@
 #include "GBSound.h"
 #include "CPU.h"
-#include "SDL.h"
 #include "BinaryOps.h"
 #include <algorithm>
 
 using namespace BinaryOps;
 
-SoundChannel::SoundChannel(GBSound* SoundSystem) :
+SoundChannel::SoundChannel(GBSound* SoundSystem, int32 Number) :
 	m_SoundSystem(SoundSystem)
+	, m_Number(Number)
 {
 
 }
 
+void SoundChannel::SetAmplitude(uint32 Time, uint8 Amplitude)
+{
+	if (Amplitude != m_Amplitude)
+	{
+		m_Amplitude = Amplitude;
+		m_SoundSystem->MixChannel(*this, Time);
+	}
+}
+
+void SoundChannel::SaveState(GBChannelState& State) const
+{
+	State.SoundLength = m_CHSoundLength;
+	State.Envelope = m_CHEnvelope;
+	State.FrequencyLo = m_CHFrequencyLo;
+	State.FrequencyHiControl = m_CHFrequencyHiControl;
+	State.Amplitude = m_Amplitude;
+	State.PeriodTimer = m_PeriodTimer;
+	State.EnvelopeTimer = m_EnvelopeTimer;
+}
+
+void SoundChannel::LoadState(const GBChannelState& State)
+{
+	m_CHSoundLength = State.SoundLength;
+	m_CHEnvelope = State.Envelope;
+	m_CHFrequencyLo = State.FrequencyLo;
+	m_CHFrequencyHiControl = State.FrequencyHiControl;
+	m_Amplitude = State.Amplitude;
+	m_PeriodTimer = State.PeriodTimer;
+	m_EnvelopeTimer = State.EnvelopeTimer;
+}
+
+void PulseGeneric::SaveState(GBChannelState& State) const
+{
+	SoundChannel::SaveState(State);
+	State.Step = m_CurrentPulseStep;
+	State.Output = m_OutputBeforeVolume;
+}
+
+void PulseGeneric::LoadState(const GBChannelState& State)
+{
+	SoundChannel::LoadState(State);
+	m_CurrentPulseStep = State.Step & 0x07;
+	m_OutputBeforeVolume = State.Output;
+}
+
+void PulseA::SaveState(GBChannelState& State) const
+{
+	PulseGeneric::SaveState(State);
+	State.Sweep = m_CHSweep;
+	State.SweepTimer = m_SweepTimer;
+}
+
+void PulseA::LoadState(const GBChannelState& State)
+{
+	PulseGeneric::LoadState(State);
+	m_CHSweep = State.Sweep;
+	m_SweepTimer = State.SweepTimer;
+}
+
+void Wave::SaveState(GBChannelState& State) const
+{
+	SoundChannel::SaveState(State);
+	State.OnOff = m_CHOnOff;
+	State.Step = m_CurrentSample;
+	State.Output = m_OutputSample;
+	memcpy(State.Waveform, m_currentWaveform, sizeof(m_currentWaveform));
+}
+
+void Wave::LoadState(const GBChannelState& State)
+{
+	SoundChannel::LoadState(State);
+	m_CHOnOff = State.OnOff;
+	m_CurrentSample = State.Step & 0x1F;
+	m_OutputSample = State.Output;
+	memcpy(m_currentWaveform, State.Waveform, sizeof(m_currentWaveform));
+}
+
+void Noise::SaveState(GBChannelState& State) const
+{
+	SoundChannel::SaveState(State);
+	State.ShiftRegister = m_shiftRegister;
+	State.Output = m_OutputBeforeVolume;
+}
+
+void Noise::LoadState(const GBChannelState& State)
+{
+	SoundChannel::LoadState(State);
+	m_shiftRegister = State.ShiftRegister;
+	m_OutputBeforeVolume = State.Output;
+}
+
 bool SoundChannel::IsOn()
 {
 	return GetBit(7, m_CHFrequencyHiControl);
@@ -33,11 +124,11 @@ uint16 SoundChannel::GetFrequency()
 
 void SoundChannel::SetFrequency(uint16 Frequency)
 {
-	m_CHFrequencyLo = Frequency & 0x0F;
-	uint16 NewFreqHI = Frequency & 0x0700;
+	m_CHFrequencyLo = Frequency & 0xFF;
+	uint8 NewFreqHI = (Frequency >> 8) & 0x07;
 
 	//setting those three bits only
-	m_CHFrequencyHiControl = (m_CHFrequencyHiControl & ~0x0700) | NewFreqHI;
+	m_CHFrequencyHiControl = (m_CHFrequencyHiControl & ~0x07) | NewFreqHI;
 }
 
 uint8 SoundChannel::GetLength()
@@ -55,6 +146,49 @@ bool SoundChannel::GetCounterConsecutive()
 	return GetBit(6, m_CHFrequencyHiControl);
 }
 
+void SoundChannel::ClockLength()
+{
+	if (IsSilenced())
+	{
+		return;
+	}
+
+	uint8 currentLength = GetLength();
+	if (currentLength > 0)
+	{
+		currentLength--;
+		SetLength(currentLength);
+	}
+}
+
+void SoundChannel::ClockEnvelope()
+{
+	int32 currentSweepcount = GetVolumeSweepCount();
+	if ((currentSweepcount == 0) || !IsPlaying())
+	{
+		return;
+	}
+
+	m_EnvelopeTimer--;
+	if (m_EnvelopeTimer <= 0)
+	{
+		m_EnvelopeTimer = currentSweepcount;
+
+		uint8 volume = GetVolumeRegister();
+		if (GetVolumeSweepDirection())
+		{
+			if (volume < 0x0F)
+			{
+				SetVolumeRegister(volume + 1);
+			}
+		}
+		else if (volume > 0)
+		{
+			SetVolumeRegister(volume - 1);
+		}
+	}
+}
+
 uint8 SoundChannel::GetVolumeRegister()
 {
 	uint8 Volume = (m_CHEnvelope >> 4) & 0x0F;
@@ -68,18 +202,6 @@ void SoundChannel::SetVolumeRegister(uint8 volume)
 }
 
 
-float SoundChannel::GetVolume(int32 Cycles)
-{
-	uint8 Volume = GetVolumeRegister();
-	return float(Volume) / 15.0f;
-}
-
-float SoundChannel::GetEnvelope(int32 Cycles)
-{
-	int32 value = GetVolumeSweepCount();
-	return float(value) / 7.0f;
-}
-
 bool SoundChannel::GetVolumeSweepDirection()
 {
 	return GetBit(3, m_CHEnvelope);
@@ -119,25 +241,6 @@ int32 PulseA::GetFrequencySweepTime()
 	return SweepTime;
 }
 
-float Wave::GetVolume(int32 Cycles)
-{
-	uint8 Volume = (m_CHEnvelope >> 5) & 0x03;
-
-	switch(Volume)
-	{
-	case 0:
-		return 0.0f;
-	case 1:
-		return 1.0f;
-	case 2:
-		return 0.5f;
-	case 3:
-		return 0.25f;
-	}
-
-	return 1.0f;
-}
-
 uint8 PulseGeneric::GetPulseRatio()
 {
 	uint8 RatioVal = (m_CHSoundLength & 0xC0) >> 6;
@@ -151,51 +254,69 @@ GBSound::GBSound( GameBoyCPU* InCPU):
 	, m_Wave(this)
 	, m_Noise(this)
 {
-	SDL_AudioSpec Want, Have;
-	SDL_zero(Want);
-	Want.freq = Frequency;
-	Want.format = AUDIO_F32;
-	Want.channels = 2;
-	Want.samples = BufferSize;
-	Want.callback = nullptr;
-	Want.userdata = this;
+	IAudioSink* AudioSink = InCPU->GetPlatform().Audio;
+	if (AudioSink != nullptr)
+	{
+		m_SampleRate = AudioSink->GetSampleRate();
+	}
 
-	m_Device = SDL_OpenAudioDevice(NULL, 0, &Want, &Have, 0);
-	SDL_PauseAudio(0);
-	SDL_PauseAudioDevice(m_Device, 0);
+	//a buffer is flushed every BufferSize samples, leave room for the flush running late
+	m_BlipLeft.SetRates(Timings::GBClockSpeed, m_SampleRate, BufferSize * 2);
+	m_BlipRight.SetRates(Timings::GBClockSpeed, m_SampleRate, BufferSize * 2);
+
+	m_LastUpdateCycle = InCPU->GetCycleCount();
+	m_FrameStartCycle = m_LastUpdateCycle;
+	InCPU->GetScheduler().SetHandler(GBEvents::SoundBuffer, this);
+	ScheduleBufferFill();
 }
 
 GBSound::~GBSound()
 {
-	SDL_CloseAudioDevice(m_Device);
 }
 
-void GBSound::AudioCallback(void*  userdata,
-	Uint8* stream,
-	int    len)
+void GBSound::SaveState(GBSoundState& State) const
 {
-	GBSound* Device = (GBSound*)userdata;
+	memcpy(State.WavePattern, m_WavePattern, sizeof(m_WavePattern));
+	State.NR50 = m_NR50_CHControl_OnOff_Volume;
+	State.NR51 = m_NR51_SoundOutputTerminal;
+	State.NR52 = m_NR52_SoundOnOff;
+	State.FrameSequencerStep = m_FrameSequencerStep;
+	State.FrameSequencerCycles = m_FrameSequencerCycles;
+	State.FrameStartCycle = m_FrameStartCycle;
+	State.LastUpdateCycle = m_LastUpdateCycle;
 
-	uint32 sampleCount = len / sizeof(SoundSample);
-	SoundSample* sampleStream = (SoundSample*)stream;
+	//unused fields stay zero so identical states compare equal byte for byte
+	memset(State.Channels, 0, sizeof(State.Channels));
+	m_PulseA.SaveState(State.Channels[0]);
+	m_PulseB.SaveState(State.Channels[1]);
+	m_Wave.SaveState(State.Channels[2]);
+	m_Noise.SaveState(State.Channels[3]);
+}
 
-	for (uint32 i = 0; i < sampleCount; ++i)
-	{
-		if (i < Device->m_CurrentSample)
-		{
-			sampleStream[i] = Device->m_GeneratedSamples[i];
-		}
-		else
-		{
-			sampleStream[i].m_Left = 0.0f;
-			sampleStream[i].m_Right = 0.0f;
-		}
-	}
-	Device->m_CurrentSample = 0;
+void GBSound::LoadState(const GBSoundState& State)
+{
+	memcpy(m_WavePattern, State.WavePattern, sizeof(m_WavePattern));
+	m_NR50_CHControl_OnOff_Volume = State.NR50;
+	m_NR51_SoundOutputTerminal = State.NR51;
+	m_NR52_SoundOnOff = State.NR52;
+	m_FrameSequencerStep = State.FrameSequencerStep & 0x07;
+	m_FrameSequencerCycles = State.FrameSequencerCycles;
+	m_FrameStartCycle = State.FrameStartCycle;
+	m_LastUpdateCycle = State.LastUpdateCycle;
+
+	m_PulseA.LoadState(State.Channels[0]);
+	m_PulseB.LoadState(State.Channels[1]);
+	m_Wave.LoadState(State.Channels[2]);
+	m_Noise.LoadState(State.Channels[3]);
+
+	//the blip buffers still hold the levels from before the restore
+	MixAllChannels(uint32(m_LastUpdateCycle - m_FrameStartCycle));
 }
 
 uint8& GBSound::ReadMemory(uint16 address)
 {
+	Sync(CPU->GetCycleCount());
+
 	if (address >= MemRegisters::WavePatternBegin && address <= MemRegisters::WavePatternEnd)
 	{
 		return m_WavePattern[address - MemRegisters::WavePatternBegin];
@@ -261,6 +382,9 @@ uint8& GBSound::ReadMemory(uint16 address)
 
 void GBSound::WriteMemory(uint16 address, uint8 Value)
 {
+	//channels run up to now with the old settings before the write lands
+	Sync(CPU->GetCycleCount());
+
 	if (address >= MemRegisters::WavePatternBegin && address <= MemRegisters::WavePatternEnd)
 	{
 		m_WavePattern[address - MemRegisters::WavePatternBegin] = Value;
@@ -329,12 +453,15 @@ void GBSound::WriteMemory(uint16 address, uint8 Value)
 
 	case MemRegisters::NR50_CHControl_OnOff_Volume:
 		m_NR50_CHControl_OnOff_Volume = Value;
+		MixAllChannels(uint32(m_LastUpdateCycle - m_FrameStartCycle));
 		break;
 	case MemRegisters::NR51_SoundOutputTerminal:
 		m_NR51_SoundOutputTerminal = Value;
+		MixAllChannels(uint32(m_LastUpdateCycle - m_FrameStartCycle));
 		break;
 	case MemRegisters::NR52_SoundOnOff:
 		m_NR52_SoundOnOff = Value;
+		MixAllChannels(uint32(m_LastUpdateCycle - m_FrameStartCycle));
 		break;
 
 	default:
@@ -342,122 +469,66 @@ void GBSound::WriteMemory(uint16 address, uint8 Value)
 	}
 }
 
-void PulseA::Update(int32 Cycles)
+void PulseA::ClockSweep()
 {
-	//calculate frequency sweep
-	static float frequencyTable[] = {
-		0.0f,
-		1.0f / 128.0f,
-		2.0f / 128.0f,
-		3.0f / 128.0f,
-		4.0f / 128.0f,
-		5.0f / 128.0f,
-		6.0f / 128.0f,
-		7.0f / 128.0f
-	};
-
 	int32 sweepCount = GetFrequencySweepShiftCount();
 	int32 sweepTime = GetFrequencySweepTime();
-	if (sweepCount > 0 && sweepTime > 0)
+	if (sweepCount == 0 || sweepTime == 0)
 	{
-		float frequencyWait = frequencyTable[sweepTime];
-		float timeElapsed = float(Cycles) * Timings::GBClockTime;
-		m_currentSweepTime += timeElapsed;
-		if (m_currentSweepTime >= frequencyWait)
+		return;
+	}
+
+	//sweep time is in 128Hz steps
+	m_SweepTimer--;
+	if (m_SweepTimer <= 0)
+	{
+		m_SweepTimer = sweepTime;
+
+		int32 frequency = GetFrequency();
+		int32 delta = frequency >> sweepCount;
+		int32 newFrequency = GetFrequenctSweepDirection() ? (frequency - delta) : (frequency + delta);
+		if (newFrequency >= 0 && newFrequency <= 0x7FF)
 		{
-			m_currentSweepTime -= frequencyWait;
-			bool PlusOrMinus = GetFrequenctSweepDirection();
-			float newFrequency = 0.0f;
-			if (!PlusOrMinus)
-			{
-				newFrequency = float(GetFrequency()) + float(GetFrequency()) / std::powf(2.0f, float(sweepCount));
-			}
-			else
-			{
-				newFrequency = float(GetFrequency()) - float(GetFrequency()) / std::powf(2.0f, float(sweepCount));
-			}
 			SetFrequency(uint16(newFrequency));
-			if (sweepCount > 0)
-			{
-				SetFrequencyShiftCount(sweepCount - 1);
-			}
 		}
-	}
 
-	PulseGeneric::Update(Cycles);
+		SetFrequencyShiftCount(sweepCount - 1);
+	}
 }
 
-void PulseGeneric::Update(int32 Cycles)
+void PulseGeneric::Update(int32 Cycles, uint32 EndTime)
 {
-	if (!IsOn() && (GetLength() == 0))
+	uint32 startTime = EndTime - Cycles;
+	if (!IsPlaying())
 	{
-		m_Output = 0.0f;
+		SetAmplitude(startTime, 0);
 		return;
 	}
 
-	uint8 PulseWaveforms[4] ={
+	static constexpr uint8 PulseWaveforms[4] ={
 		0x01,
 		0x81,
 		0x87,
 		0x7E
 	};
 
-	float timeElapsed = float(Cycles) * Timings::GBClockTime;
-	m_TimeBeforeNextLenghtCheck -= timeElapsed;
-	if (m_TimeBeforeNextLenghtCheck <= 0.0f)
-	{
-		m_TimeBeforeNextLenghtCheck += LenghtTimeCheck;
-
-		uint8 currentLength = GetLength();
-		if (currentLength > 0)
-		{
-			currentLength--;
-			SetLength(currentLength);
-		}
-	}
+	//volume or duty may have changed since the last update
+	SetAmplitude(startTime, m_OutputBeforeVolume * GetVolumeRegister());
 
-	if ((GetLength() > 0) || (!GetCounterConsecutive()) )
+	//8 steps per period, 4 cycles per step per frequency unit
+	int32 pulseStepCycles = (2048 - int32(GetFrequency())) * 4;
+	m_PeriodTimer -= Cycles;
+	while (m_PeriodTimer <= 0)
 	{
-		float frequency = float(Timings::GBClockSpeed) / (32.0f * (2048.0f - float(GetFrequency())));
-		float pulseStepLength = (1.0f / frequency) / 8.0f;
-		m_CurrentSubPulseTime += timeElapsed;
-		if (m_CurrentSubPulseTime >= pulseStepLength)
-		{
-			m_OutputBeforeVolume = 0.0f;
-			m_CurrentSubPulseTime = 0.0f;
-			//output the sample
-			uint8 pulseRatio = GetPulseRatio();
-
-			uint8 waveform = PulseWaveforms[pulseRatio];
-			m_OutputBeforeVolume = GetBit(m_CurrentPulseStep, waveform) ? 1.0f : 0.0f;
+		uint32 stepTime = EndTime - uint32(-m_PeriodTimer);
+		m_PeriodTimer += pulseStepCycles;
 
-			m_CurrentPulseStep++;
-			if (m_CurrentPulseStep >= 8)
-			{
-				m_CurrentPulseStep = 0;
-			}
-		}
-
-		//calculating envelope
-		int32 currentSweepcount = GetVolumeSweepCount();
-		if (currentSweepcount > 0)
-		{
-			m_CurrentVolumeEnvelopeTime += timeElapsed;
-			if (m_CurrentVolumeEnvelopeTime >= (currentSweepcount * VolumeEnvelopeStep))
-			{
-				m_CurrentVolumeEnvelopeTime = 0.0f;
-				if (GetVolumeRegister() > 0)
-				{
-					SetVolumeRegister(GetVolumeRegister() - 1);
-				}
-			}
-		}
+		//output the sample
+		uint8 waveform = PulseWaveforms[GetPulseRatio()];
+		m_OutputBeforeVolume = GetBit(m_CurrentPulseStep, waveform) ? 1 : 0;
+		SetAmplitude(stepTime, m_OutputBeforeVolume * GetVolumeRegister());
 
-		m_Output = m_OutputBeforeVolume * GetVolume(Cycles);
-	}
-	else
-	{
-		m_Output = 0.0f;
+		m_CurrentPulseStep = (m_CurrentPulseStep + 1) & 0x07;
 	}
 }
 
@@ -495,64 +566,37 @@ void Wave::UpdateWaveform()
 	}
 }
 
-void Wave::Update(int32 Cycles)
+uint8 Wave::GetWaveAmplitude()
 {
-	if (!IsOn() && (GetLength() == 0))
+	//samples are already shifted down by the output level, level 0 mutes
+	uint8 Level = (m_CHEnvelope >> 5) & 0x03;
+	return (Level == 0) ? 0 : m_OutputSample;
+}
+
+void Wave::Update(int32 Cycles, uint32 EndTime)
+{
+	uint32 startTime = EndTime - Cycles;
+	if (!IsPlaying())
 	{
-		m_Output = 0.0f;
+		SetAmplitude(startTime, 0);
 		return;
 	}
 
 	UpdateWaveform();
+	SetAmplitude(startTime, GetWaveAmplitude());
 
-	float timeElapsed = float(Cycles) * Timings::GBClockTime;
-	m_TimeBeforeNextLenghtCheck -= timeElapsed;
-	if (m_TimeBeforeNextLenghtCheck <= 0.0f)
+	//32 samples per period
+	int32 sampleCycles = (2048 - int32(GetFrequency())) * 2;
+	m_PeriodTimer -= Cycles;
+	while (m_PeriodTimer <= 0)
 	{
-		m_TimeBeforeNextLenghtCheck += LenghtTimeCheck;
+		uint32 stepTime = EndTime - uint32(-m_PeriodTimer);
+		m_PeriodTimer += sampleCycles;
 
-		uint8 currentLength = GetLength();
-		if (currentLength > 0)
-		{
-			currentLength--;
-			SetLength(currentLength);
-		}
-	}
-
-	if ((GetLength() > 0) || (!GetCounterConsecutive()))
-	{
-		/*float frequency = float(Timings::GBClockSpeed) / (64.0f * (2048.0f - float(GetFrequency())));
-		float sampleStepLength = (1.0f / frequency) / 32.0f;
-		m_CurrentSampleTime += timeElapsed;
-		if (m_CurrentSampleTime >= sampleStepLength)
-		{
-			m_CurrentSampleTime = 0.0f;
-			m_Output = (float(m_currentWaveform[m_CurrentSample]) / 16.0f) * GetVolume(Cycles);
-
-			m_CurrentSample++;
-			if (m_CurrentSample >= 32)
-			{
-				m_CurrentSample = 0;
-			}
-		}*/
-
-		int32 frequencyCycles = (64.0f * (2048.0f - float(GetFrequency()))) / 32;
-		m_CurrentSampleTimeCycles += Cycles;
-		if (m_CurrentSampleTimeCycles >= frequencyCycles)
-		{
-			m_CurrentSampleTimeCycles -= frequencyCycles;
-			m_Output = (float(m_currentWaveform[m_CurrentSample]) / 16.0f) * GetVolume(Cycles);
+		m_OutputSample = m_currentWaveform[m_CurrentSample];
+		SetAmplitude(stepTime, GetWaveAmplitude());
 
-			m_CurrentSample++;
-			if (m_CurrentSample >= 32)
-			{
-				m_CurrentSample = 0;
-			}
-		}
-	}
-	else
-	{
-		m_Output = 0.0f;
+		m_CurrentSample = (m_CurrentSample + 1) & 0x1F;
 	}
 }
 
@@ -561,39 +605,14 @@ bool Noise::Get15or7Steps()
 	return GetBit(3, m_CHFrequencyLo);
 }
 
-float Noise::GetClockDivider()
-{
-	uint8 dividerVal = m_CHFrequencyLo & 0x07;
-	float f = float(Timings::GBClockSpeed) / 8.0f;
-	switch (dividerVal)
-	{
-	case 0:
-		return f * 2.0f;
-	case 1:
-		return f;
-	case 2: 
-		return f / 2.0f;
-	case 3:
-		return f / 3.0f;
-	case 4:
-		return f / 4.0f;
-	case 5:
-		return f / 5.0f;
-	case 6: 
-		return f / 6.0f;
-	case 7:
-		return f / 7.0f;
-	default:
-		break;
-	}
-
-	return 1.0f;
-}
-
-float Noise::GetPreScalerDivider()
+int32 Noise::GetPeriodCycles()
 {
-	uint8 prescalerVal = (m_CHFrequencyLo >> 4) & 0x0F;
-	return GetClockDivider() / pow(2.0f, float(prescalerVal + 1.0f));
+	//divisor 0 counts as 0.5
+	int32 divider = m_CHFrequencyLo & 0x07;
+	int32 shift = (m_CHFrequencyLo >> 4) & 0x0F;
+	int32 baseCycles = (divider == 0) ? 8 : (divider * 16);
+
+	return baseCycles << shift;
 }
 
 bool Noise::ShiftRegister()
@@ -612,66 +631,33 @@ bool Noise::ShiftRegister()
 	return !outBit; //the bit inverted
 }
 
-void Noise::Update(int32 Cycles)
+void Noise::Update(int32 Cycles, uint32 EndTime)
 {
-	if (!IsOn() && (GetLength() == 0))
+	uint32 startTime = EndTime - Cycles;
+	if (!IsPlaying())
 	{
-		m_Output = 0.0f;
+		SetAmplitude(startTime, 0);
 		return;
 	}
 
-	float timeElapsed = float(Cycles) * Timings::GBClockTime;
-	m_TimeBeforeNextLenghtCheck -= timeElapsed;
-	if (m_TimeBeforeNextLenghtCheck <= 0.0f)
-	{
-		m_TimeBeforeNextLenghtCheck += LenghtTimeCheck;
+	SetAmplitude(startTime, m_OutputBeforeVolume * GetVolumeRegister());
 
-		uint8 currentLength = GetLength();
-		if (currentLength > 0)
-		{
-			currentLength--;
-			SetLength(currentLength);
-		}
-	}
-
-	if ((GetLength() > 0) || (!GetCounterConsecutive()))
+	int32 periodCycles = GetPeriodCycles();
+	m_PeriodTimer -= Cycles;
+	while (m_PeriodTimer <= 0)
 	{
-		float sampleLength = 1.0f / GetPreScalerDivider();
-		m_CurrentSampleTime -= timeElapsed;
-		if (m_CurrentSampleTime <= 0.0f)
-		{
-			m_CurrentSampleTime = sampleLength;
+		uint32 stepTime = EndTime - uint32(-m_PeriodTimer);
+		m_PeriodTimer += periodCycles;
 
-			m_OutputBeforeVolume= ShiftRegister() ? 1.0f : 0.0f;
-		}
-
-		//calculating envelope
-		int32 currentSweepcount = GetVolumeSweepCount();
-		if (currentSweepcount > 0)
-		{
-			m_CurrentVolumeEnvelopeTime += timeElapsed;
-			if (m_CurrentVolumeEnvelopeTime >= (currentSweepcount * VolumeEnvelopeStep))
-			{
-				m_CurrentVolumeEnvelopeTime = 0.0f;
-				if (GetVolumeRegister() > 0)
-				{
-					SetVolumeRegister(GetVolumeRegister() - 1);
-				}
-			}
-		}
-
-		m_Output = m_OutputBeforeVolume * GetVolume(Cycles);
-	}
-	else
-	{
-		m_Output = 0.0f;
+		m_OutputBeforeVolume = ShiftRegister() ? 1 : 0;
+		SetAmplitude(stepTime, m_OutputBeforeVolume * GetVolumeRegister());
 	}
 }
 
-void GBSound::GetChannelVolumes(float& Left, float& Right)
+void GBSound::GetChannelVolumes(int32& Left, int32& Right)
 {
-	Left = float(m_NR50_CHControl_OnOff_Volume & 0x07) / 7.0f;
-	Right = float((m_NR50_CHControl_OnOff_Volume >> 4) & 0x07) / 7.0f;
+	Left = (m_NR50_CHControl_OnOff_Volume & 0x07) + 1;
+	Right = ((m_NR50_CHControl_OnOff_Volume >> 4) & 0x07) + 1;
 }
 
 void GBSound::GetTerminalFromChannel(int32 Channel, bool& Left, bool& Right)
@@ -687,65 +673,173 @@ bool GBSound::IsSoundOn()
 	return GetBit(7, m_NR52_SoundOnOff);
 }
 
-void GBSound::MixChannel(const SoundChannel& Channel, int32 Number, float& Left, float& Right)
+void GBSound::MixChannel(const SoundChannel& Channel, uint32 Time)
 {
-	if (!IsSoundOn())
+	if (m_Muted)
 	{
-		Left = 0.0f;
-		Right = 0.0f;
 		return;
 	}
 
-	float sample = Channel.GetOutput();
-	bool goesLeft;
-	bool goesRight;
-	GetTerminalFromChannel(Number, goesLeft, goesRight);
+	int32 Index = Channel.GetNumber() - 1;
+	int32 left = 0;
+	int32 right = 0;
 
-	if (goesLeft)
+	if (IsSoundOn())
 	{
-		Left += sample;// *0.25f; // so 4 channels at full power makes 1
+		bool goesLeft;
+		bool goesRight;
+		GetTerminalFromChannel(Channel.GetNumber(), goesLeft, goesRight);
+
+		int32 leftVolume;
+		int32 rightVolume;
+		GetChannelVolumes(leftVolume, rightVolume);
+
+		int32 level = int32(Channel.GetAmplitude()) * AmplitudeScale;
+		left = goesLeft ? level * leftVolume : 0;
+		right = goesRight ? level * rightVolume : 0;
 	}
 
-	if (goesRight)
+	if (left != m_MixLeft[Index])
 	{
-		Right += sample;// *0.25f;
+		m_BlipLeft.AddDelta(Time, left - m_MixLeft[Index]);
+		m_MixLeft[Index] = left;
 	}
+
+	if (right != m_MixRight[Index])
+	{
+		m_BlipRight.AddDelta(Time, right - m_MixRight[Index]);
+		m_MixRight[Index] = right;
+	}
+}
+
+void GBSound::MixAllChannels(uint32 Time)
+{
+	MixChannel(m_PulseA, Time);
+	MixChannel(m_PulseB, Time);
+	MixChannel(m_Wave, Time);
+	MixChannel(m_Noise, Time);
 }
 
 void GBSound::Update(int32 Cycles)
 {
-	m_PulseA.Update(Cycles);
-	m_PulseB.Update(Cycles);
-	m_Wave.Update(Cycles);
-	m_Noise.Update(Cycles);
+	uint32 time = uint32(m_LastUpdateCycle - m_FrameStartCycle);
 
-	//Sound update
-	m_CurrentCyclesCount += Cycles;
-	if (m_CurrentCyclesCount >= CyclesPerSample)
+	//split the update on frame sequencer steps so length/envelope/sweep land on the right cycle
+	while (Cycles > 0)
 	{
-		m_CurrentCyclesCount = 0;
-		//output the sample
+		int32 step = std::min(Cycles, m_FrameSequencerCycles);
+		time += step;
 
-		float sampleLeft = 0.0f;
-		float sampleRight = 0.0f;
+		m_PulseA.Update(step, time);
+		m_PulseB.Update(step, time);
+		m_Wave.Update(step, time);
+		m_Noise.Update(step, time);
 
-		MixChannel(m_PulseA, 1, sampleLeft, sampleRight);
-		MixChannel(m_PulseB, 2, sampleLeft, sampleRight);
-		MixChannel(m_Wave, 3, sampleLeft, sampleRight);
-		MixChannel(m_Noise, 4, sampleLeft, sampleRight);
+		Cycles -= step;
+		m_FrameSequencerCycles -= step;
+		if (m_FrameSequencerCycles == 0)
+		{
+			m_FrameSequencerCycles = FrameSequencerCycles;
+			ClockFrameSequencer();
+		}
+	}
+}
 
-		float leftVolume = 1.0f;
-		float rightVolume = 1.0f;
-		GetChannelVolumes(leftVolume, rightVolume);
+void GBSound::ClockFrameSequencer()
+{
+	if ((m_FrameSequencerStep & 0x01) == 0)
+	{
+		m_PulseA.ClockLength();
+		m_PulseB.ClockLength();
+		m_Wave.ClockLength();
+		m_Noise.ClockLength();
+	}
+
+	if (m_FrameSequencerStep == 2 || m_FrameSequencerStep == 6)
+	{
+		m_PulseA.ClockSweep();
+	}
+
+	if (m_FrameSequencerStep == 7)
+	{
+		m_PulseA.ClockEnvelope();
+		m_PulseB.ClockEnvelope();
+		m_Noise.ClockEnvelope();
+	}
+
+	m_FrameSequencerStep = (m_FrameSequencerStep + 1) & 0x07;
+}
+
+void GBSound::Sync(uint64 Now)
+{
+	if (Now > m_LastUpdateCycle)
+	{
+		Update(static_cast<int32>(Now - m_LastUpdateCycle));
+		m_LastUpdateCycle = Now;
+	}
+}
+
+void GBSound::ScheduleBufferFill()
+{
+	//wake up once a full buffer worth of samples is due
+	uint64 BufferCycles = (uint64(BufferSize) * Timings::GBClockSpeed) / m_SampleRate;
+	CPU->GetScheduler().Schedule(GBEvents::SoundBuffer, m_FrameStartCycle + BufferCycles);
+}
+
+void GBSound::OnEvent(uint8 /*EventId*/, uint64 /*Deadline*/, uint64 Now)
+{
+	Sync(Now);
+	FlushSamples(Now);
+	ScheduleBufferFill();
+}
+
+void GBSound::UpdateRateControl(IAudioSink* AudioSink)
+{
+	double Fill = double(AudioSink->GetBufferedSamples());
+	double Target = double(m_RateControlTarget);
+	double Deviation = std::max(-1.0, std::min(1.0, (Fill - Target) / Target));
+
+	//fuller than wanted: produce a little less per emulated second, emptier: a little more
+	double Rate = double(m_SampleRate) * (1.0 - MaxRateDeviation * Deviation);
+	m_BlipLeft.SetSampleRate(Timings::GBClockSpeed, Rate);
+	m_BlipRight.SetSampleRate(Timings::GBClockSpeed, Rate);
+}
 
-		m_GeneratedSamples[m_CurrentSample].m_Left = sampleLeft * leftVolume;
-		m_GeneratedSamples[m_CurrentSample].m_Right = sampleRight * rightVolume;
+void GBSound::FlushSamples(uint64 Now)
+{
+	if (m_Muted)
+	{
+		//nothing was added, the output buffers still end where they were muted
+		m_FrameStartCycle = Now;
+		return;
+	}
+
+	uint32 Duration = uint32(Now - m_FrameStartCycle);
+	m_BlipLeft.EndFrame(Duration);
+	m_BlipRight.EndFrame(Duration);
+	m_FrameStartCycle = Now;
+
+	IAudioSink* AudioSink = CPU->GetPlatform().Audio;
+	if ((m_RateControlTarget > 0) && (AudioSink != nullptr))
+	{
+		//the new ratio applies from the frame that just started
+		UpdateRateControl(AudioSink);
+	}
+
+	while (m_BlipLeft.GetSamplesAvailable() > 0)
+	{
+		uint32 Count = m_BlipLeft.ReadSamples(m_ReadLeft, BufferSize);
+		m_BlipRight.ReadSamples(m_ReadRight, Count);
+
+		for (uint32 i = 0; i < Count; ++i)
+		{
+			m_GeneratedSamples[i].m_Left = float(m_ReadLeft[i]) * OutputScale;
+			m_GeneratedSamples[i].m_Right = float(m_ReadRight[i]) * OutputScale;
+		}
 
-		m_CurrentSample++;
-		if (m_CurrentSample >= BufferSize)
+		if (AudioSink != nullptr)
 		{
-			SDL_QueueAudio(m_Device, m_GeneratedSamples, BufferSize * sizeof(SoundSample));
-			m_CurrentSample = 0;
+			AudioSink->QueueSamples(m_GeneratedSamples, Count);
 		}
 	}
 }
\ No newline at end of file
@@ -2,25 +2,27 @@
 
 #include "Types.h"
 #include "MemoryElement.h"
-#include "SDL.h"
 #include "Constants.h"
+#include "Platform.h"
+#include "Scheduler.h"
+#include "BlipBuffer.h"
+#include "SaveState.h"
 
 class SoundChannel
 {
 public:
 
-	SoundChannel(class GBSound* SoundSystem);
+	SoundChannel(class GBSound* SoundSystem, int32 Number);
 
-	uint8 m_CHSoundLength;
-	uint8 m_CHEnvelope;
-	uint8 m_CHFrequencyLo;
-	uint8 m_CHFrequencyHiControl;
+	uint8 m_CHSoundLength = 0;
+	uint8 m_CHEnvelope = 0;
+	uint8 m_CHFrequencyLo = 0;
+	uint8 m_CHFrequencyHiControl = 0;
 
 	virtual bool IsOn();
-	virtual void Update(int32 Cycles) {};
-	virtual float GetVolume(int32 Cycles);
+	//EndTime is the clock time of the end of the update inside the current audio frame
+	virtual void Update(int32 /*Cycles*/, uint32 /*EndTime*/) {};
 	virtual uint8 GetVolumeRegister();
-	virtual float GetEnvelope(int32 Cycles);
 	virtual void SetVolumeRegister(uint8 volume);
 
 	virtual bool GetVolumeSweepDirection();
@@ -35,58 +37,74 @@ public:
 
 	bool GetCounterConsecutive();
 
-	float GetOutput() const { return m_Output; }
+	//frame sequencer clocks
+	virtual void ClockLength();
+	virtual void ClockEnvelope();
+
+	int32 GetNumber() const { return m_Number; }
+	uint8 GetAmplitude() const { return m_Amplitude; }
+
+	virtual void SaveState(GBChannelState& State) const;
+	virtual void LoadState(const GBChannelState& State);
 
 protected:
-	static constexpr float VolumeEnvelopeStep = 1.0f / 64.0f;
+	//digital output level 0-15, changes are forwarded to the mixer at their exact time
+	void SetAmplitude(uint32 Time, uint8 Amplitude);
 
-	float m_CurrentVolumeEnvelopeTime = 0.0f;
+	bool IsSilenced() { return !IsOn() && (GetLength() == 0); }
+	bool IsPlaying() { return !IsSilenced() && ((GetLength() > 0) || !GetCounterConsecutive()); }
+
+	//cycles left before the next waveform step
+	int32 m_PeriodTimer = 0;
+	int32 m_EnvelopeTimer = 0;
 	class GBSound* m_SoundSystem;
-	float m_Output = 0.0f;
+	int32 m_Number;
+	uint8 m_Amplitude = 0;
 };
 
 class PulseGeneric : public SoundChannel
 {
 public:
-	PulseGeneric(class GBSound* SoundSystem): SoundChannel(SoundSystem)
+	PulseGeneric(class GBSound* SoundSystem, int32 Number): SoundChannel(SoundSystem, Number)
 	{}
 
-	static constexpr float LenghtTimeCheck = 1.0f / 256.0f;
-
 	uint8 GetPulseRatio();
 
-	virtual void Update(int32 Cycles) override;
+	virtual void Update(int32 Cycles, uint32 EndTime) override;
+	virtual void SaveState(GBChannelState& State) const override;
+	virtual void LoadState(const GBChannelState& State) override;
+
 protected:
-	float m_TimeBeforeNextLenghtCheck = 0.0f;
 	int32 m_CurrentPulseStep = 0; // max 7;
-	float m_CurrentSubPulseTime = 0.0f;
-
-	float m_OutputBeforeVolume = 0.0f;
+	uint8 m_OutputBeforeVolume = 0;
 };
 
 class PulseA : public PulseGeneric
 {
 public:
-	PulseA(class GBSound* SoundSystem) : PulseGeneric(SoundSystem)
+	PulseA(class GBSound* SoundSystem) : PulseGeneric(SoundSystem, 1)
 	{}
 
-	uint8 m_CHSweep;
+	uint8 m_CHSweep = 0;
 
 	int32 GetFrequencySweepShiftCount();
 	bool GetFrequenctSweepDirection();
 	int32 GetFrequencySweepTime();
 	void SetFrequencyShiftCount(uint8 newCount);
 
-	virtual void Update(int32 Cycles) override;
+	void ClockSweep();
+
+	virtual void SaveState(GBChannelState& State) const override;
+	virtual void LoadState(const GBChannelState& State) override;
 
 protected:
-	float m_currentSweepTime = 0.0f;
+	int32 m_SweepTimer = 0;
 };
 
 class PulseB : public PulseGeneric
 {
 public:
-	PulseB(class GBSound* SoundSystem) : PulseGeneric(SoundSystem)
+	PulseB(class GBSound* SoundSystem) : PulseGeneric(SoundSystem, 2)
 	{}
 
 };
@@ -94,15 +112,12 @@ public:
 class Wave : public SoundChannel
 {
 public:
-	static constexpr float LenghtTimeCheck = 1.0f / 256.0f;
-
-	Wave(class GBSound* SoundSystem) : SoundChannel(SoundSystem)
+	Wave(class GBSound* SoundSystem) : SoundChannel(SoundSystem, 3)
 	{}
 
-	uint8 m_CHOnOff;
+	uint8 m_CHOnOff = 0;
 
 	virtual bool IsOn() override;
-	virtual float GetVolume(int32 Cycles) override;
 	virtual bool GetVolumeSweepDirection() override { return false; }
 	virtual int32 GetVolumeSweepCount() override { return 0; }
 	virtual uint8 GetLength() override
@@ -110,78 +125,99 @@ public:
 		return m_CHSoundLength;
 	}
 
-	virtual void Update(int32 Cycles) override;
+	virtual void Update(int32 Cycles, uint32 EndTime) override;
+	virtual void SaveState(GBChannelState& State) const override;
+	virtual void LoadState(const GBChannelState& State) override;
 
 protected:
-	uint8 m_currentWaveform[32];
+	uint8 m_currentWaveform[32] = {};
 	void UpdateWaveform();
+	uint8 GetWaveAmplitude();
 
-	float m_TimeBeforeNextLenghtCheck = 0.0f;
 	int32 m_CurrentSample = 0; // max 32;
-	float m_CurrentSampleTime = 0.0f;
-	int32 m_CurrentSampleTimeCycles = 0;
+	uint8 m_OutputSample = 0;
 };
 
 class Noise : public SoundChannel
 {
 public:
-	static constexpr float LenghtTimeCheck = 1.0f / 256.0f;
-
-	Noise(class GBSound* SoundSystem) : SoundChannel(SoundSystem)
+	Noise(class GBSound* SoundSystem) : SoundChannel(SoundSystem, 4)
 	{}
 
 	bool Get15or7Steps();
-	float GetClockDivider();
-	float GetPreScalerDivider();
+	int32 GetPeriodCycles();
 
 	bool ShiftRegister();
 
-	virtual void Update(int32 Cycles) override;
+	virtual void Update(int32 Cycles, uint32 EndTime) override;
+	virtual void SaveState(GBChannelState& State) const override;
+	virtual void LoadState(const GBChannelState& State) override;
 
 protected:
-	float m_TimeBeforeNextLenghtCheck = 0.0f;
-	float m_CurrentSampleTime = 0.0f;
 	uint16 m_shiftRegister = 0xFFFF;
-	float m_OutputBeforeVolume = 0.0f;
+	uint8 m_OutputBeforeVolume = 0;
 };
 
-class GBSound : public IMemoryElement
+class GBSound : public IMemoryElement, public IEventHandler
 {
 public:
-	struct SoundSample
-	{
-		float m_Left;
-		float m_Right;
-	};
+	using SoundSample = GBSoundSample;
 
 	static constexpr float RequestedBufferTime = 1.0f / 60.0f;
 
 	static constexpr uint32 Frequency = 44100;
 	static constexpr float SampleLength = 1.0f / float(Frequency);
 	static constexpr uint32 BufferSize = 1024;// uint32(RequestedBufferTime / SampleLength);
-	static constexpr uint32 CyclesPerSample = uint32(Timings::GBClockSpeed * SampleLength);
+	//mixer levels per channel go up to 15 * 8 * AmplitudeScale
+	static constexpr int32 AmplitudeScale = 64;
+	static constexpr float OutputScale = 1.0f / float(15 * 8 * AmplitudeScale);
+	//rate control never bends the output rate by more than this, well below audible pitch change
+	static constexpr double MaxRateDeviation = 0.005;
+	//512Hz, length on even steps, sweep on 2 and 6, envelope on 7
+	static constexpr int32 FrameSequencerCycles = Timings::GBClockSpeed / 512;
 
 	GBSound(class GameBoyCPU* InCPU);
 	~GBSound();
 
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 Value) override;
+	virtual void OnEvent(uint8 EventId, uint64 Deadline, uint64 Now) override;
 
-	void Update(int32 Cycles);
 	uint8* GetWavePattern() { return m_WavePattern; }
 
-	void GetChannelVolumes(float& Left, float& Right);
+	//the buffer event is restored with the scheduler. Queued output isn't part of the state,
+	//a restore carries on the current output from the restored channel levels
+	void SaveState(GBSoundState& State) const;
+	void LoadState(const GBSoundState& State);
+
+	//Muted, the APU keeps running but neither touches the output buffers nor queues samples,
+	//so restoring a state saved before muting continues the output seamlessly
+	void SetMuted(bool Muted) { m_Muted = Muted; }
+
+	//Nudges the resampling ratio so the sink's fill level settles on TargetSamples, 0 turns it off
+	void SetRateControl(uint32 TargetSamples) { m_RateControlTarget = TargetSamples; }
+
+	void GetChannelVolumes(int32& Left, int32& Right);
 	void GetTerminalFromChannel(int32 Channel, bool& Left, bool& Right);
-	void MixChannel(const SoundChannel& Channel, int32 Number, float& Left, float& Right);
+	void MixChannel(const SoundChannel& Channel, uint32 Time);
 	bool IsSoundOn();
 
 private:
+	//the APU only catches up when a sound register is accessed or the output buffer is due,
+	//channel changes go to the blip buffers at their exact cycle
+	void Update(int32 Cycles);
+	void Sync(uint64 Now);
+	void MixAllChannels(uint32 Time);
+	void FlushSamples(uint64 Now);
+	void UpdateRateControl(IAudioSink* AudioSink);
+	void ScheduleBufferFill();
+	void ClockFrameSequencer();
 
 	class GameBoyCPU* CPU;
 
-	uint8 m_WavePattern[16];
-	uint8 m_NR50_CHControl_OnOff_Volume;
-	uint8 m_NR51_SoundOutputTerminal;
+	uint8 m_WavePattern[16] = {};
+	uint8 m_NR50_CHControl_OnOff_Volume = 0;
+	uint8 m_NR51_SoundOutputTerminal = 0;
 	uint8 m_NR52_SoundOnOff = 0xF1;
 
 	PulseA m_PulseA;
@@ -190,12 +226,20 @@ private:
 	Noise m_Noise;
 
 	//sound output
-	SDL_AudioDeviceID m_Device;
+	BlipBuffer m_BlipLeft;
+	BlipBuffer m_BlipRight;
+	int32 m_MixLeft[4] = {};
+	int32 m_MixRight[4] = {};
+	int32 m_ReadLeft[BufferSize];
+	int32 m_ReadRight[BufferSize];
 	SoundSample m_GeneratedSamples[BufferSize]; // just to be sure to not overrun
-	uint32 m_CurrentCyclesCount = 0;
-	uint32 m_CurrentSample = 0;
-
-	static void AudioCallback(void*  userdata,
-		Uint8* stream,
-		int    len);
+	uint32 m_SampleRate = Frequency;
+	uint32 m_RateControlTarget = 0;
+	bool m_Muted = false;
+
+	//blip times are relative to the start of the current audio frame
+	uint64 m_FrameStartCycle = 0;
+	uint64 m_LastUpdateCycle = 0;
+	int32 m_FrameSequencerCycles = FrameSequencerCycles;
+	uint8 m_FrameSequencerStep = 0;
 };
\ No newline at end of file
@@ -18,6 +18,7 @@ bool GBCounter::Tick(uint32 TickCycles)
 		return false;
 	}
 
+	bool Overflow = false;
 	m_CurrentCycles -= TickCycles;
 	while (m_CurrentCycles <= 0)
 	{
@@ -25,10 +26,29 @@ bool GBCounter::Tick(uint32 TickCycles)
 		m_Value++;
 		if (m_Value == 0)
 		{
-			return true;
+			m_Value = m_ReloadValue;
+			Overflow = true;
 		}
 	}
-	return false;
+	return Overflow;
+}
+
+void GBCounter::SaveState(GBCounterState& State) const
+{
+	State.Value = m_Value;
+	State.ReloadValue = m_ReloadValue;
+	State.IsRunning = m_IsRunning;
+	State.CounterCycles = m_CounterCycles;
+	State.CurrentCycles = m_CurrentCycles;
+}
+
+void GBCounter::LoadState(const GBCounterState& State)
+{
+	m_Value = State.Value;
+	m_ReloadValue = State.ReloadValue;
+	m_IsRunning = State.IsRunning != 0;
+	m_CounterCycles = State.CounterCycles;
+	m_CurrentCycles = State.CurrentCycles;
 }
 
 GBTimer::GBTimer(GameBoyCPU* InCPU) :
@@ -37,6 +57,8 @@ GBTimer::GBTimer(GameBoyCPU* InCPU) :
 	, m_CPU(InCPU)
 {
 	m_TimerRegister.Stop();
+	m_LastUpdateCycle = InCPU->GetCycleCount();
+	InCPU->GetScheduler().SetHandler(GBEvents::TimerOverflow, this);
 }
 
 void GBTimer::Update(uint32 TickCycles)
@@ -46,18 +68,63 @@ void GBTimer::Update(uint32 TickCycles)
 	if (m_TimerRegister.Tick(TickCycles))
 	{
 		//loop completed
-		m_TimerRegister.SetValue(m_TimerModulo);
 		m_CPU->FireInterrupt(InterruptCodes::Timer);
 	}
 }
 
+void GBTimer::Sync(uint64 Now)
+{
+	uint32 Elapsed = static_cast<uint32>(Now - m_LastUpdateCycle);
+	m_LastUpdateCycle = Now;
+	Update(Elapsed);
+}
+
+void GBTimer::ScheduleOverflow()
+{
+	GBScheduler& Scheduler = m_CPU->GetScheduler();
+	if (m_TimerRegister.IsRunning())
+	{
+		Scheduler.Schedule(GBEvents::TimerOverflow, m_LastUpdateCycle + m_TimerRegister.GetCyclesToOverflow());
+	}
+	else
+	{
+		Scheduler.Deschedule(GBEvents::TimerOverflow);
+	}
+}
+
+void GBTimer::OnEvent(uint8 /*EventId*/, uint64 /*Deadline*/, uint64 Now)
+{
+	Sync(Now);
+	ScheduleOverflow();
+}
+
+void GBTimer::SaveState(GBTimerState& State) const
+{
+	State.LastUpdateCycle = m_LastUpdateCycle;
+	m_DividerRegister.SaveState(State.Divider);
+	m_TimerRegister.SaveState(State.Timer);
+	State.TimerModulo = m_TimerModulo;
+	State.TimerControl = m_TimerControl;
+}
+
+void GBTimer::LoadState(const GBTimerState& State)
+{
+	m_LastUpdateCycle = State.LastUpdateCycle;
+	m_DividerRegister.LoadState(State.Divider);
+	m_TimerRegister.LoadState(State.Timer);
+	m_TimerModulo = State.TimerModulo;
+	m_TimerControl = State.TimerControl;
+}
+
 uint8& GBTimer::ReadMemory(uint16 address)
 {
 	switch (address)
 	{
 	case MemRegisters::DivRegister:
+		Sync(m_CPU->GetCycleCount());
 		return m_DividerRegister.GetValue();
 	case MemRegisters::TIMA:
+		Sync(m_CPU->GetCycleCount());
 		return m_TimerRegister.GetValue();
 	case MemRegisters::TimeModulo:
 		return m_TimerModulo;
@@ -71,6 +138,8 @@ uint8& GBTimer::ReadMemory(uint16 address)
 
 void GBTimer::WriteMemory(uint16 address, uint8 Value)
 {
+	Sync(m_CPU->GetCycleCount());
+
 	switch (address)
 	{
 	case MemRegisters::DivRegister:
@@ -81,6 +150,7 @@ void GBTimer::WriteMemory(uint16 address, uint8 Value)
 		break;
 	case MemRegisters::TimeModulo:
 		m_TimerModulo = Value;
+		m_TimerRegister.SetReloadValue(Value);
 		break;
 	case MemRegisters::TimeControl:
 	{
@@ -117,4 +187,6 @@ void GBTimer::WriteMemory(uint16 address, uint8 Value)
 	default:
 		break;
 	}
+
+	ScheduleOverflow();
 }
\ No newline at end of file
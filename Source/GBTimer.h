@@ -1,6 +1,8 @@
 #pragma once
 #include "Types.h"
 #include "MemoryElement.h"
+#include "Scheduler.h"
+#include "SaveState.h"
 
 class GameBoyCPU;
 
@@ -9,9 +11,15 @@ class GBCounter
 public:
 	GBCounter(int32 InCycles, GameBoyCPU* InCPU);
 
+	//returns true if the counter overflowed, it then restarts from the reload value
 	bool Tick(uint32 TickCycles);
 	void Start() { m_IsRunning = true; }
 	void Stop() { m_IsRunning = false; }
+	bool IsRunning() const { return m_IsRunning; }
+	uint32 GetCyclesToOverflow() const
+	{
+		return m_CurrentCycles + (0xFF - m_Value) * m_CounterCycles;
+	}
 	void SetFrequency(int32 InCycles)
 	{
 		if (m_CounterCycles != InCycles)
@@ -22,9 +30,14 @@ public:
 	}
 	uint8& GetValue() { return m_Value; }
 	void SetValue(uint8 val) { m_Value = val; }
+	void SetReloadValue(uint8 val) { m_ReloadValue = val; }
+
+	void SaveState(GBCounterState& State) const;
+	void LoadState(const GBCounterState& State);
 
 private:
 	uint8 m_Value;
+	uint8 m_ReloadValue = 0;
 
 	int32 m_CounterCycles;
 	int32 m_CurrentCycles = 0;
@@ -33,18 +46,29 @@ private:
 	bool m_IsRunning;
 };
 
-class GBTimer : public IMemoryElement
+class GBTimer : public IMemoryElement, public IEventHandler
 {
 public:
 	GBTimer(GameBoyCPU* InCPU);
 
-	void Update(uint32 TickCycles);
 	GBCounter& GetCounter() { return m_TimerRegister; }
 
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 Value) override;
+	virtual void OnEvent(uint8 EventId, uint64 Deadline, uint64 Now) override;
+
+	//the overflow event is restored with the scheduler
+	void SaveState(GBTimerState& State) const;
+	void LoadState(const GBTimerState& State);
 
 private:
+	//counters are only advanced when read, written or when TIMA overflows
+	void Update(uint32 TickCycles);
+	void Sync(uint64 Now);
+	void ScheduleOverflow();
+
+	uint64 m_LastUpdateCycle = 0;
+
 	GameBoyCPU* m_CPU = nullptr;
 	GBCounter m_DividerRegister;
 	GBCounter m_TimerRegister;
@@ -1,6 +1,7 @@
 #include "GPU.h"
 #include "CPU.h"
 #include <assert.h>
+#include <algorithm>
 #include "BinaryOps.h"
 
 using namespace BinaryOps;
@@ -9,24 +10,200 @@ GPU::GPU(GameBoyCPU* InCPU) :
 	m_CPU(InCPU)
 	, m_GPUModeCycles(Timings::VBlankCycles)
 {
-	m_Rendering.Init();
+	m_Rendering.Init(InCPU->GetPlatform().Video);
+	m_TileCache.Init(m_VRAM);
+	RebuildSpriteLines();
+	m_LastUpdateCycle = InCPU->GetCycleCount();
+	InCPU->GetScheduler().SetHandler(GBEvents::GPUMode, this);
+}
+
+void GPU::OnEvent(uint8 /*EventId*/, uint64 /*Deadline*/, uint64 Now)
+{
+	Sync(Now);
+	UpdateMode();
+	ScheduleNextMode();
+}
+
+void GPU::Sync(uint64 Now)
+{
+	int32 Elapsed = static_cast<int32>(Now - m_LastUpdateCycle);
+	m_LastUpdateCycle = Now;
+
+	if (m_DMATransferRemainingCycles > 0)
+	{
+		//is this needed?
+		m_DMATransferRemainingCycles -= Elapsed;
+	}
+
+	if (IsLCDEnabled())
+	{
+		m_GPUModeCycles += Elapsed;
+	}
+}
+
+void GPU::ScheduleNextMode()
+{
+	GBScheduler& Scheduler = m_CPU->GetScheduler();
+	if (!IsLCDEnabled())
+	{
+		//mode cycles are frozen while the LCD is off
+		Scheduler.Deschedule(GBEvents::GPUMode);
+		return;
+	}
+
+	int32 ModeLength = 0;
+	switch (m_LCDStatus & 0x03)
+	{
+	case GPUStates::HBlank: ModeLength = Timings::HBlankCycles; break;
+	case GPUStates::VBlank: ModeLength = Timings::VBlankCycles; break;
+	case GPUStates::ReadingOAM: ModeLength = Timings::ReadingOAMCycles; break;
+	case GPUStates::ReadingOAMVRAM: ModeLength = Timings::ReadingOAMVRAMCycles; break;
+	}
+
+	int32 Remaining = ModeLength - m_GPUModeCycles;
+	if (Remaining < 1)
+	{
+		Remaining = 1;
+	}
+
+	Scheduler.Schedule(GBEvents::GPUMode, m_LastUpdateCycle + Remaining);
+}
+
+void GPU::UpdateCoincidence()
+{
+	// Bit 2 - Coincidence Flag  (0:LYC<>LY, 1:LYC=LY) (Read Only)
+	if (m_LYCompare == m_LY)
+	{
+		//STAT only fires when LY starts matching, not for as long as it matches
+		bool WasCoincident = GetBit(2, m_LCDStatus);
+		m_LCDStatus = SetBit(2, m_LCDStatus, true);
+		if (!WasCoincident && GetBit(6, m_LCDStatus))
+		{
+			m_CPU->FireInterrupt(InterruptCodes::STAT);
+		}
+	}
+	else
+	{
+		m_LCDStatus = SetBit(2, m_LCDStatus, false);
+	}
 }
 
 void GPU::RenderScanline()
 {
-	if (m_LY <= ScreenData::SizeY)
+	//skipped frames keep all of the timing, they just don't draw
+	if ((m_LY >= ScreenData::SizeY) || m_Rendering.IsSkippingFrame())
+	{
+		return;
+	}
+
+	m_LineState.LCDControl = m_LCDControl;
+	m_LineState.ScrollX = m_ScrollX;
+	m_LineState.ScrollY = m_ScrollY;
+	m_LineState.WinPosX = m_WinPosX;
+	m_LineState.WinPosY = m_WinPosY;
+	m_LineState.BGPalette = m_BGPalette;
+	m_LineState.ObjPalette0 = m_ObjPalette0;
+	m_LineState.ObjPalette1 = m_OBJPalette1;
+
+	if (m_RenderThread != nullptr)
+	{
+		m_RenderThread->PushLine(m_LY, m_LineState);
+		return;
+	}
+
+	GBVideoMemory Memory;
+	Memory.VRAM = m_VRAM;
+	Memory.OAM = m_OAM;
+	Memory.TileCache = &m_TileCache;
+	m_Rendering.DrawLine(m_LY, m_LineState, Memory);
+}
+
+void GPU::RenderScreen()
+{
+	bool FrameDrawn = !m_Rendering.IsSkippingFrame() && !m_Rendering.IsPresentSuppressed();
+	m_Rendering.Render();
+
+	if ((m_RenderThread != nullptr) && FrameDrawn)
+	{
+		m_RenderThread->PushEndFrame();
+	}
+}
+
+void GPU::SetRenderThread(GBRenderThread* RenderThread)
+{
+	//the thread draws from its own copy of VRAM and OAM, this side only decides frame skips
+	m_RenderThread = RenderThread;
+	m_Rendering.Init(nullptr);
+	m_RenderThread->Start(m_VRAM, m_OAM);
+}
+
+void GPU::SaveState(GBGPUState& State) const
+{
+	memcpy(State.VRAM, m_VRAM, sizeof(m_VRAM));
+	memcpy(State.OAM, m_OAM, sizeof(m_OAM));
+
+	State.ModeCycles = m_GPUModeCycles;
+	State.LastUpdateCycle = m_LastUpdateCycle;
+	State.DMATransferRemainingCycles = m_DMATransferRemainingCycles;
+
+	State.LY = m_LY;
+	State.LYCompare = m_LYCompare;
+	State.LCDControl = m_LCDControl;
+	State.LCDStatus = m_LCDStatus;
+	State.ScrollX = m_ScrollX;
+	State.ScrollY = m_ScrollY;
+	State.WinPosX = m_WinPosX;
+	State.WinPosY = m_WinPosY;
+	State.BGPalette = m_BGPalette;
+	State.ObjPalette0 = m_ObjPalette0;
+	State.ObjPalette1 = m_OBJPalette1;
+
+	State.SpriteCount = m_LineState.SpriteCount;
+	memcpy(State.Sprites, m_LineState.Sprites, sizeof(State.Sprites));
+}
+
+void GPU::LoadState(const GBGPUState& State)
+{
+	for (uint16 Offset = 0; Offset < sizeof(m_VRAM); ++Offset)
 	{
-		m_Rendering.InitLine();
-		m_Rendering.DrawLineBackground(m_CPU, this, m_LY);
-		m_Rendering.DrawLineWindow(m_CPU, this, m_LY);
+		uint8 Value = State.VRAM[Offset];
+		if (m_VRAM[Offset] != Value)
+		{
+			m_VRAM[Offset] = Value;
+			m_TileCache.Invalidate(Offset);
+			if (m_RenderThread != nullptr)
+			{
+				m_RenderThread->PushVRAMWrite(Offset, Value);
+			}
+		}
+	}
 
-		if (GetBit(1, m_LCDControl))
+	for (uint32 Offset = 0; Offset < sizeof(m_OAM); ++Offset)
+	{
+		if (m_OAM[Offset] != State.OAM[Offset])
 		{
-			m_Rendering.DrawSpriteLine(m_CPU, this, m_LY);
+			WriteOAM(uint8(Offset), State.OAM[Offset]);
 		}
-		
-		m_Rendering.CopyLineInTexture(m_LY);
 	}
+
+	m_GPUModeCycles = State.ModeCycles;
+	m_LastUpdateCycle = State.LastUpdateCycle;
+	m_DMATransferRemainingCycles = State.DMATransferRemainingCycles;
+
+	m_LY = State.LY;
+	m_LYCompare = State.LYCompare;
+	m_LCDControl = State.LCDControl;
+	m_LCDStatus = State.LCDStatus;
+	m_ScrollX = State.ScrollX;
+	m_ScrollY = State.ScrollY;
+	m_WinPosX = State.WinPosX;
+	m_WinPosY = State.WinPosY;
+	m_BGPalette = State.BGPalette;
+	m_ObjPalette0 = State.ObjPalette0;
+	m_OBJPalette1 = State.ObjPalette1;
+
+	m_LineState.SpriteCount = std::min<uint8>(State.SpriteCount, MaxSpritesPerLine);
+	memcpy(m_LineState.Sprites, State.Sprites, sizeof(State.Sprites));
 }
 
 bool GPU::IsLCDEnabled()
@@ -41,7 +218,85 @@ void GPU::FireDMATransfer(uint8 address)
 	uint16 source = (static_cast<uint16>(address) * 0x0100);
 	for (uint8 offset = 0x00; offset <= 0x9F; offset++)
 	{
-		m_OAM[offset] = m_CPU->ReadMemory(source | offset, true);
+		WriteOAM(offset, m_CPU->ReadMemory(source | offset, true));
+	}
+}
+
+void GPU::WriteOAM(uint8 Offset, uint8 Value)
+{
+	//byte 0 of every entry is its Y position
+	if (((Offset % 4) == 0) && (m_OAM[Offset] != Value))
+	{
+		SetSpriteLines(Offset / 4, m_OAM[Offset], false);
+		SetSpriteLines(Offset / 4, Value, true);
+	}
+	m_OAM[Offset] = Value;
+
+	if (m_RenderThread != nullptr)
+	{
+		m_RenderThread->PushOAMWrite(Offset, Value);
+	}
+}
+
+void GPU::SetSpriteLines(uint32 Entry, uint8 PosY, bool Covered)
+{
+	uint64 EntryBit = 1ull << Entry;
+	int32 Top = int32(PosY) - 16;
+
+	for (int32 Tall = 0; Tall < 2; ++Tall)
+	{
+		int32 Bottom = std::min(Top + (Tall ? 16 : 8), int32(ScreenData::SizeY));
+		for (int32 Line = std::max(Top, 0); Line < Bottom; ++Line)
+		{
+			if (Covered)
+			{
+				m_SpriteLineMasks[Tall][Line] |= EntryBit;
+			}
+			else
+			{
+				m_SpriteLineMasks[Tall][Line] &= ~EntryBit;
+			}
+		}
+	}
+}
+
+void GPU::RebuildSpriteLines()
+{
+	memset(m_SpriteLineMasks, 0, sizeof(m_SpriteLineMasks));
+	for (uint32 Entry = 0; Entry < OAMEntryCount; ++Entry)
+	{
+		SetSpriteLines(Entry, m_OAM[Entry * 4], true);
+	}
+}
+
+void GPU::ScanOAM()
+{
+	m_LineState.SpriteCount = 0;
+	if (m_LY >= ScreenData::SizeY)
+	{
+		return;
+	}
+
+	//the first 10 entries in OAM order that cover the line, X doesn't matter here
+	uint64 Candidates = m_SpriteLineMasks[GetBit(2, m_LCDControl) ? 1 : 0][m_LY];
+	while ((Candidates != 0) && (m_LineState.SpriteCount < MaxSpritesPerLine))
+	{
+		m_LineState.Sprites[m_LineState.SpriteCount++] = uint8(LowestSetBit(Candidates));
+		Candidates &= Candidates - 1;
+	}
+
+	//smaller X wins, OAM order breaks ties. Insertion sort keeps it stable
+	for (uint32 i = 1; i < m_LineState.SpriteCount; ++i)
+	{
+		uint8 Entry = m_LineState.Sprites[i];
+		uint8 PosX = m_OAM[Entry * 4 + 1];
+
+		uint32 j = i;
+		for (; (j > 0) && (m_OAM[m_LineState.Sprites[j - 1] * 4 + 1] > PosX); --j)
+		{
+			m_LineState.Sprites[j] = m_LineState.Sprites[j - 1];
+		}
+		m_LineState.Sprites[j] = Entry;
 	}
 }
 
@@ -93,23 +348,32 @@ void GPU::WriteMemory(uint16 address, uint8 Value)
 	if (address >= 0x8000 && address <= 0x9FFF)
 	{
 		m_VRAM[address - 0x8000] = Value;
+		m_TileCache.Invalidate(address - 0x8000);
+		if (m_RenderThread != nullptr)
+		{
+			m_RenderThread->PushVRAMWrite(address - 0x8000, Value);
+		}
 	}
 	else if (address >= 0xFE00 && address <= 0xFE9F)
 	{
-		m_OAM[address - 0xFE00] = Value;
+		WriteOAM(uint8(address - 0xFE00), Value);
 	}
 
 	switch (address)
 	{
 	case MemRegisters::LCDC:
 	{
+		Sync(m_CPU->GetCycleCount());
 		m_LCDControl = Value;
+		ScheduleNextMode();
 	}
 	break;
 	case MemRegisters::LCDStatus:
 	{
 		//no bits 0-2
+		Sync(m_CPU->GetCycleCount());
 		m_LCDStatus = Value;// (Value & 0xF8) | (LCDStatus & 0x07);
+		ScheduleNextMode();
 	}
 	break;
 	case MemRegisters::ScrollX:
@@ -134,10 +398,20 @@ void GPU::WriteMemory(uint16 address, uint8 Value)
 		m_OBJPalette1 = Value;
 		break;
 	case MemRegisters::LY:
+		Sync(m_CPU->GetCycleCount());
 		m_LY = Value;
+		if (IsLCDEnabled())
+		{
+			UpdateCoincidence();
+		}
 		break;
 	case MemRegisters::LYCompare:
+		Sync(m_CPU->GetCycleCount());
 		m_LYCompare = Value;
+		if (IsLCDEnabled())
+		{
+			UpdateCoincidence();
+		}
 		break;
 	case MemRegisters::DMATransfer:
 		FireDMATransfer(Value);
@@ -147,44 +421,17 @@ void GPU::WriteMemory(uint16 address, uint8 Value)
 	}
 }
 
-uint16 GPU::GetBGTileMapAddress()
-{
-	bool BGPosition = GetBit(3, m_LCDControl);
-
-	return BGPosition ? MemAreas::BgTileMapBit31 : MemAreas::BgTileMapBit30;
-}
-
-uint16 GPU::GetWinTileMapAddress()
-{
-	bool WinPosition = GetBit(6, m_LCDControl);
-	return WinPosition ? MemAreas::WindowTileMapBit61 : MemAreas::WindowTileMapBit60;
-}
-
-bool GPU::IsBGEnabled()
-{
-	return GetBit(0, m_LCDControl);
-}
-
-bool GPU::IsWinEnabled()
+void GPU::MapPages(GameBoyMemory* Memory)
 {
-	return GetBit(0, m_LCDControl) && GetBit(5, m_LCDControl);
-}
-
-uint16 GPU::GetBGWinTileDataAddress()
-{
-	bool BGPosition = GetBit(4, m_LCDControl);
-
-	return BGPosition ? MemAreas::BgWinTileMapUnsignedBit41 : MemAreas::BgWinTileMapSignedBit40;
+	//tile data writes go through WriteMemory to invalidate the tile cache, the maps can be written directly
+	//unless a render thread needs to see every write
+	uint8* MapWrites = (m_RenderThread == nullptr) ? m_VRAM + GBTileCache::TileDataSize : nullptr;
+	Memory->MapPageRange(this, 0x8000, 0x97FF, m_VRAM, nullptr);
+	Memory->MapPageRange(this, 0x9800, 0x9FFF, m_VRAM + GBTileCache::TileDataSize, MapWrites);
 }
 
-void GPU::Update(uint32 cycles)
+void GPU::UpdateMode()
 {
-	if (m_DMATransferRemainingCycles > 0)
-	{
-		//is this needed?
-		m_DMATransferRemainingCycles -= cycles;
-	}
-
 	//LCD Managing
 	if (IsLCDEnabled())
 	{
@@ -192,8 +439,6 @@ void GPU::Update(uint32 cycles)
 		uint8 LCDState = m_LCDStatus;
 		uint8 Mode = LCDState & 0x03;
 
-		m_GPUModeCycles += cycles;
-
 		switch (Mode)
 		{
 		case GPUStates::HBlank:
@@ -249,6 +494,7 @@ void GPU::Update(uint32 cycles)
 			if (m_GPUModeCycles >= Timings::ReadingOAMCycles)
 			{
 				m_GPUModeCycles -= Timings::ReadingOAMCycles;
+				ScanOAM();
 				m_LCDStatus = ((LCDState & ~0x03) | GPUStates::ReadingOAMVRAM);
 
 			}
@@ -273,19 +519,7 @@ void GPU::Update(uint32 cycles)
 			break;
 		}
 
-		// Bit 2 - Coincidence Flag  (0:LYC<>LY, 1:LYC=LY) (Read Only)
-		if (m_LYCompare == m_LY)
-		{
-			m_LCDStatus = SetBit(2, m_LCDStatus, true);
-			if (GetBit(6, m_LCDStatus))
-			{
-				m_CPU->FireInterrupt(InterruptCodes::STAT);
-			}
-		}
-		else
-		{
-			m_LCDStatus = SetBit(2, m_LCDStatus, false);
-		}
+		UpdateCoincidence();
 
 		/*
 		//LY
@@ -3,46 +3,71 @@
 #include "Types.h"
 #include "MemoryElement.h"
 #include "Rendering.h"
+#include "Scheduler.h"
+#include "TileCache.h"
+#include "RenderThread.h"
+#include "SaveState.h"
 
-class GPU : public IMemoryElement
+class GPU : public IMemoryElement, public IEventHandler
 {
 public:
-	friend class GBRendering;
+	static constexpr uint32 OAMEntryCount = 40;
+	static constexpr uint32 MaxSpritesPerLine = GBLineState::MaxSpritesPerLine;
 
 	GPU(class GameBoyCPU* InCPU);
 
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 value) override;
+	virtual void MapPages(class GameBoyMemory* Memory) override;
+	virtual void OnEvent(uint8 EventId, uint64 Deadline, uint64 Now) override;
 
-	void Update(uint32 Cycles);
-	void RenderScreen()
-	{
-		m_Rendering.Render(m_CPU);
-	}
+	//Hands drawing and presenting to a render thread, must happen before the GPU's memory is registered.
+	//The GPU keeps deciding frame skips, GetFrameBuffer stays empty
+	void SetRenderThread(GBRenderThread* RenderThread);
+
+	void RenderScreen();
 	void RenderScanline();
+	const GBColor* GetFrameBuffer() const { return m_Rendering.GetFrameBuffer(); }
+	GBRendering& GetRendering() { return m_Rendering; }
 	bool IsLCDEnabled();
-	bool PollEvents()
-	{
-		return m_Rendering.PollEvents();
-	}
 
-	uint16 GetBGTileMapAddress();
-	uint16 GetWinTileMapAddress();
-	uint16 GetBGWinTileDataAddress();
-	bool IsBGEnabled();
-	bool IsWinEnabled();
+	//the mode event is restored with the scheduler. Loading only touches the VRAM and OAM bytes
+	//that differ, so tile cache and render thread work stays proportional to the change
+	void SaveState(GBGPUState& State) const;
+	void LoadState(const GBGPUState& State);
 
 private:
 
 	void FireDMATransfer(uint8 address);
 
+	//OAM writes keep the per line sprite masks in sync
+	void WriteOAM(uint8 Offset, uint8 Value);
+	void SetSpriteLines(uint32 Entry, uint8 PosY, bool Covered);
+	void RebuildSpriteLines();
+	//mode 2: picks the sprites of the current line in drawing priority order
+	void ScanOAM();
+
+	//Sync only accumulates mode cycles, mode changes happen on the scheduled event
+	void Sync(uint64 Now);
+	void UpdateMode();
+	void ScheduleNextMode();
+	void UpdateCoincidence();
+
 	GBRendering m_Rendering;
+	GBRenderThread* m_RenderThread = nullptr;
 	int32 m_GPUModeCycles;
+	uint64 m_LastUpdateCycle = 0;
 	int32 m_DMATransferRemainingCycles = 0;
 
 	GameBoyCPU* m_CPU = nullptr;
-	uint8 m_VRAM[0x2000];
-	uint8 m_OAM[0x100];
+	uint8 m_VRAM[0x2000] = {};
+	uint8 m_OAM[0x100] = {};
+	GBTileCache m_TileCache;
+
+	//bit N is set on the lines OAM entry N covers, one table for 8x8 and one for 8x16 sprites
+	uint64 m_SpriteLineMasks[2][ScreenData::SizeY];
+	//sprites come from the OAM scan, registers are captured when the line is drawn
+	GBLineState m_LineState;
 
 	uint8 m_LY;
 	uint8 m_LYCompare;
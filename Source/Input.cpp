@@ -1,55 +1,18 @@
 #include "Input.h"
 #include "CPU.h"
-#include "SDL.h"
 #include "BinaryOps.h"
 
 using namespace BinaryOps;
 
 void GBInput::Update()
 {
-	SDL_PumpEvents();
-	const Uint8 *keys = SDL_GetKeyboardState(NULL);
 	uint8 nJoypad = JOYPAD_NONE;
 	uint8 nButtons = JOYPAD_NONE;
 
-	if (keys[SDL_SCANCODE_UP])
+	IInputSource* Source = m_CPU->GetPlatform().Input;
+	if (Source != nullptr)
 	{
-		nJoypad |= JOYPAD_INPUT_UP;
-	}
-
-	if (keys[SDL_SCANCODE_LEFT])
-	{
-		nJoypad |= JOYPAD_INPUT_LEFT;
-	}
-
-	if (keys[SDL_SCANCODE_DOWN])
-	{
-		nJoypad |= JOYPAD_INPUT_DOWN;
-	}
-
-	if (keys[SDL_SCANCODE_RIGHT])
-	{
-		nJoypad |= JOYPAD_INPUT_RIGHT;
-	}
-
-	if (keys[SDL_SCANCODE_Z])
-	{
-		nButtons |= JOYPAD_BUTTONS_A;
-	}
-
-	if (keys[SDL_SCANCODE_X])
-	{
-		nButtons |= JOYPAD_BUTTONS_B;
-	}
-
-	if (keys[SDL_SCANCODE_RETURN])
-	{
-		nButtons |= JOYPAD_BUTTONS_START;
-	}
-
-	if (keys[SDL_SCANCODE_RSHIFT])
-	{
-		nButtons |= JOYPAD_BUTTONS_SELECT;
+		Source->GetInputState(nJoypad, nButtons);
 	}
 
 	uint8 inputChanges = !GetBit(4, m_SelectColumn) ? (m_Joypad ^ nJoypad) : 0x00;
@@ -65,6 +28,12 @@ void GBInput::Update()
 	}
 }
 
+bool GBInput::PollEvents()
+{
+	IInputSource* Source = m_CPU->GetPlatform().Input;
+	return (Source != nullptr) ? Source->PollEvents() : true;
+}
+
 uint8& GBInput::ReadMemory(uint16 address)
 {
 	static uint8 Zero = 0;
@@ -105,4 +74,18 @@ void GBInput::WriteMemory(uint16 address, uint8 Value)
 	default:
 		break;
 	}
+}
+
+void GBInput::SaveState(GBInputState& State) const
+{
+	State.SelectColumn = m_SelectColumn;
+	State.Buttons = m_Buttons;
+	State.Joypad = m_Joypad;
+}
+
+void GBInput::LoadState(const GBInputState& State)
+{
+	m_SelectColumn = State.SelectColumn;
+	m_Buttons = State.Buttons;
+	m_Joypad = State.Joypad;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Types.h"
 #include "Constants.h"
 #include "MemoryElement.h"
+#include "SaveState.h"
 
 #define JOYPAD_NONE             0
 
@@ -24,9 +25,13 @@ public:
 	{}
 
 	void Update();
+	bool PollEvents();
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 Value) override;
 
+	void SaveState(GBInputState& State) const;
+	void LoadState(const GBInputState& State);
+
 private:
 	GameBoyCPU* m_CPU = nullptr;
 	uint8 m_SelectColumn = 0xff; //all buttons depressed
@@ -34,5 +39,4 @@ private:
 	uint8 m_Joypad = 0xFF;
 
 	uint8 m_CurrentRetVal = 0;
-	uint8 m_FromSDL = 0;
 };
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "LineCompositor.h"
+#include "Rendering.h"
+#include <assert.h>
+
+#if GB_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if GB_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+static_assert(sizeof(GBColor) == sizeof(uint32), "colors are moved around as 32 bit lanes");
+
+namespace
+{
+	uint32 ToLane(const GBColor& Color)
+	{
+		uint32 Lane;
+		memcpy(&Lane, &Color, sizeof(Lane));
+		return Lane;
+	}
+
+#if GB_SIMD_SSE2
+	//4 indices in the low 4 bytes of Indices to 4 colors, SSE2 has no variable shuffle so select by compare
+	inline __m128i LookupColors4(__m128i Indices, const __m128i* Palette)
+	{
+		__m128i Zero = _mm_setzero_si128();
+		__m128i Lanes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(Indices, Zero), Zero);
+
+		__m128i Result = _mm_and_si128(_mm_cmpeq_epi32(Lanes, Zero), Palette[0]);
+		Result = _mm_or_si128(Result, _mm_and_si128(_mm_cmpeq_epi32(Lanes, _mm_set1_epi32(1)), Palette[1]));
+		Result = _mm_or_si128(Result, _mm_and_si128(_mm_cmpeq_epi32(Lanes, _mm_set1_epi32(2)), Palette[2]));
+		Result = _mm_or_si128(Result, _mm_and_si128(_mm_cmpeq_epi32(Lanes, _mm_set1_epi32(3)), Palette[3]));
+		return Result;
+	}
+
+	inline void SplatPalette(const GBColor* Palette, __m128i* Out)
+	{
+		for (int32 i = 0; i < 4; ++i)
+		{
+			Out[i] = _mm_set1_epi32(int32(ToLane(Palette[i])));
+		}
+	}
+
+	//one byte per pixel row pair (8 copies of row N, 8 of row N+1) to 16 indices
+	inline __m128i DecodeRowPair(__m128i Low, __m128i High)
+	{
+		const __m128i BitMask = _mm_setr_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+		__m128i LowBits = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(Low, BitMask), BitMask), _mm_set1_epi8(1));
+		__m128i HighBits = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(High, BitMask), BitMask), _mm_set1_epi8(2));
+		return _mm_or_si128(LowBits, HighBits);
+	}
+#endif
+
+#if GB_SIMD_AVX2
+	inline __m256i LoadPalette8(const GBColor* Palette)
+	{
+		int32 P0 = int32(ToLane(Palette[0]));
+		int32 P1 = int32(ToLane(Palette[1]));
+		int32 P2 = int32(ToLane(Palette[2]));
+		int32 P3 = int32(ToLane(Palette[3]));
+		return _mm256_setr_epi32(P0, P1, P2, P3, P0, P1, P2, P3);
+	}
+#endif
+}
+
+void LineCompositor::DecodeTileScalar(const uint8* TileData, uint8* Indices)
+{
+	for (int32 Row = 0; Row < 8; ++Row)
+	{
+		uint8 Low = TileData[Row * 2];
+		uint8 High = TileData[Row * 2 + 1];
+
+		for (int32 X = 0; X < 8; ++X)
+		{
+			int32 Bit = 7 - X;
+			*Indices++ = uint8(((Low >> Bit) & 1) | (((High >> Bit) & 1) << 1));
+		}
+	}
+}
+
+void LineCompositor::ApplyPaletteScalar(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count)
+{
+	for (int32 i = 0; i < Count; ++i)
+	{
+		Out[i] = Palette[Indices[i]];
+	}
+}
+
+void LineCompositor::DrawSpriteRowScalar(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out)
+{
+	for (int32 X = 0; X < 8; ++X)
+	{
+		uint8 Col = Indices[X];
+		if ((Col != 0x00) && (!BehindBG || (BGIndices[X] == 0)))
+		{
+			Out[X] = Palette[Col];
+		}
+	}
+}
+
+#if GB_SIMD_SSE2
+void LineCompositor::DecodeTileSSE2(const uint8* TileData, uint8* Indices)
+{
+	//split the interleaved bitplanes, then broadcast every row byte across the 8 pixels it covers
+	__m128i Tile = _mm_loadu_si128(reinterpret_cast<const __m128i*>(TileData));
+	__m128i Zero = _mm_setzero_si128();
+	__m128i Lows = _mm_packus_epi16(_mm_and_si128(Tile, _mm_set1_epi16(0x00FF)), Zero);
+	__m128i Highs = _mm_packus_epi16(_mm_srli_epi16(Tile, 8), Zero);
+
+	__m128i Low2 = _mm_unpacklo_epi8(Lows, Lows);
+	__m128i High2 = _mm_unpacklo_epi8(Highs, Highs);
+	__m128i Low4[2] = { _mm_unpacklo_epi16(Low2, Low2), _mm_unpackhi_epi16(Low2, Low2) };
+	__m128i High4[2] = { _mm_unpacklo_epi16(High2, High2), _mm_unpackhi_epi16(High2, High2) };
+
+	__m128i* Dest = reinterpret_cast<__m128i*>(Indices);
+	for (int32 Half = 0; Half < 2; ++Half)
+	{
+		_mm_storeu_si128(Dest++, DecodeRowPair(_mm_unpacklo_epi32(Low4[Half], Low4[Half]), _mm_unpacklo_epi32(High4[Half], High4[Half])));
+		_mm_storeu_si128(Dest++, DecodeRowPair(_mm_unpackhi_epi32(Low4[Half], Low4[Half]), _mm_unpackhi_epi32(High4[Half], High4[Half])));
+	}
+}
+
+void LineCompositor::ApplyPaletteSSE2(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count)
+{
+	__m128i Palette4[4];
+	SplatPalette(Palette, Palette4);
+
+	int32 i = 0;
+	for (; i + 16 <= Count; i += 16)
+	{
+		__m128i Lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Indices + i));
+		__m128i* Dest = reinterpret_cast<__m128i*>(Out + i);
+		_mm_storeu_si128(Dest + 0, LookupColors4(Lanes, Palette4));
+		_mm_storeu_si128(Dest + 1, LookupColors4(_mm_srli_si128(Lanes, 4), Palette4));
+		_mm_storeu_si128(Dest + 2, LookupColors4(_mm_srli_si128(Lanes, 8), Palette4));
+		_mm_storeu_si128(Dest + 3, LookupColors4(_mm_srli_si128(Lanes, 12), Palette4));
+	}
+
+	ApplyPaletteScalar(Indices + i, Palette, Out + i, Count - i);
+}
+
+void LineCompositor::DrawSpriteRowSSE2(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out)
+{
+	__m128i Palette4[4];
+	SplatPalette(Palette, Palette4);
+
+	__m128i Zero = _mm_setzero_si128();
+	__m128i Lanes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Indices));
+	__m128i Visible = _mm_andnot_si128(_mm_cmpeq_epi8(Lanes, Zero), _mm_set1_epi8(-1));
+	if (BehindBG)
+	{
+		__m128i BGLanes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(BGIndices));
+		Visible = _mm_and_si128(Visible, _mm_cmpeq_epi8(BGLanes, Zero));
+	}
+
+	//widen the byte mask to one 32 bit mask per pixel
+	__m128i Visible16 = _mm_unpacklo_epi8(Visible, Visible);
+	__m128i Masks[2] = { _mm_unpacklo_epi16(Visible16, Visible16), _mm_unpackhi_epi16(Visible16, Visible16) };
+
+	//the byte shift needs an immediate, so no loop here
+	__m128i Colors[2] = { LookupColors4(Lanes, Palette4), LookupColors4(_mm_srli_si128(Lanes, 4), Palette4) };
+
+	__m128i* Dest = reinterpret_cast<__m128i*>(Out);
+	for (int32 Half = 0; Half < 2; ++Half)
+	{
+		__m128i Old = _mm_loadu_si128(Dest + Half);
+		_mm_storeu_si128(Dest + Half, _mm_or_si128(_mm_and_si128(Masks[Half], Colors[Half]), _mm_andnot_si128(Masks[Half], Old)));
+	}
+}
+#endif
+
+#if GB_SIMD_AVX2
+void LineCompositor::ApplyPaletteAVX2(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count)
+{
+	__m256i Palette8 = LoadPalette8(Palette);
+
+	int32 i = 0;
+	for (; i + 8 <= Count; i += 8)
+	{
+		__m256i Lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Indices + i)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + i), _mm256_permutevar8x32_epi32(Palette8, Lanes));
+	}
+
+	ApplyPaletteScalar(Indices + i, Palette, Out + i, Count - i);
+}
+
+void LineCompositor::DrawSpriteRowAVX2(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out)
+{
+	__m256i Lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Indices)));
+	__m256i Zero = _mm256_setzero_si256();
+	__m256i Visible = _mm256_xor_si256(_mm256_cmpeq_epi32(Lanes, Zero), _mm256_set1_epi32(-1));
+	if (BehindBG)
+	{
+		__m256i BGLanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(BGIndices)));
+		Visible = _mm256_and_si256(Visible, _mm256_cmpeq_epi32(BGLanes, Zero));
+	}
+
+	__m256i* Dest = reinterpret_cast<__m256i*>(Out);
+	__m256i Colors = _mm256_permutevar8x32_epi32(LoadPalette8(Palette), Lanes);
+	_mm256_storeu_si256(Dest, _mm256_blendv_epi8(_mm256_loadu_si256(Dest), Colors, Visible));
+}
+#endif
+
+void LineCompositor::DecodeTile(const uint8* TileData, uint8* Indices)
+{
+#if GB_SIMD_SSE2
+	DecodeTileSSE2(TileData, Indices);
+
+#if DEBUG && VERIFY_LINE_COMPOSITOR
+	uint8 Reference[64];
+	DecodeTileScalar(TileData, Reference);
+	assert(memcmp(Reference, Indices, sizeof(Reference)) == 0);
+#endif
+#else
+	DecodeTileScalar(TileData, Indices);
+#endif
+}
+
+void LineCompositor::ApplyPalette(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count)
+{
+#if GB_SIMD_AVX2
+	ApplyPaletteAVX2(Indices, Palette, Out, Count);
+#elif GB_SIMD_SSE2
+	ApplyPaletteSSE2(Indices, Palette, Out, Count);
+#else
+	ApplyPaletteScalar(Indices, Palette, Out, Count);
+#endif
+
+#if DEBUG && VERIFY_LINE_COMPOSITOR
+	for (int32 Pixel = 0; Pixel < Count; ++Pixel)
+	{
+		assert(ToLane(Out[Pixel]) == ToLane(Palette[Indices[Pixel]]));
+	}
+#endif
+}
+
+void LineCompositor::DrawSpriteRow(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out)
+{
+#if DEBUG && VERIFY_LINE_COMPOSITOR
+	GBColor Reference[8];
+	memcpy(Reference, Out, sizeof(Reference));
+	DrawSpriteRowScalar(Indices, Palette, BehindBG, BGIndices, Reference);
+#endif
+
+#if GB_SIMD_AVX2
+	DrawSpriteRowAVX2(Indices, Palette, BehindBG, BGIndices, Out);
+#elif GB_SIMD_SSE2
+	DrawSpriteRowSSE2(Indices, Palette, BehindBG, BGIndices, Out);
+#else
+	DrawSpriteRowScalar(Indices, Palette, BehindBG, BGIndices, Out);
+#endif
+
+#if DEBUG && VERIFY_LINE_COMPOSITOR
+	assert(memcmp(Reference, Out, sizeof(Reference)) == 0);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Types.h"
+
+struct GBColor;
+
+//AVX2 when the compiler targets it, SSE2 on any x86-64 build and plain C++ everywhere else
+#if defined(__AVX2__)
+#define GB_SIMD_AVX2 1
+#define GB_SIMD_SSE2 1
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define GB_SIMD_AVX2 0
+#define GB_SIMD_SSE2 1
+#else
+#define GB_SIMD_AVX2 0
+#define GB_SIMD_SSE2 0
+#endif
+
+//Debug builds with this set run the scalar path next to the vector one and assert both agree
+#ifndef VERIFY_LINE_COMPOSITOR
+#define VERIFY_LINE_COMPOSITOR 0
+#endif
+
+//Bulk pixel operations of the scanline renderer. Every function has a scalar reference
+//version the vector paths must match bit for bit, GameboyBatch -check-compositor compares them.
+namespace LineCompositor
+{
+	//16 bytes of tile data (2 bitplanes per row) to 64 color indices, leftmost pixel first
+	void DecodeTile(const uint8* TileData, uint8* Indices);
+
+	//Out[i] = Palette[Indices[i]]
+	void ApplyPalette(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count);
+
+	//8 sprite pixels in screen order. Index 0 is transparent and BehindBG sprites
+	//only cover pixels where the background drew color index 0
+	void DrawSpriteRow(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out);
+
+	void DecodeTileScalar(const uint8* TileData, uint8* Indices);
+	void ApplyPaletteScalar(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count);
+	void DrawSpriteRowScalar(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out);
+
+	//the vector paths this build has, the functions above pick the widest
+#if GB_SIMD_SSE2
+	void DecodeTileSSE2(const uint8* TileData, uint8* Indices);
+	void ApplyPaletteSSE2(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count);
+	void DrawSpriteRowSSE2(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out);
+#endif
+
+#if GB_SIMD_AVX2
+	//tiles are decoded by the SSE2 version, 16 bytes are all there is
+	void ApplyPaletteAVX2(const uint8* Indices, const GBColor* Palette, GBColor* Out, int32 Count);
+	void DrawSpriteRowAVX2(const uint8* Indices, const GBColor* Palette, bool BehindBG, const uint8* BGIndices, GBColor* Out);
+#endif
+}
\ No newline at end of file
@@ -1,8 +1,11 @@
 #include "Log.h"
-#include <xstring>
+#include <string>
 #include <stdarg.h>
+#include <stdio.h>
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#endif
 
 void Log::log(const char* format, ...)
 {
@@ -14,10 +17,12 @@ void Log::log(const char* format, ...)
 	char buffer[10 * 1024];
 	va_list argptr;
 	va_start(argptr, format);
-	vsprintf_s(buffer, 10 * 1024, stringWithReturn.c_str(), argptr);
+	vsnprintf(buffer, sizeof(buffer), stringWithReturn.c_str(), argptr);
 	va_end(argptr);
 
 	printf("%s", buffer);
+#if defined(_WIN32)
 	OutputDebugString(buffer);
 #endif
+#endif
 }
\ No newline at end of file
@@ -9,4 +9,6 @@ public:
 	virtual uint8& ReadMemory(uint16 address) = 0;
 	virtual void WriteMemory(uint16 address, uint8 value) = 0;
 
+	//called when the element gets registered, plain memory can be exposed here as direct page pointers
+	virtual void MapPages(class GameBoyMemory* /*Memory*/) {}
 };
\ No newline at end of file
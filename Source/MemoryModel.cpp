@@ -13,21 +13,140 @@ void GameBoyMemory::RegisterElementRange(uint16 From, uint16 To, IMemoryElement*
 	{
 		m_MemoryMap[i] = Pointer;
 	}
+
+	for (uint32 page = (From >> 8); page <= uint32(To >> 8); ++page)
+	{
+		UpdatePageOwner(page);
+	}
+
+	Pointer->MapPages(this);
 }
 
 void GameBoyMemory::RegisterElement(uint16 Address, IMemoryElement* Pointer)
 {
-	m_MemoryMap[Address] = Pointer;
+	RegisterElementRange(Address, Address, Pointer);
 }
 
-uint8& GameBoyMemory::Read(uint16 address )
+void GameBoyMemory::UpdatePageOwner(uint32 Page)
 {
-	return m_MemoryMap[address]->ReadMemory(address);
+	//a page can only be direct if a single element owns all of it
+	uint32 base = Page * PageSize;
+	IMemoryElement* owner = m_MemoryMap[base];
+	for (uint32 i = 1; i < PageSize; ++i)
+	{
+		if (m_MemoryMap[base + i] != owner)
+		{
+			owner = nullptr;
+			break;
+		}
+	}
+
+	m_PageOwner[Page] = owner;
+	m_ReadPages[Page] = nullptr;
+	m_WritePages[Page] = nullptr;
 }
 
-void GameBoyMemory::Write(uint16 address, uint8 Value)
+void GameBoyMemory::MapPageRange(IMemoryElement* Owner, uint16 From, uint16 To, uint8* ReadData, uint8* WriteData)
 {
-	m_MemoryMap[address]->WriteMemory(address, Value);
+	uint32 firstPage = From >> 8;
+	for (uint32 page = firstPage; page <= uint32(To >> 8); ++page)
+	{
+		if (m_PageOwner[page] != Owner)
+		{
+			continue;
+		}
+
+		uint32 offset = (page - firstPage) * PageSize;
+		m_ReadPages[page] = ReadData ? ReadData + offset : nullptr;
+		m_WritePages[page] = WriteData ? WriteData + offset : nullptr;
+	}
+
+	if (m_CodeWatcher != nullptr)
+	{
+		m_CodeWatcher->OnPagesRemapped();
+	}
+}
+
+void GameBoyMemory::UnmapPageRange(IMemoryElement* Owner, uint16 From, uint16 To)
+{
+	MapPageRange(Owner, From, To, nullptr, nullptr);
+}
+
+void GameBoyMemory::ProtectRAMPage(uint32 RAMPage)
+{
+	m_ProtectedRAMPages |= 1u << RAMPage;
+	m_WritePages[(0xC000 >> 8) + RAMPage] = nullptr;
+	if (RAMPage < 0x1E)
+	{
+		m_WritePages[(0xE000 >> 8) + RAMPage] = nullptr;
+	}
+}
+
+void GameBoyMemory::UnprotectRAMPage(uint32 RAMPage)
+{
+	m_ProtectedRAMPages &= ~(1u << RAMPage);
+	uint8* Data = m_InternalRAM + RAMPage * PageSize;
+	m_WritePages[(0xC000 >> 8) + RAMPage] = Data;
+	if (RAMPage < 0x1E)
+	{
+		m_WritePages[(0xE000 >> 8) + RAMPage] = Data;
+	}
+}
+
+void GameBoyMemory::UnprotectAllRAM()
+{
+	for (uint32 RAMPage = 0; RAMPage < InternalRAMSize / PageSize; ++RAMPage)
+	{
+		if (m_ProtectedRAMPages & (1u << RAMPage))
+		{
+			UnprotectRAMPage(RAMPage);
+		}
+	}
+}
+
+void GameBoyMemory::OnRAMWrite(uint16 address)
+{
+	uint32 RAMPage = ((address - 0xC000) & (InternalRAMSize - 1)) / PageSize;
+	if (m_ProtectedRAMPages & (1u << RAMPage))
+	{
+		UnprotectRAMPage(RAMPage);
+		m_CodeWatcher->OnCodeWritten(address);
+	}
+}
+
+void GameBoyMemory::MapPages(GameBoyMemory* /*Memory*/)
+{
+	MapPageRange(this, 0xC000, 0xDFFF, m_InternalRAM, m_InternalRAM);
+	MapPageRange(this, 0xE000, 0xFDFF, m_InternalRAM, m_InternalRAM); //RAM echo
+}
+
+void GameBoyMemory::SaveState(GBMemoryState& State) const
+{
+	memcpy(State.InternalRAM, m_InternalRAM, sizeof(m_InternalRAM));
+	memcpy(State.HInternalRAM, m_HInternalRAM, sizeof(m_HInternalRAM));
+	State.IsBooting = m_IsBooting;
+	State.InterruptFlags = m_InterruptFlags;
+	State.InterruptEnabled = m_InterruptEnabled;
+}
+
+void GameBoyMemory::LoadState(const GBMemoryState& State)
+{
+	//a code page only counts as written if the state holds other bytes there, so run-ahead and
+	//rewind keep their decoded blocks when the code in RAM didn't change
+	for (uint32 RAMPage = 0; RAMPage < InternalRAMSize / PageSize; ++RAMPage)
+	{
+		uint32 Offset = RAMPage * PageSize;
+		if ((m_ProtectedRAMPages & (1u << RAMPage)) && (memcmp(m_InternalRAM + Offset, State.InternalRAM + Offset, PageSize) != 0))
+		{
+			OnRAMWrite(uint16(0xC000 + Offset));
+		}
+	}
+
+	memcpy(m_InternalRAM, State.InternalRAM, sizeof(m_InternalRAM));
+	memcpy(m_HInternalRAM, State.HInternalRAM, sizeof(m_HInternalRAM));
+	m_IsBooting = State.IsBooting;
+	m_InterruptFlags = State.InterruptFlags;
+	m_InterruptEnabled = State.InterruptEnabled;
 }
 
 uint8& GameBoyMemory::ReadMemory(uint16 address)
@@ -70,11 +189,13 @@ void GameBoyMemory::WriteMemory(uint16 address, uint8 Value)
 	if (address >= 0xC000 && address <= 0xDFFF)
 	{
 		//RAM
+		OnRAMWrite(address);
 		m_InternalRAM[address - 0xC000] = Value;
 	}
 	else if (address >= 0xE000 && address <= 0xFDFF)
 	{
 		//RAM echo
+		OnRAMWrite(address);
 		m_InternalRAM[address - 0xE000] = Value;
 	}
 	else if (address >= 0xFF80 && address <= 0xFFFE)
@@ -98,7 +219,14 @@ void GameBoyMemory::WriteMemory(uint16 address, uint8 Value)
 
 uint8& MEM_ROMOnly::ReadMemory(uint16 address)
 {
-	return m_ROM[address];
+	if (address <= 0x7FFF)
+	{
+		return m_ROM[address];
+	}
+
+	//no cartridge RAM, A000-BFFF reads open bus
+	static uint8 FF = 0xFF;
+	return FF;
 }
 
 void MEM_ROMOnly::WriteMemory(uint16 address, uint8 Value)
@@ -106,6 +234,16 @@ void MEM_ROMOnly::WriteMemory(uint16 address, uint8 Value)
 	
 }
 
+void MEM_ROMOnly::UpdatePages()
+{
+	if (m_Memory == nullptr)
+	{
+		return;
+	}
+
+	m_Memory->MapPageRange(m_Owner, 0x0000, 0x7FFF, m_ROM, nullptr);
+}
+
 
 MEM_MBC1::MEM_MBC1(uint8* pROM, uint8* pRAM) :
 	IROMMemoryModel(pROM, pRAM),
@@ -133,15 +271,8 @@ uint8& MEM_MBC1::ReadMemory(uint16 address)
 		Banks (almost 2MByte). As described below, bank numbers 20h, 40h, and 60h cannot be used, resulting
 		in the odd amount of 125 banks.
 		*/
-		uint8 targetBank = m_ROMBankLower;
-		if (m_ROMRAMMode == ROMBankMode)
-		{
-			// The upper bank values are only available in ROM Bank Mode
-			targetBank |= (m_ROMRAMBankUpper << 4);
-		}
-
 		unsigned int target = (address - 0x4000);
-		target += (0x4000 * targetBank);
+		target += (0x4000 * GetTargetROMBank());
 		return m_ROM[target];
 	}
 	else if (address >= 0xA000 && address <= 0xBFFF)
@@ -166,14 +297,8 @@ uint8& MEM_MBC1::ReadMemory(uint16 address)
 			return FF;
 		}
 
-		// In ROM Mode, only bank 0x00 is available
 		unsigned int target = address - 0xA000;
-		if (m_ROMRAMMode == RAMBankMode)
-		{
-			// Offset based on the bank number
-			target += (0x2000 * m_ROMRAMBankUpper);
-		}
-
+		target += GetRAMBankOffset();
 		return m_RAM[target];
 	}
 
@@ -195,6 +320,7 @@ void MEM_MBC1::WriteMemory(uint16 address, uint8 Value)
 		Practically any value with 0Ah in the lower 4 bits enables RAM, and any other value disables RAM.
 		*/
 		m_IsRAMEnabled = ((Value & EnableRAM) == EnableRAM);
+		UpdatePages();
 		return;
 	}
 	else if (address <= 0x3FFF)
@@ -213,6 +339,7 @@ void MEM_MBC1::WriteMemory(uint16 address, uint8 Value)
 			m_ROMBankLower = 0x01;
 		}
 
+		UpdatePages();
 		return;
 	}
 	else if (address <= 0x5FFF)
@@ -224,6 +351,7 @@ void MEM_MBC1::WriteMemory(uint16 address, uint8 Value)
 		*/
 
 		m_ROMRAMBankUpper = Value & 0x03;
+		UpdatePages();
 		return;
 	}
 	else if (address <= 0x7FFF)
@@ -238,6 +366,7 @@ void MEM_MBC1::WriteMemory(uint16 address, uint8 Value)
 		can be used during Mode 0, and only ROM Banks 00-1Fh can be used during Mode 1.
 		*/
 		m_ROMRAMMode = Value & 0x01;
+		UpdatePages();
 		return;
 	}
 	else if (address >= 0xA000 && address <= 0xBFFF)
@@ -262,20 +391,73 @@ void MEM_MBC1::WriteMemory(uint16 address, uint8 Value)
 			return;
 		}
 
-		// In ROM Mode, only bank 0x00 is available
 		unsigned int target = address - 0xA000;
-		if (m_ROMRAMMode == RAMBankMode)
-		{
-			// Offset based on the bank number
-			target += (0x2000 * m_ROMRAMBankUpper);
-		}
-
+		target += GetRAMBankOffset();
 		m_RAM[target] = Value;
 		return;
 	}
 
 }
 
+uint8 MEM_MBC1::GetTargetROMBank() const
+{
+	uint8 targetBank = m_ROMBankLower;
+	if (m_ROMRAMMode == ROMBankMode)
+	{
+		// The upper bank values are only available in ROM Bank Mode
+		targetBank |= (m_ROMRAMBankUpper << 4);
+	}
+	return targetBank;
+}
+
+uint32 MEM_MBC1::GetRAMBankOffset() const
+{
+	// In ROM Mode, only bank 0x00 is available
+	if (m_ROMRAMMode == RAMBankMode)
+	{
+		// Offset based on the bank number
+		return 0x2000 * m_ROMRAMBankUpper;
+	}
+	return 0;
+}
+
+void MEM_MBC1::SaveState(GBCartridgeState& State) const
+{
+	IROMMemoryModel::SaveState(State);
+	State.ROMBank = m_ROMBankLower;
+	State.ROMRAMBankUpper = m_ROMRAMBankUpper;
+	State.ROMRAMMode = m_ROMRAMMode;
+}
+
+void MEM_MBC1::LoadState(const GBCartridgeState& State)
+{
+	m_ROMBankLower = State.ROMBank;
+	m_ROMRAMBankUpper = State.ROMRAMBankUpper;
+	m_ROMRAMMode = State.ROMRAMMode;
+	IROMMemoryModel::LoadState(State);
+}
+
+void MEM_MBC1::UpdatePages()
+{
+	if (m_Memory == nullptr)
+	{
+		return;
+	}
+
+	m_Memory->MapPageRange(m_Owner, 0x0000, 0x3FFF, m_ROM, nullptr);
+	m_Memory->MapPageRange(m_Owner, 0x4000, 0x7FFF, m_ROM + (0x4000 * GetTargetROMBank()), nullptr);
+
+	if (m_IsRAMEnabled && (m_RAM != nullptr))
+	{
+		uint8* bank = m_RAM + GetRAMBankOffset();
+		m_Memory->MapPageRange(m_Owner, 0xA000, 0xBFFF, bank, bank);
+	}
+	else
+	{
+		m_Memory->UnmapPageRange(m_Owner, 0xA000, 0xBFFF);
+	}
+}
+
 MEM_MBC2::MEM_MBC2(uint8* pROM, uint8* pRAM) :
 	IROMMemoryModel(pROM, pRAM),
 	m_ROMBank(0x01)
@@ -338,6 +520,7 @@ void MEM_MBC2::WriteMemory(uint16 address, uint8 Value)
 		if ((address & 0x0100) == 0x0000)
 		{
 			m_IsRAMEnabled = ((Value & EnableRAM) == EnableRAM);
+			UpdatePages();
 			return;
 		}
 	}
@@ -356,6 +539,7 @@ void MEM_MBC2::WriteMemory(uint16 address, uint8 Value)
 		if ((address & 0x0100) == 0x0000)
 		{
 			m_ROMBank = (Value & 0x0F);
+			UpdatePages();
 			return;
 		}
 	}
@@ -379,12 +563,45 @@ void MEM_MBC2::WriteMemory(uint16 address, uint8 Value)
 	return;
 }
 
+void MEM_MBC2::SaveState(GBCartridgeState& State) const
+{
+	IROMMemoryModel::SaveState(State);
+	State.ROMBank = m_ROMBank;
+}
+
+void MEM_MBC2::LoadState(const GBCartridgeState& State)
+{
+	m_ROMBank = State.ROMBank;
+	IROMMemoryModel::LoadState(State);
+}
+
+void MEM_MBC2::UpdatePages()
+{
+	if (m_Memory == nullptr)
+	{
+		return;
+	}
+
+	m_Memory->MapPageRange(m_Owner, 0x0000, 0x3FFF, m_ROM, nullptr);
+	m_Memory->MapPageRange(m_Owner, 0x4000, 0x7FFF, m_ROM + (0x4000 * m_ROMBank), nullptr);
+
+	//writes stay on the slow path, only the lower 4 bits are stored
+	if (m_IsRAMEnabled)
+	{
+		m_Memory->MapPageRange(m_Owner, 0xA000, 0xA1FF, m_RAM, nullptr);
+	}
+	else
+	{
+		m_Memory->UnmapPageRange(m_Owner, 0xA000, 0xA1FF);
+	}
+}
+
 MEM_MBC3::MEM_MBC3(uint8* pROM, uint8* pRAM) :
 	IROMMemoryModel(pROM, pRAM),
 	m_ROMBank(0x01),
 	m_RAMBank(0x00)
 {
-	memset(m_RTCRegisters, 0x00, ARRAYSIZE(m_RTCRegisters));
+	memset(m_RTCRegisters, 0x00, sizeof(m_RTCRegisters));
 }
 
 
@@ -455,6 +672,7 @@ void MEM_MBC3::WriteMemory(uint16 address, uint8 Value)
 		to the RTC Registers! A value of 00h will disable either.
 		*/
 		m_IsRAMEnabled = ((Value & EnableRAM) == EnableRAM);
+		UpdatePages();
 		return;
 	}
 	else if (address <= 0x3FFF)
@@ -471,6 +689,7 @@ void MEM_MBC3::WriteMemory(uint16 address, uint8 Value)
 			m_ROMBank = 0x01;
 		}
 
+		UpdatePages();
 		return;
 	}
 	else if (address <= 0x5FFF)
@@ -484,6 +703,7 @@ void MEM_MBC3::WriteMemory(uint16 address, uint8 Value)
 		typically that is done by using address A000.
 		*/
 		m_RAMBank = Value;
+		UpdatePages();
 		return;
 	}
 	else if (address <= 0x7FFF)
@@ -536,4 +756,42 @@ void MEM_MBC3::WriteMemory(uint16 address, uint8 Value)
 	}
 
 	return;
+}
+
+void MEM_MBC3::SaveState(GBCartridgeState& State) const
+{
+	IROMMemoryModel::SaveState(State);
+	State.ROMBank = m_ROMBank;
+	State.RAMBank = m_RAMBank;
+	memcpy(State.RTCRegisters, m_RTCRegisters, sizeof(m_RTCRegisters));
+}
+
+void MEM_MBC3::LoadState(const GBCartridgeState& State)
+{
+	m_ROMBank = State.ROMBank;
+	m_RAMBank = State.RAMBank;
+	memcpy(m_RTCRegisters, State.RTCRegisters, sizeof(m_RTCRegisters));
+	IROMMemoryModel::LoadState(State);
+}
+
+void MEM_MBC3::UpdatePages()
+{
+	if (m_Memory == nullptr)
+	{
+		return;
+	}
+
+	m_Memory->MapPageRange(m_Owner, 0x0000, 0x3FFF, m_ROM, nullptr);
+	m_Memory->MapPageRange(m_Owner, 0x4000, 0x7FFF, m_ROM + (0x4000 * m_ROMBank), nullptr);
+
+	//RTC registers stay on the slow path
+	if (m_IsRAMEnabled && (m_RAM != nullptr) && (m_RAMBank <= 0x03))
+	{
+		uint8* bank = m_RAM + (0x2000 * m_RAMBank);
+		m_Memory->MapPageRange(m_Owner, 0xA000, 0xBFFF, bank, bank);
+	}
+	else
+	{
+		m_Memory->UnmapPageRange(m_Owner, 0xA000, 0xBFFF);
+	}
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "Types.h"
 #include "MemoryElement.h"
+#include "Constants.h"
+#include "SaveState.h"
 
 class IROMMemoryModel : public IMemoryElement
 {
@@ -14,11 +16,46 @@ public:
 		, m_RAM(InRAM)
 	{}
 
+	void BindPages(class GameBoyMemory* Memory, IMemoryElement* Owner)
+	{
+		m_Memory = Memory;
+		m_Owner = Owner;
+		UpdatePages();
+	}
+
+	//bank registers, the RAM itself belongs to the cartridge
+	virtual void SaveState(GBCartridgeState& State) const
+	{
+		State.IsRAMEnabled = m_IsRAMEnabled;
+	}
+
+	virtual void LoadState(const GBCartridgeState& State)
+	{
+		m_IsRAMEnabled = State.IsRAMEnabled != 0;
+		UpdatePages();
+	}
 
 protected:
+	//maps the currently selected banks as direct pages, must be called on every bank switch
+	virtual void UpdatePages() {}
+
 	uint8* m_ROM = nullptr;
 	uint8* m_RAM = nullptr;
 	bool m_IsRAMEnabled = false;
+
+	class GameBoyMemory* m_Memory = nullptr;
+	IMemoryElement* m_Owner = nullptr;
+};
+
+//Told about changes that can make decoded code stale
+class ICodeWatcher
+{
+public:
+	virtual ~ICodeWatcher() = default;
+	//a write hit an internal RAM page protected with ProtectRAMPage, the protection is already lifted
+	virtual void OnCodeWritten(uint16 Address) = 0;
+	//pages were mapped to different memory, a bank switch for instance
+	virtual void OnPagesRemapped() = 0;
 };
 
 class GameBoyMemory : public IMemoryElement
@@ -29,23 +66,81 @@ public:
 		RegisterElementRange(0x0000, 0xFFFF, this);
 	}
 
+	static constexpr uint32 PageSize = 0x100;
+	static constexpr uint32 PageCount = MemAreas::MemorySize / PageSize;
+
 	void RegisterElementRange(uint16 From, uint16 To, IMemoryElement* Pointer);
 	void RegisterElement(uint16 Address, IMemoryElement* Pointer);
 
-	uint8& Read(uint16 address);
-	void Write(uint16 address, uint8 Value);
+	//Pages are only mapped if Owner is registered for the whole page, anything else goes through the element
+	void MapPageRange(IMemoryElement* Owner, uint16 From, uint16 To, uint8* ReadData, uint8* WriteData);
+	void UnmapPageRange(IMemoryElement* Owner, uint16 From, uint16 To);
+
+	void SaveState(GBMemoryState& State) const;
+	void LoadState(const GBMemoryState& State);
+
+	//0xC000-0xDFFF
+	static constexpr uint32 InternalRAMSize = 0x2000;
+	const uint8* GetInternalRAM() const { return m_InternalRAM; }
+
+	//Code caches protect the internal RAM pages they decoded from, the next write to the page (or its
+	//echo) goes through the slow path and tells the watcher. RAMPage counts from 0xC000
+	void SetCodeWatcher(ICodeWatcher* Watcher) { m_CodeWatcher = Watcher; }
+	void ProtectRAMPage(uint32 RAMPage);
+	void UnprotectRAMPage(uint32 RAMPage);
+	void UnprotectAllRAM();
+
+	//host memory behind a direct page, nullptr for I/O or mixed pages
+	const uint8* GetReadPage(uint16 address) const { return m_ReadPages[address >> 8]; }
+	uint8* const* GetReadPages() const { return m_ReadPages; }
+	uint8* const* GetWritePages() const { return m_WritePages; }
+
+	//IE & IF as ManageInterrupts sees them, without going through the register elements
+	bool HasPendingInterrupt() const { return (m_InterruptEnabled & m_InterruptFlags & 0x0F) != 0; }
+
+	uint8& Read(uint16 address)
+	{
+		uint8* page = m_ReadPages[address >> 8];
+		if (page != nullptr)
+		{
+			return page[address & 0xFF];
+		}
+		return m_MemoryMap[address]->ReadMemory(address);
+	}
+
+	void Write(uint16 address, uint8 Value)
+	{
+		uint8* page = m_WritePages[address >> 8];
+		if (page != nullptr)
+		{
+			page[address & 0xFF] = Value;
+			return;
+		}
+		m_MemoryMap[address]->WriteMemory(address, Value);
+	}
 
 private:
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 Value) override;
+	virtual void MapPages(GameBoyMemory* /*Memory*/) override;
+
+	void UpdatePageOwner(uint32 Page);
+	void OnRAMWrite(uint16 address);
 
 	IMemoryElement* m_MemoryMap[0x10000];
 
-	uint8 m_InternalRAM[0x2000]; //8k Internal RAM -> 0xC000
-	uint8 m_HInternalRAM[0x7F]; // High internal RAM -> 0xFF80
-	uint8 m_IsBooting;
-	uint8 m_InterruptFlags;
-	uint8 m_InterruptEnabled;
+	//Fast path, direct host pointers for plain RAM/ROM pages, nullptr means I/O or mixed page
+	uint8* m_ReadPages[PageCount];
+	uint8* m_WritePages[PageCount];
+	IMemoryElement* m_PageOwner[PageCount];
+
+	uint8 m_InternalRAM[InternalRAMSize] = {}; //8k Internal RAM -> 0xC000
+	uint8 m_HInternalRAM[0x7F] = {}; // High internal RAM -> 0xFF80
+	ICodeWatcher* m_CodeWatcher = nullptr;
+	uint32 m_ProtectedRAMPages = 0;
+	uint8 m_IsBooting = 0;
+	uint8 m_InterruptFlags = 0;
+	uint8 m_InterruptEnabled = 0;
 };
 
 
@@ -59,6 +154,9 @@ public:
 
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 Value) override;
+
+protected:
+	virtual void UpdatePages() override;
 };
 
 class MEM_MBC2 : public IROMMemoryModel
@@ -69,6 +167,11 @@ public:
 
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 Value) override;
+	virtual void SaveState(GBCartridgeState& State) const override;
+	virtual void LoadState(const GBCartridgeState& State) override;
+
+protected:
+	virtual void UpdatePages() override;
 
 private:
 	uint8 m_ROMBank;
@@ -82,8 +185,16 @@ public:
 
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 Value) override;
+	virtual void SaveState(GBCartridgeState& State) const override;
+	virtual void LoadState(const GBCartridgeState& State) override;
+
+protected:
+	virtual void UpdatePages() override;
 
 private:
+	uint8 GetTargetROMBank() const;
+	uint32 GetRAMBankOffset() const;
+
 	uint8 m_ROMBankLower;
 	uint8 m_ROMRAMBankUpper;
 	uint8 m_ROMRAMMode;
@@ -97,6 +208,11 @@ public:
 
 	virtual uint8& ReadMemory(uint16 address) override;
 	virtual void WriteMemory(uint16 address, uint8 Value) override;
+	virtual void SaveState(GBCartridgeState& State) const override;
+	virtual void LoadState(const GBCartridgeState& State) override;
+
+protected:
+	virtual void UpdatePages() override;
 
 private:
 	uint8 m_ROMBank;
@@ -60,13 +60,13 @@ inline void GameBoyCPU::DEC_16REG(uint16& Dest, const char* DebugString)
 
 inline void GameBoyCPU::INC_8REG(uint8& Dest, const char* DebugString, int AdditionalCycles)
 {
-	bool bit3Before = GetBit(3, Dest);
+	uint8 Before = Dest;
 	++Dest;
-	bool bit3After = GetBit(3, Dest);
 
-	SetValZ(Dest == 0);
-	ResetFlagN();
-	SetValH(bit3Before != bit3After);
+	//C is left alone
+	m_FlagZero = Dest;
+	m_FlagN = false;
+	m_FlagHalf = Before ^ Dest;
 	m_Cycles += 4 + AdditionalCycles;
 	DEBUGTEXT("INC " + std::string(DebugString));
 }
@@ -75,9 +75,9 @@ inline void GameBoyCPU::DEC_8REG(uint8& Dest, const char* DebugString, int Addit
 {
 	uint8 result = Dest - 1;
 
-	SetValZ(result == 0);
-	SetFlagN();
-	SetValH(((result ^ 0x01 ^ Dest) & 0x10) == 0x10);
+	m_FlagZero = result;
+	m_FlagN = true;
+	m_FlagHalf = result ^ Dest;
 	m_Cycles += 4 + AdditionalCycles;
 	Dest = result;
 
@@ -92,104 +92,68 @@ inline void GameBoyCPU::LD_8REG_N(uint8& Dest, const char* DebugString)
 	DEBUGTEXT("LD " + std::string(DebugString) + ", N", val);
 }
 
+inline void GameBoyCPU::ShiftALU(ALUTables::EShift Operation, uint8& Value)
+{
+	const GBALUResult& Shifted = ALUTables::LookupShift(Operation, Value, GetC());
+	Value = Shifted.Result;
+	SetFlagsResult(Shifted.Result, false, 0, Shifted.Carry);
+}
+
 inline void GameBoyCPU::RLA()
 {
-	bool leftmost = !!(A & 0x80);
-	A = A << 1;
-	A = SetBit(0, A, GetC());
+	//the A only rotates always clear Z
+	ShiftALU(ALUTables::RL, A);
 	ResetFlagZ();
-	ResetFlagN();
-	ResetFlagH();
-	SetValC(leftmost);
 	m_Cycles += 4;
 	DEBUGTEXT("RLA");
 }
 
 inline void GameBoyCPU::RLCA()
 {
-	bool leftmost = GetBit(7, A);
-	A = A << 1;
-	A = SetBit(0, A, leftmost);
+	ShiftALU(ALUTables::RLC, A);
 	ResetFlagZ();
-	ResetFlagN();
-	ResetFlagH();
-	SetValC(leftmost);
 	m_Cycles += 4;
 	DEBUGTEXT("RLCA");
 }
 
 void GameBoyCPU::RLC_8BIT(uint8& Val, int AdditionalCycles)
 {
-	bool leftmost = !!(Val & 0x80);
-	Val = Val << 1;
-	Val = SetBit(0, Val, leftmost);
-	SetValZ(Val == 0);
-	ResetFlagN();
-	ResetFlagH();
-	SetValC(leftmost);
+	ShiftALU(ALUTables::RLC, Val);
 	m_Cycles += 8 + AdditionalCycles;
 	DEBUGTEXT("RLC");
 }
 
 void GameBoyCPU::RRCA()
 {
-	bool rightmost = GetBit(0, A);
-	A = A >> 1;
-	A = SetBit(7, A, rightmost);
+	ShiftALU(ALUTables::RRC, A);
 	ResetFlagZ();
-	ResetFlagN();
-	ResetFlagH();
-	SetValC(rightmost);
 	m_Cycles += 4;
 	DEBUGTEXT("RRCA");
 }
 
 void GameBoyCPU::RRC_8BIT(uint8& Val, int AdditionalCycles)
 {
-	bool rightmost = GetBit(0, Val);
-	Val = Val >> 1;
-	Val = SetBit(7, Val, rightmost);
-	SetValZ(Val == 0);
-	ResetFlagN();
-	ResetFlagH();
-	SetValC(rightmost);
+	ShiftALU(ALUTables::RRC, Val);
 	m_Cycles += 8 + AdditionalCycles;
 	DEBUGTEXT("RRC");
 }
 
 void GameBoyCPU::SLA_8BIT(uint8& OutVal, int AdditionalCycles)
 {
-	bool leftmost = GetBit(7, OutVal);
-	OutVal = OutVal << 1;
-	SetValZ(OutVal == 0);
-	SetValC(leftmost);
-	ResetFlagH();
-	ResetFlagN();
+	ShiftALU(ALUTables::SLA, OutVal);
 	m_Cycles += 8 + AdditionalCycles;
 }
 
 void GameBoyCPU::SRA_8BIT(uint8& OutVal, int AdditionalCycles)
 {
-	bool rightmost = GetBit(0, OutVal);
-	bool leftmost = GetBit(7, OutVal);
-	OutVal = OutVal >> 1;
-	OutVal = SetBit(7, OutVal, leftmost);
-	SetValZ(OutVal == 0);
-	SetValC(rightmost);
-	ResetFlagH();
-	ResetFlagN();
+	ShiftALU(ALUTables::SRA, OutVal);
 	m_Cycles += 8 + AdditionalCycles;
 }
 
 void GameBoyCPU::RRA()
 {
-	bool rightmost = GetBit(0, A);
-	A = A >> 1;
-	A = SetBit(7, A, GetC());
+	ShiftALU(ALUTables::RR, A);
 	ResetFlagZ();
-	ResetFlagN();
-	ResetFlagH();
-	SetValC(rightmost);
 	m_Cycles += 4;
 	DEBUGTEXT("RRA");
 }
@@ -343,23 +307,24 @@ inline void GameBoyCPU::LD_A_FF00(uint8 Adder, const char* DebugString)
 
 inline void GameBoyCPU::ADD_8BIT_8BIT(uint8& Dest, uint8 Add, const char* DebugString)
 {
-	SetValH(CheckHalfCarry(Dest, Add));
-	SetValC((Dest + Add) > 255);
-	Dest = Dest + Add;
+	uint32 Sum = Dest + Add;
+	uint8 Result = uint8(Sum);
+	SetFlagsResult(Result, false, Dest ^ Add ^ Result, Sum > 0xFF);
+	Dest = Result;
 	m_Cycles += 4;
-	SetValZ(Dest == 0);
-	ResetFlagN();
 	DEBUGTEXT("ADD " + std::string(DebugString));
 }
 
 inline void GameBoyCPU::ADD_16BIT_16BIT(uint16& Dest, uint16 Add, const char* DebugString)
 {
 	uint16 Result = Dest + Add;
-	(Result < Dest) ? SetFlagC() : ResetFlagC();
-	((Result ^ Dest ^ Add) & 0x1000) ? SetFlagH() : ResetFlagH();
+
+	//Z is left alone, H comes from bit 12
+	m_FlagN = false;
+	m_FlagHalf = uint8((Result ^ Dest ^ Add) >> 8);
+	m_FlagC = Result < Dest;
 
 	m_Cycles += 8;
-	ResetFlagN();
 	Dest = Result;
 
 	DEBUGTEXT("ADD " + std::string(DebugString));
@@ -368,12 +333,11 @@ inline void GameBoyCPU::ADD_16BIT_16BIT(uint16& Dest, uint16 Add, const char* De
 inline void GameBoyCPU::ADD_8BIT_N(uint8& Dest, const char* DebugString)
 {
 	uint8 val = Fetch8BitParameter();
-	SetValH(CheckHalfCarry(Dest, val));
-	SetValC((Dest + val) > 255);
-	Dest = Dest + val;
+	uint32 Sum = Dest + val;
+	uint8 Result = uint8(Sum);
+	SetFlagsResult(Result, false, Dest ^ val ^ Result, Sum > 0xFF);
+	Dest = Result;
 	m_Cycles += 4;
-	SetValZ(Dest == 0);
-	ResetFlagN();
 	DEBUGTEXT("ADD " + std::string(DebugString) + ", val", val);
 }
 
@@ -392,24 +356,18 @@ void GameBoyCPU::ADD_16BIT_N(uint16& Dest, int8 Add, const char* DebugString)
 
 void GameBoyCPU::ADC_A_8BIT(uint8 Adder)
 {
-	uint8 carryVal = GetC() ? 0x01 : 0x00;
-
-	SetValH(((int)(A & 0x0F) + (int)(Adder & 0x0F) + (int)carryVal) > 0x0F);
-	SetValC(((int)(A & 0xFF) + (int)(Adder & 0xFF) + (int)carryVal) > 0xFF);
-
-	A = A + Adder + carryVal;
+	uint32 Sum = A + Adder + (GetC() ? 1 : 0);
+	uint8 Result = uint8(Sum);
+	SetFlagsResult(Result, false, A ^ Adder ^ Result, Sum > 0xFF);
+	A = Result;
 	m_Cycles += 4;
-	SetValZ(A == 0);
-	ResetFlagN();
 }
 
 inline void GameBoyCPU::SUB_8BIT(uint8 Reg, const char* DebugString)
 {
-	SetValH(((A & 0x0F) < (Reg & 0x0F)));
-	SetValC(((A & 0xFF) < (Reg & 0xFF)));
-	A = A - Reg;
-	SetValZ(A == 0);
-	SetValN(true);
+	uint8 Result = A - Reg;
+	SetFlagsResult(Result, true, A ^ Reg ^ Result, A < Reg);
+	A = Result;
 
 	m_Cycles += 4;
 	DEBUGTEXT("SUB " + std::string(DebugString));
@@ -417,21 +375,10 @@ inline void GameBoyCPU::SUB_8BIT(uint8 Reg, const char* DebugString)
 
 void GameBoyCPU::SBC_8BIT(uint8 Reg, const char* DebugString)
 {
-	int carryVal = GetC() ? 0x01 : 0x00;
-
-	int tempA = A & 0xFF;
-	int intAdd = Reg & 0xFF;
-	int origA = tempA;
-
-	tempA -= intAdd;
-	tempA -= carryVal;
-	SetFlagN();
-	SetValC(tempA < 0);
-	tempA &= 0xFF;
-	SetValZ(tempA == 0);
-	SetValH(((origA ^ intAdd ^ tempA) & 0x10) == 0x10);
-
-	A = uint8(tempA);
+	int Difference = int(A) - int(Reg) - (GetC() ? 1 : 0);
+	uint8 Result = uint8(Difference);
+	SetFlagsResult(Result, true, A ^ Reg ^ Result, Difference < 0);
+	A = Result;
 
 	m_Cycles += 4;
 }
@@ -440,18 +387,14 @@ inline void GameBoyCPU::AND_8BIT(uint8 Reg, const char* DebugString)
 {
 	A = A & Reg;
 	m_Cycles += 4;
-	SetValZ(A == 0);
-	ResetFlagN();
-	SetFlagH();
-	ResetFlagC();
+	SetFlagsResult(A, false, 0x10, false);
 	DEBUGTEXT("AND " + std::string(DebugString));
 }
 
 inline void GameBoyCPU::XOR_8BIT(uint8 Reg, const char* DebugString)
 {
 	A = A ^ Reg;
-	SetValZ(A == 0);
-	ResetFlags(EFlagMask::FN | EFlagMask::FH | EFlagMask::FC);
+	SetFlagsResult(A, false, 0, false);
 	m_Cycles = m_Cycles + 4;
 	DEBUGTEXT("XOR " + std::string(DebugString));
 }
@@ -459,8 +402,7 @@ inline void GameBoyCPU::XOR_8BIT(uint8 Reg, const char* DebugString)
 inline void GameBoyCPU::OR_8BIT(uint8 Reg, const char* DebugString)
 {
 	A = A | Reg;
-	SetValZ(A == 0);
-	ResetFlags(EFlagMask::FN | EFlagMask::FH | EFlagMask::FC);
+	SetFlagsResult(A, false, 0, false);
 	m_Cycles += 4;
 	DEBUGTEXT("OR " + std::string(DebugString));
 }
@@ -468,11 +410,7 @@ inline void GameBoyCPU::OR_8BIT(uint8 Reg, const char* DebugString)
 inline void GameBoyCPU::CP(uint8 Reg, const char* DebugString)
 {
 	uint8 result = A - Reg;
-	SetValZ(result == 0);
-	SetValN(true);
-
-	SetValC((A & 0xFF) < (Reg & 0xFF));
-	SetValH((A & 0x0F) < (Reg & 0x0F));
+	SetFlagsResult(result, true, A ^ Reg ^ result, A < Reg);
 
 	m_Cycles += 4;
 	DEBUGTEXT("CP " + std::string(DebugString));
@@ -493,47 +431,13 @@ This requires to adjust register A for decimal operations
 
 void GameBoyCPU::DAA()
 {
-	int aVal = A;
-
-	if (!GetN())
-	{
-		if (GetH() || (aVal & 0xF) > 9)
-		{
-			aVal += 0x06;
-		}
-
-		if (GetC() || (aVal > 0x9F))
-		{
-			aVal += 0x60;
-		}
-	}
-	else
-	{
-		if (GetH())
-		{
-			aVal = (aVal - 0x06) & 0xFF;
-		}
-
-		if (GetC())
-		{
-			aVal -= 0x60;
-		}
-	}
-
-	ResetFlagH();
-
-	if ((aVal & 0x100) == 0x100)
-	{
-		SetFlagC();
-	}
-
-	aVal &= 0xFF;
-	SetValZ(aVal == 0x00);
-	
-	A = (uint8)aVal;
+	//N is left alone
+	const GBALUResult& Adjusted = ALUTables::LookupDecimalAdjust(A, GetN(), GetH(), GetC());
+	A = Adjusted.Result;
+	m_FlagZero = Adjusted.Result;
+	m_FlagHalf = 0;
+	m_FlagC = Adjusted.Carry;
 	m_Cycles += 4;
-
-	return;
 }
 
 void GameBoyCPU::CCF()
@@ -551,6 +455,7 @@ inline void GameBoyCPU::POP(uint16& Reg, const char* DebugString)
 	{
 		//it's AF - low 4 bits are always 0
 		Reg = Reg & 0xFFF0;
+		LoadFlags();
 	}
 
 	m_Cycles += 12;
@@ -670,67 +575,35 @@ void GameBoyCPU::CPL()
 
 void GameBoyCPU::RL_8BIT(uint8& OutVal, int AdditionalCycles)
 {
-	bool leftmost = false;
-
-	leftmost = !!(OutVal & 0x80);
-	OutVal = OutVal << 1;
-	OutVal = SetBit(0, OutVal, GetC());
-	SetValZ(OutVal == 0);
+	ShiftALU(ALUTables::RL, OutVal);
 	m_Cycles += 8 + AdditionalCycles;
-
-	ResetFlagN();
-	ResetFlagH();
-	SetValC(leftmost);
 }
 
 void GameBoyCPU::RR_8BIT(uint8& OutVal, int AdditionalCycles)
 {
-	bool rightmost = false;
-
-	rightmost = GetBit(0, OutVal);
-	OutVal = OutVal >> 1;
-	OutVal = SetBit(7, OutVal, GetC());
-	SetValZ(OutVal == 0);
+	ShiftALU(ALUTables::RR, OutVal);
 	m_Cycles += 8 + AdditionalCycles;
-
-	ResetFlagN();
-	ResetFlagH();
-	SetValC(rightmost);
 }
 
 void GameBoyCPU::SRL_8BIT(uint8& OutVal, int AdditionalCycles)
 {
-	bool rightmost = GetBit(0, OutVal);
-	SetValC(rightmost);
-	OutVal = OutVal >> 1;
-	OutVal = SetBit(7, OutVal, false);
-	SetValZ(OutVal == 0);
-	SetValN(false);
-	SetValH(false);
+	ShiftALU(ALUTables::SRL, OutVal);
 	m_Cycles += 8 + AdditionalCycles;
 }
 
 void GameBoyCPU::BIT_8BIT(uint8 bit, uint8 Val)
 {
-	uint8 mask = 1 << bit;
-	bool IsSet = !!(Val & mask);
-	SetValZ(!IsSet);
-	ResetFlagN();
-	SetFlagH();
+	//C is left alone
+	m_FlagZero = Val & (1 << bit);
+	m_FlagN = false;
+	m_FlagHalf = 0x10;
 	m_Cycles += 8;
 }
 
 void GameBoyCPU::SWAP_8BIT(uint8& OutVal, int AdditionalCycles)
 {
-	uint8 bottom = OutVal & 0x0f;
-	uint8 top = OutVal & 0xf0;
-	top = top >> 4;
-	bottom = bottom << 4;
-	OutVal = bottom | top;
+	ShiftALU(ALUTables::SWAP, OutVal);
 	m_Cycles += 8 + AdditionalCycles;
-	SetValZ(OutVal == 0);
-
-	ResetFlags(EFlagMask::FN | EFlagMask::FH | EFlagMask::FC);
 }
 
 void GameBoyCPU::RES_8BIT(uint8 bit, uint8& Val, int AdditionalCycles)
@@ -0,0 +1,301 @@
+//Every opcode in order as GB_OPCODE(Opcode, Body). CPU.h and CPU.cpp define GB_OPCODE before
+//including this to declare the handlers, fill the handler table and lay out the computed goto labels
+//http://www.pastraiser.com/cpu/gameboy/gameboy_opcodes.html
+
+//00
+GB_OPCODE(0x00, { NOP(); }) // NOP
+GB_OPCODE(0x01, { LD_16REG_NN(BC, "BC"); }) // LD BC, NN
+GB_OPCODE(0x02, { LD_PTR_8REG(BC, A, "(BC), A"); }) // LD (BC), A
+GB_OPCODE(0x03, { INC_16REG(BC, "BC"); }) // INC BC
+GB_OPCODE(0x04, { INC_8REG(B, "B");	}) // INC B
+GB_OPCODE(0x05, { DEC_8REG(B, "B");	}) // DEC B
+GB_OPCODE(0x06, { LD_8REG_N(B, "B"); }) // LD B, N
+GB_OPCODE(0x07, { RLCA(); }) // RLCA
+GB_OPCODE(0x08, { LD_PTR_16REG(Fetch16BitParameter(), SP, "SP"); }) // LD (NN), SP
+GB_OPCODE(0x09, { ADD_16BIT_16BIT(HL, BC, "HL, BC"); }) // ADD HL, BC
+GB_OPCODE(0x0A, { LD_8REG_PTR(A, BC, "A, (HL)"); }) // LD A, (BC)
+GB_OPCODE(0x0B, { DEC_16REG(BC, "BC"); }) // DEC BC
+GB_OPCODE(0x0C, { INC_8REG(C, "C");	}) // INC C
+GB_OPCODE(0x0D, { DEC_8REG(C, "C");	}) // DEC C
+GB_OPCODE(0x0E, { LD_8REG_N(C, "C"); }) // LD C, N
+GB_OPCODE(0x0F, { RRCA(); }) // RRCA
+
+//10
+GB_OPCODE(0x10, { STOP(); }) // STOP
+GB_OPCODE(0x11, { LD_16REG_NN(DE, "DE"); }) // LD DE, NN
+GB_OPCODE(0x12, { LD_PTR_8REG(DE, A, "(DE), A"); }) // LD (DE), A
+GB_OPCODE(0x13, { INC_16REG(DE, "DE"); }) // INC DE
+GB_OPCODE(0x14, { INC_8REG(D, "D");	}) // INC D
+GB_OPCODE(0x15, { DEC_8REG(D, "D");	}) // DEC D
+GB_OPCODE(0x16, { LD_8REG_N(D, "D"); }) // LD D, N
+GB_OPCODE(0x17, { RLA(); }) // RLA
+GB_OPCODE(0x18, { JR(); }) // JR Address
+GB_OPCODE(0x19, { ADD_16BIT_16BIT(HL, DE, "HL, DE"); }) // ADD HL, DE
+GB_OPCODE(0x1A, { LD_8REG_PTR(A, DE, "A, (DE)"); }) // LD A, (DE)
+GB_OPCODE(0x1B, { DEC_16REG(DE, "DE"); }) // DEC DE
+GB_OPCODE(0x1C, { INC_8REG(E, "E");	}) // INC E
+GB_OPCODE(0x1D, { DEC_8REG(E, "E");	}) // DEC E
+GB_OPCODE(0x1E, { LD_8REG_N(E, "E"); }) // LD E, N
+GB_OPCODE(0x1F, { RRA(); }) // RRA
+
+//20
+GB_OPCODE(0x20, { JR_Flag_NN(EFlagMask::FZ, false, "NZ"); }) // JR NZ, Address
+GB_OPCODE(0x21, { LD_16REG_NN(HL, "HL"); }) // LD HL, NN
+GB_OPCODE(0x22, { LD_HLP_A(); }) // LD (HL+), A
+GB_OPCODE(0x23, { INC_16REG(HL, "HL"); }) // INC HL
+GB_OPCODE(0x24, { INC_8REG(H, "H");	}) // INC H
+GB_OPCODE(0x25, { DEC_8REG(H, "H");	}) // DEC H
+GB_OPCODE(0x26, { LD_8REG_N(H, "H"); }) // LD H, N
+GB_OPCODE(0x27, { DAA(); }) // DAA
+GB_OPCODE(0x28, { JR_Flag_NN(EFlagMask::FZ, true, "Z"); }) // JR Z, Address
+GB_OPCODE(0x29, { ADD_16BIT_16BIT(HL, HL, "HL, HL"); }) // ADD HL, HL
+GB_OPCODE(0x2A, { LD_A_HLP(); }) // LD A, (HL+)
+GB_OPCODE(0x2B, { DEC_16REG(HL, "HL"); }) // DEC HL
+GB_OPCODE(0x2C, { INC_8REG(L, "L");	}) // INC L
+GB_OPCODE(0x2D, { DEC_8REG(L, "L");	}) // DEC L
+GB_OPCODE(0x2E, { LD_8REG_N(L, "H"); }) // LD L, N
+GB_OPCODE(0x2F, { CPL(); }) // CPL
+
+//30
+GB_OPCODE(0x30, { JR_Flag_NN(EFlagMask::FC, false, "Z"); }) // JR NC, Address
+GB_OPCODE(0x31, { LD_16REG_NN(SP, "SP"); }) // LD SP, NN
+GB_OPCODE(0x32, { LD_HLM_A(); }) // LD (HL-), A
+GB_OPCODE(0x33, { INC_16REG(SP, "SP"); }) // INC SP
+GB_OPCODE(0x34, { ModifyHL([this](uint8& Val) { INC_8REG(Val, "Memory[HL]", 4); }); }) // INC (HL)
+GB_OPCODE(0x35, { ModifyHL([this](uint8& Val) { DEC_8REG(Val, "Memory[HL]", 4); }); }) // DEC (HL)
+GB_OPCODE(0x36, { LD_PTR_8REG(HL, Fetch8BitParameter(), "(HL), N"); }) // LD (HL), N
+GB_OPCODE(0x37, { SCF(); }) // SCF
+GB_OPCODE(0x38, { JR_Flag_NN(EFlagMask::FC, true, "Z"); }) // JR C, Address
+GB_OPCODE(0x39, { ADD_16BIT_16BIT(HL, SP, "HL, SP"); }) // ADD HL, SP
+GB_OPCODE(0x3A, { LD_A_HLM(); }) // LD A, (HL-)
+GB_OPCODE(0x3B, { DEC_16REG(SP, "SP"); }) // DEC SP
+GB_OPCODE(0x3C, { INC_8REG(A, "A");	}) // INC A
+GB_OPCODE(0x3D, { DEC_8REG(A, "A");	}) // DEC A
+GB_OPCODE(0x3E, { LD_8REG_N(A, "A"); }) // LD A, N
+GB_OPCODE(0x3F, { CCF(); }) // CCF
+
+//40
+GB_OPCODE(0x40, { LD_8BIT_8BIT(B, B, "B, B"); }) // LD B, B
+GB_OPCODE(0x41, { LD_8BIT_8BIT(B, C, "B, C"); }) // LD B, C
+GB_OPCODE(0x42, { LD_8BIT_8BIT(B, D, "B, D"); }) // LD B, D
+GB_OPCODE(0x43, { LD_8BIT_8BIT(B, E, "B, E"); }) // LD B, E
+GB_OPCODE(0x44, { LD_8BIT_8BIT(B, H, "B, H"); }) // LD B, H
+GB_OPCODE(0x45, { LD_8BIT_8BIT(B, L, "B, L"); }) // LD B, L
+GB_OPCODE(0x46, { LD_8BIT_8BIT(B, ReadMemory(HL), "B, (HL)"); }) // LD B, (HL)
+GB_OPCODE(0x47, { LD_8BIT_8BIT(B, A, "B, A"); }) // LD B, A
+GB_OPCODE(0x48, { LD_8BIT_8BIT(C, B, "C, B"); }) // LD C, B
+GB_OPCODE(0x49, { LD_8BIT_8BIT(C, C, "C, C"); }) // LD C, C
+GB_OPCODE(0x4A, { LD_8BIT_8BIT(C, D, "C, D"); }) // LD C, D
+GB_OPCODE(0x4B, { LD_8BIT_8BIT(C, E, "C, E"); }) // LD C, E
+GB_OPCODE(0x4C, { LD_8BIT_8BIT(C, H, "C, H"); }) // LD C, H
+GB_OPCODE(0x4D, { LD_8BIT_8BIT(C, L, "C, L"); }) // LD C, L
+GB_OPCODE(0x4E, { LD_8BIT_8BIT(C, ReadMemory(HL), "C, (HL)"); }) // LD C, (HL)
+GB_OPCODE(0x4F, { LD_8BIT_8BIT(C, A, "C, A"); }) // LD C, A
+
+//50
+GB_OPCODE(0x50, { LD_8BIT_8BIT(D, B, "D, B"); }) // LD D, B
+GB_OPCODE(0x51, { LD_8BIT_8BIT(D, C, "D, C"); }) // LD D, C
+GB_OPCODE(0x52, { LD_8BIT_8BIT(D, D, "D, D"); }) // LD D, D
+GB_OPCODE(0x53, { LD_8BIT_8BIT(D, E, "D, E"); }) // LD D, E
+GB_OPCODE(0x54, { LD_8BIT_8BIT(D, H, "D, H"); }) // LD D, H
+GB_OPCODE(0x55, { LD_8BIT_8BIT(D, L, "D, L"); }) // LD D, L
+GB_OPCODE(0x56, { LD_8BIT_8BIT(D, ReadMemory(HL), "D, (HL)"); }) // LD D, (HL)
+GB_OPCODE(0x57, { LD_8BIT_8BIT(D, A, "D, A"); }) // LD D, A
+GB_OPCODE(0x58, { LD_8BIT_8BIT(E, B, "E, B"); }) // LD E, B
+GB_OPCODE(0x59, { LD_8BIT_8BIT(E, C, "E, C"); }) // LD E, C
+GB_OPCODE(0x5A, { LD_8BIT_8BIT(E, D, "E, D"); }) // LD E, D
+GB_OPCODE(0x5B, { LD_8BIT_8BIT(E, E, "E, E"); }) // LD E, E
+GB_OPCODE(0x5C, { LD_8BIT_8BIT(E, H, "E, H"); }) // LD E, H
+GB_OPCODE(0x5D, { LD_8BIT_8BIT(E, L, "E, L"); }) // LD E, L
+GB_OPCODE(0x5E, { LD_8BIT_8BIT(E, ReadMemory(HL), "E, (HL)"); }) // LD E, (HL)
+GB_OPCODE(0x5F, { LD_8BIT_8BIT(E, A, "E, A"); }) // LD E, A
+
+//60
+GB_OPCODE(0x60, { LD_8BIT_8BIT(H, B, "H, B"); }) // LD H, B
+GB_OPCODE(0x61, { LD_8BIT_8BIT(H, C, "H, C"); }) // LD H, C
+GB_OPCODE(0x62, { LD_8BIT_8BIT(H, D, "H, D"); }) // LD H, D
+GB_OPCODE(0x63, { LD_8BIT_8BIT(H, E, "H, E"); }) // LD H, E
+GB_OPCODE(0x64, { LD_8BIT_8BIT(H, H, "H, H"); }) // LD H, H
+GB_OPCODE(0x65, { LD_8BIT_8BIT(H, L, "H, L"); }) // LD H, L
+GB_OPCODE(0x66, { LD_8BIT_8BIT(H, ReadMemory(HL), "H, (HL)"); }) // LD H, (HL)
+GB_OPCODE(0x67, { LD_8BIT_8BIT(H, A, "H, A"); }) // LD H, A
+GB_OPCODE(0x68, { LD_8BIT_8BIT(L, B, "L, B"); }) // LD L, B
+GB_OPCODE(0x69, { LD_8BIT_8BIT(L, C, "L, C"); }) // LD L, C
+GB_OPCODE(0x6A, { LD_8BIT_8BIT(L, D, "L, D"); }) // LD L, D
+GB_OPCODE(0x6B, { LD_8BIT_8BIT(L, E, "L, E"); }) // LD L, E
+GB_OPCODE(0x6C, { LD_8BIT_8BIT(L, H, "L, H"); }) // LD L, H
+GB_OPCODE(0x6D, { LD_8BIT_8BIT(L, L, "L, L"); }) // LD L, L
+GB_OPCODE(0x6E, { LD_8BIT_8BIT(L, ReadMemory(HL), "L, (HL)"); }) // LD L, (HL)
+GB_OPCODE(0x6F, { LD_8BIT_8BIT(L, A, "L, A"); }) // LD L, A
+
+//70
+GB_OPCODE(0x70, { LD_PTR_8REG(HL, B, "(HL), B"); }) // LD (HL), B
+GB_OPCODE(0x71, { LD_PTR_8REG(HL, C, "(HL), C"); }) // LD (HL), C
+GB_OPCODE(0x72, { LD_PTR_8REG(HL, D, "(HL), D"); }) // LD (HL), D
+GB_OPCODE(0x73, { LD_PTR_8REG(HL, E, "(HL), E"); }) // LD (HL), E
+GB_OPCODE(0x74, { LD_PTR_8REG(HL, H, "(HL), H"); }) // LD (HL), H
+GB_OPCODE(0x75, { LD_PTR_8REG(HL, L, "(HL), L"); }) // LD (HL), L
+GB_OPCODE(0x76, { HALT(); }) // HALT
+GB_OPCODE(0x77, { LD_PTR_8REG(HL, A, "(HL), A"); }) // LD (HL), A
+GB_OPCODE(0x78, { LD_8BIT_8BIT(A, B, "A, B"); }) // LD A, B
+GB_OPCODE(0x79, { LD_8BIT_8BIT(A, C, "A, C"); }) // LD A, C
+GB_OPCODE(0x7A, { LD_8BIT_8BIT(A, D, "A, D"); }) // LD A, D
+GB_OPCODE(0x7B, { LD_8BIT_8BIT(A, E, "A, E"); }) // LD A, E
+GB_OPCODE(0x7C, { LD_8BIT_8BIT(A, H, "A, H"); }) // LD A, H
+GB_OPCODE(0x7D, { LD_8BIT_8BIT(A, L, "A, L"); }) // LD A, L
+GB_OPCODE(0x7E, { LD_8REG_PTR(A, HL, "A, (HL)"); }) // LD A, (HL)
+GB_OPCODE(0x7F, // LD A, A
+{
+	//A = A;
+	m_Cycles += 4;
+	DebugExecution("LD A, A");
+})
+
+//80
+GB_OPCODE(0x80, { ADD_8BIT_8BIT(A, B, "A, B"); }) // ADD A, B
+GB_OPCODE(0x81, { ADD_8BIT_8BIT(A, C, "A, C"); }) // ADD A, C
+GB_OPCODE(0x82, { ADD_8BIT_8BIT(A, D, "A, D"); }) // ADD A, D
+GB_OPCODE(0x83, { ADD_8BIT_8BIT(A, E, "A, E"); }) // ADD A, E
+GB_OPCODE(0x84, { ADD_8BIT_8BIT(A, H, "A, H"); }) // ADD A, H
+GB_OPCODE(0x85, { ADD_8BIT_8BIT(A, L, "A, L"); }) // ADD A, L
+GB_OPCODE(0x86, { ADD_8BIT_8BIT(A, ReadMemory(HL), "A, (HL)"); }) // ADD A, (HL)
+GB_OPCODE(0x87, { ADD_8BIT_8BIT(A, A, "A, A"); }) // ADD A, A
+GB_OPCODE(0x88, { ADC_A_8BIT(B); }) // ADC A, B
+GB_OPCODE(0x89, { ADC_A_8BIT(C); }) // ADC A, C
+GB_OPCODE(0x8A, { ADC_A_8BIT(D); }) // ADC A, D
+GB_OPCODE(0x8B, { ADC_A_8BIT(E); }) // ADC A, E
+GB_OPCODE(0x8C, { ADC_A_8BIT(H); }) // ADC A, H
+GB_OPCODE(0x8D, { ADC_A_8BIT(L); }) // ADC A, L
+GB_OPCODE(0x8E, { ADC_A_8BIT(ReadMemory(HL)); }) // ADC A, (HL)
+GB_OPCODE(0x8F, { ADC_A_8BIT(A); }) // ADC A, A
+
+//90
+GB_OPCODE(0x90, { SUB_8BIT(B, "B"); }) // SUB B
+GB_OPCODE(0x91, { SUB_8BIT(C, "C"); }) // SUB C
+GB_OPCODE(0x92, { SUB_8BIT(D, "D"); }) // SUB D
+GB_OPCODE(0x93, { SUB_8BIT(E, "E"); }) // SUB E
+GB_OPCODE(0x94, { SUB_8BIT(H, "H"); }) // SUB H
+GB_OPCODE(0x95, { SUB_8BIT(L, "L"); }) // SUB L
+GB_OPCODE(0x96, { SUB_8BIT(ReadMemory(HL), "(HL)"); }) // SUB (HL)
+GB_OPCODE(0x97, { SUB_8BIT(A, "A"); }) // SUB A
+GB_OPCODE(0x98, { SBC_8BIT(B, "B"); }) // SBC B
+GB_OPCODE(0x99, { SBC_8BIT(C, "C"); }) // SBC C
+GB_OPCODE(0x9A, { SBC_8BIT(D, "D"); }) // SBC D
+GB_OPCODE(0x9B, { SBC_8BIT(E, "E"); }) // SBC E
+GB_OPCODE(0x9C, { SBC_8BIT(H, "H"); }) // SBC H
+GB_OPCODE(0x9D, { SBC_8BIT(L, "L"); }) // SBC L
+GB_OPCODE(0x9E, { SBC_8BIT(ReadMemory(HL), "(HL)"); }) // SBC (HL)
+GB_OPCODE(0x9F, { SBC_8BIT(A, "A"); }) // SBC A
+
+//A0
+GB_OPCODE(0xA0, { AND_8BIT(B, "B"); }) // AND B
+GB_OPCODE(0xA1, { AND_8BIT(C, "C"); }) // AND C
+GB_OPCODE(0xA2, { AND_8BIT(D, "D"); }) // AND D
+GB_OPCODE(0xA3, { AND_8BIT(E, "E"); }) // AND E
+GB_OPCODE(0xA4, { AND_8BIT(H, "H"); }) // AND H
+GB_OPCODE(0xA5, { AND_8BIT(L, "L"); }) // AND L
+GB_OPCODE(0xA6, { AND_8BIT(ReadMemory(HL), "(HL)"); }) // AND (HL)
+GB_OPCODE(0xA7, { AND_8BIT(A, "A"); }) // AND A
+GB_OPCODE(0xA8, { XOR_8BIT(B, "B");	}) // XOR B
+GB_OPCODE(0xA9, { XOR_8BIT(C, "C");	}) // XOR C
+GB_OPCODE(0xAA, { XOR_8BIT(D, "D");	}) // XOR D
+GB_OPCODE(0xAB, { XOR_8BIT(E, "E");	}) // XOR E
+GB_OPCODE(0xAC, { XOR_8BIT(H, "H");	}) // XOR H
+GB_OPCODE(0xAD, { XOR_8BIT(L, "L");	}) // XOR L
+GB_OPCODE(0xAE, { XOR_8BIT(ReadMemory(HL), "(HL)");	}) // XOR (HL)
+GB_OPCODE(0xAF, { XOR_8BIT(A, "A");	}) // XOR A
+
+//B0
+GB_OPCODE(0xB0, { OR_8BIT(B, "B"); }) // OR B
+GB_OPCODE(0xB1, { OR_8BIT(C, "C"); }) // OR C
+GB_OPCODE(0xB2, { OR_8BIT(D, "D"); }) // OR D
+GB_OPCODE(0xB3, { OR_8BIT(E, "E"); }) // OR E
+GB_OPCODE(0xB4, { OR_8BIT(H, "H"); }) // OR H
+GB_OPCODE(0xB5, { OR_8BIT(L, "L"); }) // OR L
+GB_OPCODE(0xB6, { OR_8BIT(ReadMemory(HL), "A"); }) // OR (HL)
+GB_OPCODE(0xB7, { OR_8BIT(A, "A"); }) // OR A
+GB_OPCODE(0xB8, { CP(B, "B"); }) // CP B
+GB_OPCODE(0xB9, { CP(C, "C"); }) // CP C
+GB_OPCODE(0xBA, { CP(D, "D"); }) // CP D
+GB_OPCODE(0xBB, { CP(E, "E"); }) // CP E
+GB_OPCODE(0xBC, { CP(H, "H"); }) // CP H
+GB_OPCODE(0xBD, { CP(L, "L"); }) // CP L
+GB_OPCODE(0xBE, { CP(ReadMemory(HL), "(HL)"); }) // CP (HL)
+GB_OPCODE(0xBF, { CP(A, "A"); }) // CP A
+
+//C0
+GB_OPCODE(0xC0, { RET_FLAG(EFlagMask::FZ, false); }) // RET NZ
+GB_OPCODE(0xC1, { POP(BC, "BC"); }) // POP BC
+GB_OPCODE(0xC2, { JP_Flag_NN(EFlagMask::FZ, false); }) // JP NZ, NN
+GB_OPCODE(0xC3, { JP(); }) // JP NN
+GB_OPCODE(0xC4, { CALL_FLAG(EFlagMask::FZ, false); }) // CALL NZ, NN
+GB_OPCODE(0xC5, { PUSH(BC, "BC"); }) // PUSH BC
+GB_OPCODE(0xC6, { ADD_8BIT_N(A, "A"); }) // ADD A, N
+GB_OPCODE(0xC7, { RST(0x00); }) // RST 00h
+GB_OPCODE(0xC8, { RET_FLAG(EFlagMask::FZ, true); }) // RET Z
+GB_OPCODE(0xC9, { RET(); }) // RET
+GB_OPCODE(0xCA, { JP_Flag_NN(EFlagMask::FZ, true); }) // JP Z, NN
+GB_OPCODE(0xCB, // CB instructions
+{
+	uint8 secondPart = Fetch8BitParameter(true);
+	ManageCBInstruction(secondPart);
+	DEBUGTEXT("CB instruction", secondPart);
+})
+GB_OPCODE(0xCC, { CALL_FLAG(EFlagMask::FZ, true); }) // CALL Z, NN
+GB_OPCODE(0xCD, { CALL(); }) // CALL NN
+GB_OPCODE(0xCE, { ADC_A_8BIT(Fetch8BitParameter()); }) // ADC A, N
+GB_OPCODE(0xCF, { RST(0x08); }) // RST 08h
+
+//D0
+GB_OPCODE(0xD0, { RET_FLAG(EFlagMask::FC, false); }) // RET NC
+GB_OPCODE(0xD1, { POP(DE, "DE"); }) // POP DE
+GB_OPCODE(0xD2, { JP_Flag_NN(EFlagMask::FC, false); }) // JP NC, NN
+GB_OPCODE(0xD3, { assert(0); }) // not existing
+GB_OPCODE(0xD4, { CALL_FLAG(EFlagMask::FC, false); }) // CALL NC, NN
+GB_OPCODE(0xD5, { PUSH(DE, "DE"); }) // PUSH DE
+GB_OPCODE(0xD6, { SUB_8BIT(Fetch8BitParameter(), "NN"); }) // SUB N
+GB_OPCODE(0xD7, { RST(0x10); }) // RST 10h
+GB_OPCODE(0xD8, { RET_FLAG(EFlagMask::FC, true); }) // RET C
+GB_OPCODE(0xD9, { RETI(); }) // RETI
+GB_OPCODE(0xDA, { JP_Flag_NN(EFlagMask::FC, true); }) // JP C, NN
+GB_OPCODE(0xDB, { assert(0); }) // not existing
+GB_OPCODE(0xDC, { CALL_FLAG(EFlagMask::FC, true); }) // CALL C, NN
+GB_OPCODE(0xDD, { assert(0); }) // not existing
+GB_OPCODE(0xDE, { SBC_8BIT(Fetch8BitParameter(), "N"); }) // SBC N
+GB_OPCODE(0xDF, { RST(0x18); }) // RST 18h
+
+//E0
+GB_OPCODE(0xE0, { LD_FF00_A(Fetch8BitParameter(), ""); }) // LD ($FF00+N),A
+GB_OPCODE(0xE1, { POP(HL, "HL"); }) // POP HL
+GB_OPCODE(0xE2, { LD_FF00_A(C, ""); }) // LD ($FF00+C),A
+GB_OPCODE(0xE3, { assert(0); }) // not existing
+GB_OPCODE(0xE4, { assert(0); }) // not existing
+GB_OPCODE(0xE5, { PUSH(HL, "HL"); }) // PUSH HL
+GB_OPCODE(0xE6, { AND_8BIT(Fetch8BitParameter(), "N"); }) // AND N
+GB_OPCODE(0xE7, { RST(0x20); }) // RST 20h
+GB_OPCODE(0xE8, { ADD_16BIT_N(SP, int8(Fetch8BitParameter()), "ADD SP, N"); }) // ADD SP, n
+GB_OPCODE(0xE9, { JP_16BIT(HL); }) // JP (HL)
+GB_OPCODE(0xEA, { LD_PTR_8REG(Fetch16BitParameter(), A, "A"); }) // LD (NN), A
+GB_OPCODE(0xEB, { assert(0); }) // not existing
+GB_OPCODE(0xEC, { }) // not existing
+GB_OPCODE(0xED, { assert(0); }) // not existing
+GB_OPCODE(0xEE, { XOR_8BIT(Fetch8BitParameter(), "N");	}) // XOR #
+GB_OPCODE(0xEF, { RST(0x28); }) // RST 28h
+
+//F0
+GB_OPCODE(0xF0, { LD_A_FF00(Fetch8BitParameter(), ""); }) // LD A,($FF00+N)
+GB_OPCODE(0xF1, { POP(AF, "AF"); }) // POP AF
+GB_OPCODE(0xF2, { LD_A_FF00(C, ""); }) // LD A,($FF00+C)
+GB_OPCODE(0xF3, { DI(); }) // DI
+GB_OPCODE(0xF4, { assert(0); }) // not existing
+GB_OPCODE(0xF5, { StoreFlags(); PUSH(AF, "AF"); }) // PUSH AF
+GB_OPCODE(0xF6, { OR_8BIT(Fetch8BitParameter(), "N"); }) // OR N
+GB_OPCODE(0xF7, { RST(0x30); }) // RST 30h
+GB_OPCODE(0xF8, { LD_HL_SP_N(); }) // LD, HL, SP+n
+GB_OPCODE(0xF9, { LD_16BIT_16BIT(SP, HL, "SP, HL"); }) // LD SP, HL
+GB_OPCODE(0xFA, { LD_8BIT_8BIT(A, ReadMemory(Fetch16BitParameter()), "A, NN"); }) // LD A, NN
+GB_OPCODE(0xFB, { EI(); }) // EI
+GB_OPCODE(0xFC, { assert(0); }) // not existing
+GB_OPCODE(0xFD, { assert(0); }) // not existing
+GB_OPCODE(0xFE, { CP(Fetch8BitParameter(), "N"); }) // CP N
+GB_OPCODE(0xFF, { RST(0x38); }) // RST 0x38
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Types.h"
+
+//Everything the core needs from the outside world goes through these interfaces.
+//Any of them can be left null: the core then runs headless for that part.
+
+struct GBColor;
+
+struct GBSoundSample
+{
+	float m_Left;
+	float m_Right;
+};
+
+class IVideoSink
+{
+public:
+	virtual ~IVideoSink() = default;
+
+	//Called once per drawn frame at VBlank, or with threaded rendering from the thread that calls
+	//GameBoyCPU::PresentRenderedFrame. Frame holds ScreenData::SizeY rows of ScreenData::SizeX colors.
+	//It stays valid and unchanged until the next call
+	virtual void PresentFrame(const GBColor* Frame) = 0;
+};
+
+class IAudioSink
+{
+public:
+	virtual ~IAudioSink() = default;
+
+	virtual void QueueSamples(const GBSoundSample* Samples, uint32 Count) = 0;
+
+	//output rate the APU synthesizes for, queried once when the core is turned on
+	virtual uint32 GetSampleRate() { return 44100; }
+
+	//samples queued but not played yet and how many fit, 0 capacity when the sink can't tell
+	virtual uint32 GetBufferedSamples() { return 0; }
+	virtual uint32 GetBufferCapacity() { return 0; }
+};
+
+class IInputSource
+{
+public:
+	virtual ~IInputSource() = default;
+
+	//JOYPAD_INPUT_* and JOYPAD_BUTTONS_* bits of the currently pressed keys
+	virtual void GetInputState(uint8& Joypad, uint8& Buttons) = 0;
+
+	//false when the frontend asks to quit
+	virtual bool PollEvents() = 0;
+
+	//steps back through the rewind history instead of running while this returns true
+	virtual bool IsRewindHeld() { return false; }
+};
+
+class IClock
+{
+public:
+	virtual ~IClock() = default;
+
+	virtual double GetSeconds() = 0;
+};
+
+struct GBPlatform
+{
+	IVideoSink* Video = nullptr;
+	IAudioSink* Audio = nullptr;
+	IInputSource* Input = nullptr;
+	IClock* Clock = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,774 @@
+#include "Recompiler.h"
+#include "Constants.h"
+#include <cstddef>
+#include <cstring>
+
+#if GB_RECOMPILER
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#endif
+
+namespace
+{
+	constexpr uint8 OffsetF = offsetof(GBJitContext, AF);
+	constexpr uint8 OffsetA = OffsetF + 1;
+	constexpr uint8 OffsetBC = offsetof(GBJitContext, BC);
+	constexpr uint8 OffsetDE = offsetof(GBJitContext, DE);
+	constexpr uint8 OffsetHL = offsetof(GBJitContext, HL);
+	constexpr uint8 OffsetSP = offsetof(GBJitContext, SP);
+	constexpr uint8 OffsetPC = offsetof(GBJitContext, PC);
+	constexpr uint8 OffsetCycles = offsetof(GBJitContext, Cycles);
+	constexpr uint8 OffsetReadPages = offsetof(GBJitContext, ReadPages);
+	constexpr uint8 OffsetWritePages = offsetof(GBJitContext, WritePages);
+
+	//register fields of the opcodes: B, C, D, E, H, L, (HL), A
+	constexpr uint8 RegisterOffsets[8] = { OffsetBC + 1, OffsetBC, OffsetDE + 1, OffsetDE, OffsetHL + 1, OffsetHL, 0, OffsetA };
+	constexpr uint8 PairOffsets[4] = { OffsetBC, OffsetDE, OffsetHL, OffsetSP };
+	constexpr uint8 IndirectHL = 6;
+
+	//x86 ALU opcodes in the r/m32, r32 form
+	constexpr uint8 OpAdd = 0x01;
+	constexpr uint8 OpOr = 0x09;
+	constexpr uint8 OpAnd = 0x21;
+	constexpr uint8 OpSub = 0x29;
+	constexpr uint8 OpXor = 0x31;
+	constexpr uint8 OpTest = 0x85;
+
+	//ModRM reg field of the immediate forms
+	constexpr uint8 ExtAdd = 0;
+	constexpr uint8 ExtOr = 1;
+	constexpr uint8 ExtAnd = 4;
+	constexpr uint8 ExtSub = 5;
+	constexpr uint8 ExtXor = 6;
+	constexpr uint8 ExtShiftLeft = 4;
+	constexpr uint8 ExtShiftRight = 5;
+
+	constexpr uint8 CondZero = 0x4;
+	constexpr uint8 CondNotZero = 0x5;
+
+	//flag tested by the conditional jumps, bit 4 of the opcode picks C over Z and bit 3 is the wanted state
+	uint8 GetConditionFlag(uint8 Opcode)
+	{
+		return (Opcode & 0x10) ? EFlagMask::FC : EFlagMask::FZ;
+	}
+}
+
+GBRecompiler::GBRecompiler()
+{
+#if GB_RECOMPILER
+#ifdef _WIN32
+	m_Code = static_cast<uint8*>(VirtualAlloc(nullptr, CodeSize, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+#else
+	void* Code = mmap(nullptr, CodeSize, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	m_Code = (Code != MAP_FAILED) ? static_cast<uint8*>(Code) : nullptr;
+#endif
+#endif
+}
+
+GBRecompiler::~GBRecompiler()
+{
+#if GB_RECOMPILER
+	if (m_Code != nullptr)
+	{
+#ifdef _WIN32
+		VirtualFree(m_Code, 0, MEM_RELEASE);
+#else
+		munmap(m_Code, CodeSize);
+#endif
+	}
+#endif
+}
+
+bool GBRecompiler::IsFull() const
+{
+	return (m_Code == nullptr) || (m_Used + MaxBlockCode > CodeSize);
+}
+
+void GBRecompiler::Reset()
+{
+	m_Used = 0;
+}
+
+bool GBRecompiler::Compile(GBDecodedBlock& Block)
+{
+	if (IsFull())
+	{
+		return false;
+	}
+
+	uint32 Start = m_Used;
+	m_SideExits.clear();
+
+	//the context stays in r11, everything else lives in volatile registers so there is no frame to set up
+#ifdef _WIN32
+	Byte(0x49); Byte(0x89); Byte(0xCB); // mov r11, rcx
+#else
+	Byte(0x49); Byte(0x89); Byte(0xFB); // mov r11, rdi
+#endif
+
+	uint32 Cycles = 0;
+	uint32 MaxCycles = 0;
+	uint32 Index = 0;
+	bool Ended = false;
+	for (; Block.Ops[Index].PC != GBBlockCache::s_EndOfBlock.PC; ++Index)
+	{
+		uint32 Mark = m_Used;
+		size_t SideExitCount = m_SideExits.size();
+		uint32 OpCycles = 0;
+		if (!CompileOp(Block.Ops[Index], Index, Cycles, OpCycles, Ended))
+		{
+			m_Used = Mark;
+			m_SideExits.resize(SideExitCount);
+			break;
+		}
+
+		MaxCycles = Cycles + OpCycles;
+		Cycles += OpCycles;
+		if (Ended)
+		{
+			++Index;
+			break;
+		}
+	}
+
+	if (Index == 0)
+	{
+		m_Used = Start;
+		return false;
+	}
+
+	if (!Ended)
+	{
+		//ran off the end of the block or into an op for the interpreter
+		const GBDecodedOp& Last = Block.Ops[Index - 1];
+		CompileExit(uint16(Last.PC + Last.Length), Cycles, Index);
+	}
+
+	for (const SideExit& Exit : m_SideExits)
+	{
+		Patch(Exit.Patch, m_Used);
+		CompileExit(uint16(Block.Ops[Exit.OpIndex].PC), Exit.Cycles, Exit.OpIndex);
+	}
+
+	Block.Native = reinterpret_cast<GBDecodedBlock::NativeCode>(m_Code + Start);
+	Block.NativeCycles = MaxCycles;
+	Block.NativeOps = uint8(Index);
+	return true;
+}
+
+bool GBRecompiler::CompileOp(const GBDecodedOp& Op, uint32 Index, uint32 Cycles, uint32& OpCycles, bool& EndsBlock)
+{
+	uint8 Opcode = Op.Opcode;
+	uint8 N = uint8(Op.Operand);
+	uint16 NN = Op.Operand;
+	uint16 NextPC = uint16(Op.PC + Op.Length);
+	uint8 Dest = (Opcode >> 3) & 7;
+	uint8 Source = Opcode & 7;
+
+	//LD r, r'
+	if ((Opcode >= 0x40) && (Opcode < 0x80) && (Opcode != 0x76))
+	{
+		if (Source == IndirectHL)
+		{
+			LoadWord(RCX, OffsetHL);
+			CompilePageLookup(RCX, false, Index, Cycles);
+			LoadByteIndexed(RAX, R10, R9);
+			StoreByte(RegisterOffsets[Dest], RAX);
+			OpCycles = 8;
+		}
+		else if (Dest == IndirectHL)
+		{
+			LoadWord(RCX, OffsetHL);
+			CompilePageLookup(RCX, true, Index, Cycles);
+			LoadByte(RAX, RegisterOffsets[Source]);
+			StoreByteIndexed(R10, R9, RAX);
+			OpCycles = 8;
+		}
+		else
+		{
+			if (Dest != Source)
+			{
+				LoadByte(RAX, RegisterOffsets[Source]);
+				StoreByte(RegisterOffsets[Dest], RAX);
+			}
+			OpCycles = 4;
+		}
+		return true;
+	}
+
+	//ALU A, r
+	if ((Opcode >= 0x80) && (Opcode < 0xC0))
+	{
+		if (Source == IndirectHL)
+		{
+			LoadWord(RCX, OffsetHL);
+			CompilePageLookup(RCX, false, Index, Cycles);
+			LoadByteIndexed(RCX, R10, R9);
+			OpCycles = 8;
+		}
+		else
+		{
+			LoadByte(RCX, RegisterOffsets[Source]);
+			OpCycles = 4;
+		}
+		CompileALU(Dest);
+		return true;
+	}
+
+	//INC r, DEC r, LD r, n
+	if ((Opcode < 0x40) && (Dest != IndirectHL) && (Source >= 4) && (Source <= 6))
+	{
+		uint8 Register = RegisterOffsets[Dest];
+		if (Source == 4)
+		{
+			LoadByte(RAX, Register);
+			Mov(RCX, RAX);
+			AluImm(ExtAdd, RAX, 1);
+			AluImm(ExtAnd, RAX, 0xFF);
+			Mov(RDX, RCX);
+			Alu(OpXor, RDX, RAX);
+			AluImm(ExtAnd, RDX, 0x10);
+			Shift(ExtShiftLeft, RDX, 1);
+			CompileZFlag(RDX, RAX);
+			CompileStoreF(RDX, EFlagMask::FC | 0x0F);
+		}
+		else if (Source == 5)
+		{
+			LoadByte(RCX, Register);
+			Mov(RAX, RCX);
+			AluImm(ExtSub, RAX, 1);
+			AluImm(ExtAnd, RAX, 0xFF);
+			Mov(RDX, RAX);
+			AluImm(ExtXor, RDX, 0x01);
+			Alu(OpXor, RDX, RCX);
+			AluImm(ExtAnd, RDX, 0x10);
+			Shift(ExtShiftLeft, RDX, 1);
+			AluImm(ExtOr, RDX, EFlagMask::FN);
+			CompileZFlag(RDX, RAX);
+			CompileStoreF(RDX, EFlagMask::FC | 0x0F);
+		}
+		else
+		{
+			MovImm(RAX, N);
+		}
+		StoreByte(Register, RAX);
+		OpCycles = (Source == 6) ? 8 : 4;
+		return true;
+	}
+
+	//ALU A, n
+	if ((Opcode & 0xC7) == 0xC6)
+	{
+		MovImm(RCX, N);
+		CompileALU(Dest);
+		OpCycles = 8;
+		return true;
+	}
+
+	switch (Opcode)
+	{
+	case 0x00: // NOP
+		OpCycles = 4;
+		return true;
+	case 0x01: // LD rr, NN
+	case 0x11:
+	case 0x21:
+	case 0x31:
+		MovImm(RAX, NN);
+		StoreWord(PairOffsets[Opcode >> 4], RAX);
+		OpCycles = 12;
+		return true;
+	case 0x03: // INC rr
+	case 0x13:
+	case 0x23:
+	case 0x33:
+	case 0x0B: // DEC rr
+	case 0x1B:
+	case 0x2B:
+	case 0x3B:
+		LoadWord(RAX, PairOffsets[Opcode >> 4]);
+		AluImm((Opcode & 0x08) ? ExtSub : ExtAdd, RAX, 1);
+		StoreWord(PairOffsets[Opcode >> 4], RAX);
+		OpCycles = 8;
+		return true;
+	case 0x09: // ADD HL, rr
+	case 0x19:
+	case 0x29:
+	case 0x39:
+		LoadWord(RAX, OffsetHL);
+		LoadWord(RCX, PairOffsets[Opcode >> 4]);
+		Mov(RDX, RAX);
+		Alu(OpAdd, RDX, RCX);
+		Mov(R8, RDX);
+		Shift(ExtShiftRight, R8, 12);
+		AluImm(ExtAnd, R8, EFlagMask::FC);
+		Alu(OpXor, RAX, RCX);
+		Alu(OpXor, RAX, RDX);
+		AluImm(ExtAnd, RAX, 0x1000);
+		Shift(ExtShiftRight, RAX, 7);
+		Alu(OpOr, RAX, R8);
+		CompileStoreF(RAX, EFlagMask::FZ | 0x0F);
+		StoreWord(OffsetHL, RDX);
+		OpCycles = 8;
+		return true;
+	case 0x02: // LD (BC), A
+	case 0x12: // LD (DE), A
+	case 0x22: // LD (HL+), A
+	case 0x32: // LD (HL-), A
+	case 0x36: // LD (HL), N
+	case 0xEA: // LD (NN), A
+		if (Opcode == 0xEA)
+		{
+			MovImm(RCX, NN);
+		}
+		else
+		{
+			LoadWord(RCX, (Opcode >= 0x20) ? OffsetHL : PairOffsets[Opcode >> 4]);
+		}
+		CompilePageLookup(RCX, true, Index, Cycles);
+		if (Opcode == 0x36)
+		{
+			MovImm(RAX, N);
+		}
+		else
+		{
+			LoadByte(RAX, OffsetA);
+		}
+		StoreByteIndexed(R10, R9, RAX);
+		if ((Opcode == 0x22) || (Opcode == 0x32))
+		{
+			AluImm((Opcode == 0x22) ? ExtAdd : ExtSub, RCX, 1);
+			StoreWord(OffsetHL, RCX);
+		}
+		OpCycles = (Opcode == 0xEA) ? 16 : ((Opcode == 0x36) ? 12 : 8);
+		return true;
+	case 0x0A: // LD A, (BC)
+	case 0x1A: // LD A, (DE)
+	case 0x2A: // LD A, (HL+)
+	case 0x3A: // LD A, (HL-)
+	case 0xFA: // LD A, (NN)
+		if (Opcode == 0xFA)
+		{
+			MovImm(RCX, NN);
+		}
+		else
+		{
+			LoadWord(RCX, (Opcode >= 0x20) ? OffsetHL : PairOffsets[Opcode >> 4]);
+		}
+		CompilePageLookup(RCX, false, Index, Cycles);
+		LoadByteIndexed(RAX, R10, R9);
+		StoreByte(OffsetA, RAX);
+		if ((Opcode == 0x2A) || (Opcode == 0x3A))
+		{
+			AluImm((Opcode == 0x2A) ? ExtAdd : ExtSub, RCX, 1);
+			StoreWord(OffsetHL, RCX);
+		}
+		OpCycles = (Opcode == 0xFA) ? 16 : 8;
+		return true;
+	case 0x2F: // CPL
+		LoadByte(RAX, OffsetA);
+		AluImm(ExtXor, RAX, 0xFF);
+		StoreByte(OffsetA, RAX);
+		LoadByte(RDX, OffsetF);
+		AluImm(ExtOr, RDX, EFlagMask::FN | EFlagMask::FH);
+		StoreByte(OffsetF, RDX);
+		OpCycles = 4;
+		return true;
+	case 0x37: // SCF
+	case 0x3F: // CCF
+		LoadByte(RDX, OffsetF);
+		AluImm(ExtAnd, RDX, uint8(~(EFlagMask::FN | EFlagMask::FH)));
+		if (Opcode == 0x37)
+		{
+			AluImm(ExtOr, RDX, EFlagMask::FC);
+		}
+		else
+		{
+			AluImm(ExtXor, RDX, EFlagMask::FC);
+		}
+		StoreByte(OffsetF, RDX);
+		OpCycles = 4;
+		return true;
+	case 0xF9: // LD SP, HL
+		LoadWord(RAX, OffsetHL);
+		StoreWord(OffsetSP, RAX);
+		OpCycles = 8;
+		return true;
+	case 0x18: // JR
+		CompileExit(uint16(NextPC + int8(N)), Cycles + 12, Index + 1);
+		OpCycles = 12;
+		EndsBlock = true;
+		return true;
+	case 0xC3: // JP NN
+		CompileExit(NN, Cycles + 16, Index + 1);
+		OpCycles = 16;
+		EndsBlock = true;
+		return true;
+	case 0xE9: // JP (HL)
+		LoadWord(RAX, OffsetHL);
+		StoreWord(OffsetPC, RAX);
+		StoreDwordImm(OffsetCycles, Cycles + 4);
+		MovImm(RAX, Index + 1);
+		Return();
+		OpCycles = 4;
+		EndsBlock = true;
+		return true;
+	case 0x20: // JR cc
+	case 0x28:
+	case 0x30:
+	case 0x38:
+	case 0xC2: // JP cc
+	case 0xCA:
+	case 0xD2:
+	case 0xDA:
+	{
+		bool IsJR = Opcode < 0x40;
+		uint16 Target = IsJR ? uint16(NextPC + int8(N)) : NN;
+		uint32 NotTakenCycles = IsJR ? 8 : 12;
+		uint32 TakenCycles = IsJR ? 12 : 16;
+
+		LoadByte(RAX, OffsetF);
+		TestImm(RAX, GetConditionFlag(Opcode));
+		uint32 Taken = JumpIf((Opcode & 0x08) ? CondNotZero : CondZero);
+		CompileExit(NextPC, Cycles + NotTakenCycles, Index + 1);
+		Patch(Taken, m_Used);
+		CompileExit(Target, Cycles + TakenCycles, Index + 1);
+		OpCycles = TakenCycles;
+		EndsBlock = true;
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+void GBRecompiler::CompileALU(uint8 Operation)
+{
+	//operand in ecx, A goes to eax and the new flags collect in edx
+	LoadByte(RAX, OffsetA);
+	switch (Operation)
+	{
+	case 0: // ADD
+	case 1: // ADC
+		if (Operation == 1)
+		{
+			LoadByte(R8, OffsetF);
+			Shift(ExtShiftRight, R8, 4);
+			AluImm(ExtAnd, R8, 1);
+		}
+		Mov(RDX, RAX);
+		AluImm(ExtAnd, RDX, 0x0F);
+		Mov(R9, RCX);
+		AluImm(ExtAnd, R9, 0x0F);
+		Alu(OpAdd, RDX, R9);
+		Alu(OpAdd, RAX, RCX);
+		if (Operation == 1)
+		{
+			Alu(OpAdd, RDX, R8);
+			Alu(OpAdd, RAX, R8);
+		}
+		AluImm(ExtAnd, RDX, 0x10);
+		Shift(ExtShiftLeft, RDX, 1);
+		Mov(R9, RAX);
+		Shift(ExtShiftRight, R9, 4);
+		AluImm(ExtAnd, R9, EFlagMask::FC);
+		Alu(OpOr, RDX, R9);
+		AluImm(ExtAnd, RAX, 0xFF);
+		break;
+	case 2: // SUB
+	case 7: // CP
+		Mov(RDX, RAX);
+		AluImm(ExtAnd, RDX, 0x0F);
+		Mov(R9, RCX);
+		AluImm(ExtAnd, R9, 0x0F);
+		Alu(OpSub, RDX, R9);
+		AluImm(ExtAnd, RDX, 0x10);
+		Shift(ExtShiftLeft, RDX, 1);
+		Alu(OpSub, RAX, RCX);
+		Mov(R9, RAX);
+		Shift(ExtShiftRight, R9, 4);
+		AluImm(ExtAnd, R9, EFlagMask::FC);
+		Alu(OpOr, RDX, R9);
+		AluImm(ExtAnd, RAX, 0xFF);
+		AluImm(ExtOr, RDX, EFlagMask::FN);
+		break;
+	case 3: // SBC
+		LoadByte(R8, OffsetF);
+		Shift(ExtShiftRight, R8, 4);
+		AluImm(ExtAnd, R8, 1);
+		Mov(RDX, RAX);
+		Alu(OpSub, RAX, RCX);
+		Alu(OpSub, RAX, R8);
+		Mov(R9, RAX);
+		Shift(ExtShiftRight, R9, 4);
+		AluImm(ExtAnd, R9, EFlagMask::FC);
+		AluImm(ExtAnd, RAX, 0xFF);
+		Alu(OpXor, RDX, RCX);
+		Alu(OpXor, RDX, RAX);
+		AluImm(ExtAnd, RDX, 0x10);
+		Shift(ExtShiftLeft, RDX, 1);
+		Alu(OpOr, RDX, R9);
+		AluImm(ExtOr, RDX, EFlagMask::FN);
+		break;
+	case 4: // AND
+		Alu(OpAnd, RAX, RCX);
+		MovImm(RDX, EFlagMask::FH);
+		break;
+	case 5: // XOR
+		Alu(OpXor, RAX, RCX);
+		MovImm(RDX, 0);
+		break;
+	default: // OR
+		Alu(OpOr, RAX, RCX);
+		MovImm(RDX, 0);
+		break;
+	}
+
+	CompileZFlag(RDX, RAX);
+	CompileStoreF(RDX, 0x0F);
+	if (Operation != 7)
+	{
+		StoreByte(OffsetA, RAX);
+	}
+}
+
+void GBRecompiler::CompilePageLookup(ERegister Address, bool Write, uint32 Index, uint32 Cycles)
+{
+	Mov(R9, Address);
+	Shift(ExtShiftRight, R9, 8);
+	LoadPointer(R10, Write ? OffsetWritePages : OffsetReadPages);
+	LoadPointerIndexed(R10, R10, R9);
+	TestPointer(R10);
+	m_SideExits.push_back({ JumpIf(CondZero), Index, Cycles });
+	Mov(R9, Address);
+	AluImm(ExtAnd, R9, 0xFF);
+}
+
+void GBRecompiler::CompileZFlag(ERegister Flags, ERegister Result)
+{
+	Alu(OpTest, Result, Result);
+	SetIfZero(R9);
+	Shift(ExtShiftLeft, R9, 7);
+	Alu(OpOr, Flags, R9);
+}
+
+void GBRecompiler::CompileStoreF(ERegister Flags, uint8 KeepMask)
+{
+	LoadByte(R8, OffsetF);
+	AluImm(ExtAnd, R8, KeepMask);
+	Alu(OpOr, R8, Flags);
+	StoreByte(OffsetF, R8);
+}
+
+void GBRecompiler::CompileExit(uint16 PC, uint32 Cycles, uint32 OpIndex)
+{
+	StoreWordImm(OffsetPC, PC);
+	StoreDwordImm(OffsetCycles, Cycles);
+	MovImm(RAX, OpIndex);
+	Return();
+}
+
+void GBRecompiler::Word(uint16 Value)
+{
+	memcpy(m_Code + m_Used, &Value, sizeof(Value));
+	m_Used += sizeof(Value);
+}
+
+void GBRecompiler::Dword(uint32 Value)
+{
+	memcpy(m_Code + m_Used, &Value, sizeof(Value));
+	m_Used += sizeof(Value);
+}
+
+void GBRecompiler::Rex(bool Wide, uint8 Reg, uint8 Index, uint8 Base, bool Force)
+{
+	uint8 Prefix = 0x40 | (Wide ? 0x08 : 0) | ((Reg & 8) ? 0x04 : 0) | ((Index & 8) ? 0x02 : 0) | ((Base & 8) ? 0x01 : 0);
+	if ((Prefix != 0x40) || Force)
+	{
+		Byte(Prefix);
+	}
+}
+
+void GBRecompiler::ModRMDisp(uint8 Reg, uint8 Base, int32 Disp)
+{
+	//the bases used here never need a SIB byte
+	if ((Disp == 0) && ((Base & 7) != 5))
+	{
+		Byte(((Reg & 7) << 3) | (Base & 7));
+	}
+	else if ((Disp >= -128) && (Disp <= 127))
+	{
+		Byte(0x40 | ((Reg & 7) << 3) | (Base & 7));
+		Byte(uint8(Disp));
+	}
+	else
+	{
+		Byte(0x80 | ((Reg & 7) << 3) | (Base & 7));
+		Dword(uint32(Disp));
+	}
+}
+
+void GBRecompiler::ModRMIndex(uint8 Reg, uint8 Base, uint8 Index, uint8 Scale)
+{
+	Byte(0x04 | ((Reg & 7) << 3));
+	Byte((Scale << 6) | ((Index & 7) << 3) | (Base & 7));
+}
+
+void GBRecompiler::ModRMReg(uint8 Reg, uint8 Rm)
+{
+	Byte(0xC0 | ((Reg & 7) << 3) | (Rm & 7));
+}
+
+void GBRecompiler::LoadByte(ERegister Dest, uint8 Offset)
+{
+	Rex(false, Dest, 0, R11);
+	Byte(0x0F); Byte(0xB6); // movzx r32, byte [r11 + Offset]
+	ModRMDisp(Dest, R11, Offset);
+}
+
+void GBRecompiler::LoadWord(ERegister Dest, uint8 Offset)
+{
+	Rex(false, Dest, 0, R11);
+	Byte(0x0F); Byte(0xB7); // movzx r32, word [r11 + Offset]
+	ModRMDisp(Dest, R11, Offset);
+}
+
+void GBRecompiler::StoreByte(uint8 Offset, ERegister Source)
+{
+	Rex(false, Source, 0, R11, true);
+	Byte(0x88);
+	ModRMDisp(Source, R11, Offset);
+}
+
+void GBRecompiler::StoreWord(uint8 Offset, ERegister Source)
+{
+	Byte(0x66);
+	Rex(false, Source, 0, R11);
+	Byte(0x89);
+	ModRMDisp(Source, R11, Offset);
+}
+
+void GBRecompiler::StoreWordImm(uint8 Offset, uint16 Value)
+{
+	Byte(0x66);
+	Rex(false, 0, 0, R11);
+	Byte(0xC7);
+	ModRMDisp(0, R11, Offset);
+	Word(Value);
+}
+
+void GBRecompiler::StoreDwordImm(uint8 Offset, uint32 Value)
+{
+	Rex(false, 0, 0, R11);
+	Byte(0xC7);
+	ModRMDisp(0, R11, Offset);
+	Dword(Value);
+}
+
+void GBRecompiler::LoadPointer(ERegister Dest, uint8 Offset)
+{
+	Rex(true, Dest, 0, R11);
+	Byte(0x8B);
+	ModRMDisp(Dest, R11, Offset);
+}
+
+void GBRecompiler::LoadPointerIndexed(ERegister Dest, ERegister Base, ERegister Index)
+{
+	Rex(true, Dest, Index, Base);
+	Byte(0x8B);
+	ModRMIndex(Dest, Base, Index, 3);
+}
+
+void GBRecompiler::LoadByteIndexed(ERegister Dest, ERegister Base, ERegister Index)
+{
+	Rex(false, Dest, Index, Base);
+	Byte(0x0F); Byte(0xB6);
+	ModRMIndex(Dest, Base, Index, 0);
+}
+
+void GBRecompiler::StoreByteIndexed(ERegister Base, ERegister Index, ERegister Source)
+{
+	Rex(false, Source, Index, Base, true);
+	Byte(0x88);
+	ModRMIndex(Source, Base, Index, 0);
+}
+
+void GBRecompiler::MovImm(ERegister Dest, uint32 Value)
+{
+	Rex(false, 0, 0, Dest);
+	Byte(0xB8 + (Dest & 7));
+	Dword(Value);
+}
+
+void GBRecompiler::Mov(ERegister Dest, ERegister Source)
+{
+	Alu(0x89, Dest, Source);
+}
+
+void GBRecompiler::Alu(uint8 Opcode, ERegister Dest, ERegister Source)
+{
+	Rex(false, Source, 0, Dest);
+	Byte(Opcode);
+	ModRMReg(Source, Dest);
+}
+
+void GBRecompiler::AluImm(uint8 Extension, ERegister Dest, uint32 Value)
+{
+	Rex(false, 0, 0, Dest);
+	Byte(0x81);
+	ModRMReg(Extension, Dest);
+	Dword(Value);
+}
+
+void GBRecompiler::Shift(uint8 Extension, ERegister Dest, uint8 Count)
+{
+	Rex(false, 0, 0, Dest);
+	Byte(0xC1);
+	ModRMReg(Extension, Dest);
+	Byte(Count);
+}
+
+void GBRecompiler::TestImm(ERegister Dest, uint32 Value)
+{
+	Rex(false, 0, 0, Dest);
+	Byte(0xF7);
+	ModRMReg(0, Dest);
+	Dword(Value);
+}
+
+void GBRecompiler::TestPointer(ERegister Reg)
+{
+	Rex(true, Reg, 0, Reg);
+	Byte(0x85);
+	ModRMReg(Reg, Reg);
+}
+
+void GBRecompiler::SetIfZero(ERegister Dest)
+{
+	Rex(false, 0, 0, Dest, true);
+	Byte(0x0F); Byte(0x94); // setz r8
+	ModRMReg(0, Dest);
+	Rex(false, Dest, 0, Dest, true);
+	Byte(0x0F); Byte(0xB6); // movzx r32, r8
+	ModRMReg(Dest, Dest);
+}
+
+uint32 GBRecompiler::JumpIf(uint8 Condition)
+{
+	Byte(0x0F);
+	Byte(0x80 + Condition);
+	uint32 At = m_Used;
+	Dword(0);
+	return At;
+}
+
+void GBRecompiler::Patch(uint32 At, uint32 Target)
+{
+	int32 Relative = int32(Target) - int32(At + 4);
+	memcpy(m_Code + At, &Relative, sizeof(Relative));
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Types.h"
+#include "BlockCache.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define GB_RECOMPILER 1
+#else
+#define GB_RECOMPILER 0
+#endif
+
+//What native code sees of the machine, copied in before and out after every run. Register pairs keep
+//the CPU's byte order, low register first
+struct GBJitContext
+{
+	uint16 AF;
+	uint16 BC;
+	uint16 DE;
+	uint16 HL;
+	uint16 SP;
+	uint16 PC;
+	//cycles the run took, written at every exit
+	uint32 Cycles;
+	uint8* const* ReadPages;
+	uint8* const* WritePages;
+};
+
+//Translates decoded blocks to x86-64. Only plain register and memory instructions are translated,
+//the native code stops at the first op it doesn't cover and hands it to the interpreter. Memory goes
+//through the direct pages only: an access that would hit an I/O or write protected page leaves the
+//block before that instruction, so I/O always runs interpreted at its exact cycle. Cycles are known
+//per op and only stored at the exits
+class GBRecompiler
+{
+public:
+	//runs through the interpreter before a block is worth translating
+	static constexpr uint32 HotBlockRuns = 8;
+	//a block leaving early this often keeps touching I/O and goes back to the interpreter for good
+	static constexpr uint32 MaxSideExits = 16;
+
+	GBRecompiler();
+	~GBRecompiler();
+
+	static bool IsSupported() { return GB_RECOMPILER != 0; }
+
+	//sets Block.Native and Block.NativeCycles, false if not even the first op could be translated
+	//or the code buffer is full
+	bool Compile(GBDecodedBlock& Block);
+
+	//no room for another block, everything compiled so far has to go
+	bool IsFull() const;
+	void Reset();
+
+private:
+	static constexpr uint32 CodeSize = 4 * 1024 * 1024;
+	//generous bound for one block, side exit stubs included
+	static constexpr uint32 MaxBlockCode = 4096;
+
+	enum ERegister : uint8
+	{
+		RAX = 0,
+		RCX = 1,
+		RDX = 2,
+		R8 = 8,
+		R9 = 9,
+		R10 = 10,
+		R11 = 11
+	};
+
+	struct SideExit
+	{
+		uint32 Patch;
+		uint32 OpIndex;
+		uint32 Cycles;
+	};
+
+	//translates one op starting Cycles into the run, false if it isn't covered. Jumps end the block
+	//and get their exits here, OpCycles is then the longer way out
+	bool CompileOp(const GBDecodedOp& Op, uint32 Index, uint32 Cycles, uint32& OpCycles, bool& EndsBlock);
+	void CompileALU(uint8 Operation);
+	//R9/R10 end up holding the page offset and host page of the address in Address
+	void CompilePageLookup(ERegister Address, bool Write, uint32 Index, uint32 Cycles);
+	void CompileZFlag(ERegister Flags, ERegister Result);
+	void CompileStoreF(ERegister Flags, uint8 KeepMask);
+	void CompileExit(uint16 PC, uint32 Cycles, uint32 OpIndex);
+
+	//x86-64 encoding
+	void Byte(uint8 Value) { m_Code[m_Used++] = Value; }
+	void Word(uint16 Value);
+	void Dword(uint32 Value);
+	void Rex(bool Wide, uint8 Reg, uint8 Index, uint8 Base, bool Force = false);
+	void ModRMDisp(uint8 Reg, uint8 Base, int32 Disp);
+	void ModRMIndex(uint8 Reg, uint8 Base, uint8 Index, uint8 Scale);
+	void ModRMReg(uint8 Reg, uint8 Rm);
+
+	void LoadByte(ERegister Dest, uint8 Offset);
+	void LoadWord(ERegister Dest, uint8 Offset);
+	void StoreByte(uint8 Offset, ERegister Source);
+	void StoreWord(uint8 Offset, ERegister Source);
+	void StoreWordImm(uint8 Offset, uint16 Value);
+	void StoreDwordImm(uint8 Offset, uint32 Value);
+	void LoadPointer(ERegister Dest, uint8 Offset);
+	void LoadPointerIndexed(ERegister Dest, ERegister Base, ERegister Index);
+	void LoadByteIndexed(ERegister Dest, ERegister Base, ERegister Index);
+	void StoreByteIndexed(ERegister Base, ERegister Index, ERegister Source);
+	void MovImm(ERegister Dest, uint32 Value);
+	void Mov(ERegister Dest, ERegister Source);
+	void Alu(uint8 Opcode, ERegister Dest, ERegister Source);
+	void AluImm(uint8 Extension, ERegister Dest, uint32 Value);
+	void Shift(uint8 Extension, ERegister Dest, uint8 Count);
+	void TestImm(ERegister Dest, uint32 Value);
+	void TestPointer(ERegister Reg);
+	void SetIfZero(ERegister Dest);
+	uint32 JumpIf(uint8 Condition);
+	void Patch(uint32 At, uint32 Target);
+	void Return() { Byte(0xC3); }
+
+	uint8* m_Code = nullptr;
+	uint32 m_Used = 0;
+	std::vector<SideExit> m_SideExits;
+};
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "RenderThread.h"
+#include <algorithm>
+#include <chrono>
+
+GBRenderThread::GBRenderThread() :
+	m_WriteIndex(0)
+	, m_ReadIndex(0)
+	, m_PendingFrames(0)
+	, m_Running(false)
+	, m_ConsumerWaiting(false)
+	, m_ProducerWaiting(false)
+{
+	m_Commands.resize(QueueCapacity);
+	m_PresentedFrame.resize(ScreenData::SizeX * ScreenData::SizeY);
+	m_FinishedFrame.resize(ScreenData::SizeX * ScreenData::SizeY);
+	m_DrawnFrame.resize(ScreenData::SizeX * ScreenData::SizeY);
+}
+
+GBRenderThread::~GBRenderThread()
+{
+	Stop();
+}
+
+void GBRenderThread::Start(const uint8* VRAM, const uint8* OAM)
+{
+	Stop();
+
+	memcpy(m_VRAM, VRAM, sizeof(m_VRAM));
+	memcpy(m_OAM, OAM, sizeof(m_OAM));
+	m_TileCache.Init(m_VRAM);
+	//finished frames are picked up from the back buffer, not presented from here
+	m_Rendering.Init(nullptr);
+
+	m_Running.store(true, std::memory_order_release);
+	m_Thread = std::thread(&GBRenderThread::ThreadMain, this);
+}
+
+void GBRenderThread::Stop()
+{
+	{
+		//under the lock, so neither side can check its wait condition and then miss the wake up
+		std::lock_guard<std::mutex> Lock(m_WakeMutex);
+		m_Running.store(false, std::memory_order_release);
+	}
+	m_CommandsReady.notify_all();
+	m_SpaceReady.notify_all();
+
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+}
+
+void GBRenderThread::PushLine(uint8 LineNumber, const GBLineState& State)
+{
+	//the render thread is far behind: rather than wait for it, the rest of this frame isn't drawn.
+	//Its lines already queued get drawn over by the next frame, the one that is presented
+	if (m_DroppingFrame || (GetQueued() >= LineLimit))
+	{
+		m_DroppingFrame = true;
+		return;
+	}
+
+	GBRenderCommand Command;
+	Command.Type = GBRenderCommands::Line;
+	Command.Value = 0;
+	Command.Index = LineNumber;
+	Command.State = State;
+	Push(Command);
+}
+
+void GBRenderThread::PushVRAMWrite(uint16 Offset, uint8 Value)
+{
+	GBRenderCommand Command;
+	Command.Type = GBRenderCommands::VRAMWrite;
+	Command.Value = Value;
+	Command.Index = Offset;
+	Push(Command);
+}
+
+void GBRenderThread::PushOAMWrite(uint8 Offset, uint8 Value)
+{
+	GBRenderCommand Command;
+	Command.Type = GBRenderCommands::OAMWrite;
+	Command.Value = Value;
+	Command.Index = Offset;
+	Push(Command);
+}
+
+void GBRenderThread::PushEndFrame()
+{
+	if (m_DroppingFrame)
+	{
+		//never presented, so never pending either
+		m_DroppingFrame = false;
+		return;
+	}
+
+	GBRenderCommand Command;
+	Command.Type = GBRenderCommands::EndFrame;
+	Command.Value = 0;
+	Command.Index = 0;
+	Push(Command);
+
+	m_PendingFrames.fetch_add(1, std::memory_order_release);
+}
+
+bool GBRenderThread::PresentFinishedFrame(IVideoSink* VideoSink, uint32 WaitMilliseconds)
+{
+	{
+		std::unique_lock<std::mutex> Lock(m_FrameMutex);
+		if (!m_FrameReady.wait_for(Lock, std::chrono::milliseconds(WaitMilliseconds), [this]() { return m_FrameFinished; }))
+		{
+			return false;
+		}
+		m_FinishedFrame.swap(m_PresentedFrame);
+		m_FrameFinished = false;
+	}
+
+	//outside the lock, the render thread can finish the next frame meanwhile
+	if (VideoSink != nullptr)
+	{
+		VideoSink->PresentFrame(m_PresentedFrame.data());
+	}
+	return true;
+}
+
+void GBRenderThread::Push(const GBRenderCommand& Command)
+{
+	uint32 Write = m_WriteIndex.load(std::memory_order_relaxed);
+
+	//VRAM and OAM writes can't be dropped without corrupting the copy. Lines stop well before the
+	//queue is full, so this only waits when the render thread is badly starved
+	if ((Write - m_ReadIndex.load(std::memory_order_acquire)) >= QueueCapacity)
+	{
+		std::unique_lock<std::mutex> Lock(m_WakeMutex);
+		m_ProducerWaiting.store(true);
+		m_SpaceReady.wait(Lock, [&]() { return !m_Running.load(std::memory_order_acquire) || ((Write - m_ReadIndex.load()) < QueueCapacity); });
+		m_ProducerWaiting.store(false);
+
+		if (!m_Running.load(std::memory_order_acquire))
+		{
+			return;
+		}
+	}
+
+	m_Commands[Write & (QueueCapacity - 1)] = Command;
+	m_WriteIndex.store(Write + 1);
+
+	//a sleeping render thread is woken for a whole frame, or before lines start being dropped
+	if (m_ConsumerWaiting.load() && ((Command.Type == GBRenderCommands::EndFrame) || ((Write + 1 - m_ReadIndex.load(std::memory_order_relaxed)) >= QueueCapacity / 4)))
+	{
+		std::lock_guard<std::mutex> Lock(m_WakeMutex);
+		m_CommandsReady.notify_one();
+	}
+}
+
+void GBRenderThread::ThreadMain()
+{
+	uint32 Read = m_ReadIndex.load(std::memory_order_relaxed);
+	while (m_Running.load(std::memory_order_acquire))
+	{
+		if (Read == m_WriteIndex.load(std::memory_order_acquire))
+		{
+			std::unique_lock<std::mutex> Lock(m_WakeMutex);
+			m_ConsumerWaiting.store(true);
+			m_CommandsReady.wait(Lock, [&]() { return !m_Running.load(std::memory_order_acquire) || (m_WriteIndex.load() != Read); });
+			m_ConsumerWaiting.store(false);
+			continue;
+		}
+
+		//the slot is handed back as soon as it's copied out, not after drawing and handing over the frame
+		GBRenderCommand Command = m_Commands[Read & (QueueCapacity - 1)];
+		m_ReadIndex.store(++Read);
+		if (m_ProducerWaiting.load())
+		{
+			std::lock_guard<std::mutex> Lock(m_WakeMutex);
+			m_SpaceReady.notify_one();
+		}
+
+		Execute(Command);
+	}
+}
+
+void GBRenderThread::Execute(const GBRenderCommand& Command)
+{
+	switch (Command.Type)
+	{
+	case GBRenderCommands::Line:
+	{
+		if (!m_FrameStarted)
+		{
+			//a newer complete frame is already queued, only keep VRAM and OAM up to date
+			m_FrameStarted = true;
+			m_DrawingFrame = m_PendingFrames.load(std::memory_order_acquire) < 2;
+		}
+
+		if (m_DrawingFrame)
+		{
+			GBVideoMemory Memory;
+			Memory.VRAM = m_VRAM;
+			Memory.OAM = m_OAM;
+			Memory.TileCache = &m_TileCache;
+			m_Rendering.DrawLine(Command.Index, Command.State, Memory);
+		}
+	}
+	break;
+	case GBRenderCommands::VRAMWrite:
+		m_VRAM[Command.Index] = Command.Value;
+		m_TileCache.Invalidate(Command.Index);
+		break;
+	case GBRenderCommands::OAMWrite:
+		m_OAM[Command.Index] = Command.Value;
+		break;
+	case GBRenderCommands::EndFrame:
+		if (m_DrawingFrame)
+		{
+			m_Rendering.Render();
+			FinishFrame();
+		}
+		m_FrameStarted = false;
+		m_DrawingFrame = true;
+		m_PendingFrames.fetch_sub(1, std::memory_order_acq_rel);
+		break;
+	default:
+		break;
+	}
+}
+
+void GBRenderThread::FinishFrame()
+{
+	const GBColor* Frame = m_Rendering.GetFrameBuffer();
+	std::copy(Frame, Frame + m_DrawnFrame.size(), m_DrawnFrame.begin());
+
+	//only buffers change hands under the lock, a frame the frontend hasn't picked up is replaced
+	{
+		std::lock_guard<std::mutex> Lock(m_FrameMutex);
+		m_DrawnFrame.swap(m_FinishedFrame);
+		m_FrameFinished = true;
+	}
+	m_FrameReady.notify_one();
+}
\ No newline at end of file
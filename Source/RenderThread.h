@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Types.h"
+#include "Platform.h"
+#include "Rendering.h"
+#include "TileCache.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GBRenderCommands
+{
+	static constexpr uint8 Line = 0;
+	static constexpr uint8 VRAMWrite = 1;
+	static constexpr uint8 OAMWrite = 2;
+	static constexpr uint8 EndFrame = 3;
+}
+
+struct GBRenderCommand
+{
+	uint8 Type;
+	uint8 Value;
+	//line number or VRAM/OAM offset
+	uint16 Index;
+	GBLineState State;
+};
+
+//Draws on its own thread from a lock-free queue of per line register snapshots and VRAM/OAM writes.
+//Finished frames are picked up by the frontend thread, which presents them: the video sink, like an
+//SDL window, stays on the thread that created it and the emulation thread never waits on it.
+//The emulation thread is the only producer, the render thread the only consumer.
+class GBRenderThread
+{
+public:
+	static constexpr uint32 QueueCapacity = 1 << 16;
+	//lines are dropped once this much of the queue is taken, what's left is for VRAM/OAM writes
+	static constexpr uint32 LineLimit = QueueCapacity - QueueCapacity / 4;
+
+	GBRenderThread();
+	~GBRenderThread();
+
+	//VRAM and OAM are copied as they are now, everything later arrives as writes
+	void Start(const uint8* VRAM, const uint8* OAM);
+	void Stop();
+
+	//emulation thread
+	void PushLine(uint8 LineNumber, const GBLineState& State);
+	void PushVRAMWrite(uint16 Offset, uint8 Value);
+	void PushOAMWrite(uint8 Offset, uint8 Value);
+	void PushEndFrame();
+
+	//frontend thread: hands the newest finished frame to VideoSink, waiting up to WaitMilliseconds
+	//for one if it has seen them all. False if none came
+	bool PresentFinishedFrame(IVideoSink* VideoSink, uint32 WaitMilliseconds);
+
+private:
+	using FrameBuffer = std::vector<GBColor>;
+
+	void Push(const GBRenderCommand& Command);
+	uint32 GetQueued() const { return m_WriteIndex.load(std::memory_order_relaxed) - m_ReadIndex.load(std::memory_order_acquire); }
+	void ThreadMain();
+	void Execute(const GBRenderCommand& Command);
+	void FinishFrame();
+
+	std::vector<GBRenderCommand> m_Commands;
+	ALIGN(64) std::atomic<uint32> m_WriteIndex;
+	ALIGN(64) std::atomic<uint32> m_ReadIndex;
+	//frames pushed but not drawn yet, the consumer skips drawing frames that are already stale
+	std::atomic<uint32> m_PendingFrames;
+	std::atomic<bool> m_Running;
+	std::thread m_Thread;
+
+	//either side sets its flag before sleeping, the other only takes the lock to wake it when it is set
+	std::mutex m_WakeMutex;
+	std::condition_variable m_CommandsReady;
+	std::condition_variable m_SpaceReady;
+	std::atomic<bool> m_ConsumerWaiting;
+	std::atomic<bool> m_ProducerWaiting;
+
+	//emulation thread side: the lines of the frame being pushed no longer fit, skip up to its end
+	bool m_DroppingFrame = false;
+
+	//finished frames, the render thread fills m_DrawnFrame and swaps it with m_FinishedFrame
+	std::mutex m_FrameMutex;
+	std::condition_variable m_FrameReady;
+	FrameBuffer m_FinishedFrame;
+	bool m_FrameFinished = false;
+
+	//frontend thread side
+	FrameBuffer m_PresentedFrame;
+
+	//render thread side
+	GBRendering m_Rendering;
+	uint8 m_VRAM[0x2000];
+	uint8 m_OAM[0x100];
+	GBTileCache m_TileCache;
+	FrameBuffer m_DrawnFrame;
+	bool m_DrawingFrame = true;
+	bool m_FrameStarted = false;
+};
\ No newline at end of file
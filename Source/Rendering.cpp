@@ -1,21 +1,14 @@
 #include "Rendering.h"
-#include "CPU.h"
-#include "SDL.h"
 #include "Log.h"
 #include "Timer.h"
 #include "BinaryOps.h"
+#include "LineCompositor.h"
 
 using namespace BinaryOps;
 
-GBRendering::~GBRendering()
-{
-	SDL_DestroyWindow(m_Window);
-	SDL_DestroyRenderer(m_Renderer);
-	SDL_DestroyTexture(m_Texture);
-	SDL_Quit();
-}
+const GBColor GBRendering::BlankColor = { 0, 0, 0, 0 };
 
-bool GBRendering::Init()
+bool GBRendering::Init(IVideoSink* VideoSink)
 {
 	//				A, B, G, R
 	m_Colors[0] = { 255, 15,188,155 };
@@ -23,57 +16,45 @@ bool GBRendering::Init()
 	m_Colors[2] = { 255, 48,98,48 };
 	m_Colors[3] = { 255, 15, 56, 15 };
 
-	m_Window = SDL_CreateWindow("Gameboy Emulator", 100, 100, ScreenData::SizeX * 4, ScreenData::SizeY * 4, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
-	if (m_Window == nullptr)
-	{
-		SDL_Quit();
-		return 1;
-	}
-
-	m_Renderer = SDL_CreateRenderer(m_Window, -1, SDL_RENDERER_ACCELERATED /*| SDL_RENDERER_PRESENTVSYNC*/);
-	if (m_Renderer == nullptr)
+	for (GBColor (&Frame)[ScreenData::SizeX * ScreenData::SizeY] : m_FrameBuffers)
 	{
-		SDL_DestroyWindow(m_Window);
-		SDL_Quit();
-		return 1;
-	}
-
-	m_Texture = SDL_CreateTexture(m_Renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, ScreenData::SizeX, ScreenData::SizeY);
-	if (m_Texture == nullptr) {
-		SDL_DestroyRenderer(m_Renderer);
-		SDL_DestroyWindow(m_Window);
-		SDL_Quit();
-		return 1;
+		std::fill(std::begin(Frame), std::end(Frame), BlankColor);
 	}
 
+	m_VideoSink = VideoSink;
 	return true;
 }
 
-void GBRendering::DrawSpriteLine(class GameBoyCPU* CPU, class GPU* InGPU, int32 lineNumber)
+void GBRendering::DrawLine(int32 lineNumber, const GBLineState& State, GBVideoMemory& Memory)
 {
-	const uint32 SpriteSizeBytes = 16;
+	InitLine(lineNumber);
+	DrawLineBackground(State, Memory, lineNumber);
+	DrawLineWindow(State, Memory, lineNumber);
 
-	uint8 BGPalette = CPU->ReadMemory(MemRegisters::BGPalette, true);
-	uint8 BGPaletteArray[4];
-	BGPaletteArray[0] = BGPalette & 0x03;
-	BGPaletteArray[1] = (BGPalette >> 2) & 0x03;
-	BGPaletteArray[2] = (BGPalette >> 4) & 0x03;
-	BGPaletteArray[3] = (BGPalette >> 6) & 0x03;
-
-	//loop through sprites
-	for (int32 i = 156; i>=0 ; i-=4)
+	if (State.AreSpritesEnabled())
 	{
-		uint8 YPos = InGPU->m_OAM[i]; //pos - 16
-		uint8 XPos = InGPU->m_OAM[i + 1]; // pos - 8
+		DrawSpriteLine(State, Memory, lineNumber);
+	}
+}
+
+void GBRendering::DrawSpriteLine(const GBLineState& State, GBVideoMemory& Memory, int32 lineNumber)
+{
+	uint8 SpriteSizeY = State.GetSpriteHeight();
 
-		uint8 SpriteSizeY = GetBit(2, InGPU->m_LCDControl) ? 16 : 8;
+	//the OAM scan left them in priority order, draw back to front so the highest one ends on top
+	for (int32 Slot = int32(State.SpriteCount) - 1; Slot >= 0; --Slot)
+	{
+		int32 i = State.Sprites[Slot] * 4;
+		uint8 YPos = Memory.OAM[i]; //pos - 16
+		uint8 XPos = Memory.OAM[i + 1]; // pos - 8
 
+		//LCDC may have changed the height since the scan
 		int32 RealY = YPos - 16;
 		if ((RealY <= lineNumber) && ((RealY + SpriteSizeY) > lineNumber))
 		{
 			//am I in the scanline?
-			uint8 SpriteIndex = InGPU->m_OAM[i + 2];
-			uint8 SpriteFlags = InGPU->m_OAM[i + 3];
+			uint8 SpriteIndex = Memory.OAM[i + 2];
+			uint8 SpriteFlags = Memory.OAM[i + 3];
 
 			if (SpriteSizeY == 16)
 			{
@@ -85,35 +66,42 @@ void GBRendering::DrawSpriteLine(class GameBoyCPU* CPU, class GPU* InGPU, int32
 			bool SpritePriority = GetBit(7, SpriteFlags);
 			bool YFlip = GetBit(6, SpriteFlags);
 			bool XFlip = GetBit(5, SpriteFlags);
-			uint8 ObjPalette = GetBit(4, SpriteFlags) ? InGPU->m_OBJPalette1 : InGPU->m_ObjPalette0;
+			uint8 ObjPalette = GetBit(4, SpriteFlags) ? State.ObjPalette1 : State.ObjPalette0;
 
-			uint8 PaletteArray[4];
-			PaletteArray[0] = 0x00; // transparent
-			PaletteArray[1] = (ObjPalette >> 2) & 0x03;
-			PaletteArray[2] = (ObjPalette >> 4) & 0x03;
-			PaletteArray[3] = (ObjPalette >> 6) & 0x03;
+			GBColor PaletteArray[4];
+			PaletteArray[0] = m_Colors[0]; // transparent, never drawn
+			PaletteArray[1] = m_Colors[(ObjPalette >> 2) & 0x03];
+			PaletteArray[2] = m_Colors[(ObjPalette >> 4) & 0x03];
+			PaletteArray[3] = m_Colors[(ObjPalette >> 6) & 0x03];
 
-			//direct access to VRAM
-			const uint16 TileData = 0x0000;
+			//8x16 sprites continue in the next tile
 			uint8 TileYOffset = YFlip ? ((SpriteSizeY - 1) - (lineNumber - RealY)) : (lineNumber - RealY);
-			uint16 TilePointer = TileData + (SpriteIndex * SpriteSizeBytes) + (TileYOffset * 2);
+			const uint8* TileRow = Memory.TileCache->GetTileRow(SpriteIndex + (TileYOffset / 8), TileYOffset % 8);
+
+			uint8 SpritePixels[8];
+			for (int32 X = 0; X < 8; ++X)
+			{
+				SpritePixels[X] = TileRow[XFlip ? 7 - X : X];
+			}
 
-			uint8 PixelColorIndexA = InGPU->m_VRAM[TilePointer];
-			uint8 PixelColorIndexB = InGPU->m_VRAM[TilePointer + 1];
+			if ((RealX >= 0) && (RealX + 8 <= ScreenData::SizeX))
+			{
+				LineCompositor::DrawSpriteRow(SpritePixels, PaletteArray, SpritePriority, &m_BGLinePixels[RealX], &m_LineBuffer[RealX]);
+				continue;
+			}
 
-			//go through the 8 pixels of the sprite
+			//clipped at the screen edges
 			for (int32 X = 0; X < 8; ++X)
 			{
-				int32 FlippedX = XFlip ? 7 - X : X;
 				int32 ActualCoordX = X + RealX;
 
-				uint8 Col = ((uint8)GetBit(7 - FlippedX, PixelColorIndexA) ) | ((uint8)GetBit(7 - FlippedX, PixelColorIndexB) << 1);
+				uint8 Col = SpritePixels[X];
 				if ((Col != 0x00) && (ActualCoordX >=0 && ActualCoordX < ScreenData::SizeX))
 				{
 					//check Priority
 					if (!SpritePriority || (SpritePriority && (m_BGLinePixels[ActualCoordX] == 0)))
 					{
-						m_LineBuffer[ActualCoordX] = m_Colors[PaletteArray[Col]];
+						m_LineBuffer[ActualCoordX] = PaletteArray[Col];
 					}
 				}
 			}
@@ -121,12 +109,12 @@ void GBRendering::DrawSpriteLine(class GameBoyCPU* CPU, class GPU* InGPU, int32
 	}
 }
 
-void GBRendering::DrawLineBackground(class GameBoyCPU* CPU, class GPU* InGPU, int32 lineNumber)
+void GBRendering::DrawLineBackground(const GBLineState& State, GBVideoMemory& Memory, int32 lineNumber)
 {
-	if (InGPU->IsLCDEnabled())
+	if (State.IsLCDEnabled())
 	{
 		bool ShouldDraw = false;
-		ShouldDraw = InGPU->IsBGEnabled();
+		ShouldDraw = State.IsBGEnabled();
 
 		if (!ShouldDraw)
 		{
@@ -134,18 +122,13 @@ void GBRendering::DrawLineBackground(class GameBoyCPU* CPU, class GPU* InGPU, in
 		}
 
 		//Background
-		uint16 MapAddress = 0;
-		MapAddress = InGPU->GetBGTileMapAddress();
-
-		uint16 BgWinTileDataAddress = InGPU->GetBGWinTileDataAddress();
-
-		uint8 ScrollY = InGPU->m_ScrollY;
-		uint8 ScrollX = InGPU->m_ScrollX;
+		uint16 MapAddress = State.GetBGTileMapAddress();
+		bool UnsignedAddressing = State.IsUnsignedTileData();
 
-		uint8 TileScrollY = ScrollY / 8;
-		uint8 TileScrollX = ScrollX / 8;
+		uint8 ScrollY = State.ScrollY;
+		uint8 ScrollX = State.ScrollX;
 
-		uint8 Palette = CPU->ReadMemory(MemRegisters::BGPalette, true);
+		uint8 Palette = State.BGPalette;
 
 		GBColor PaletteArray[4];
 		PaletteArray[0] = m_Colors[Palette & 0x03];
@@ -153,57 +136,31 @@ void GBRendering::DrawLineBackground(class GameBoyCPU* CPU, class GPU* InGPU, in
 		PaletteArray[2] = m_Colors[(Palette >> 4) & 0x03];
 		PaletteArray[3] = m_Colors[(Palette >> 6) & 0x03];
 
+		int32 ActualCoordY = (ScrollY + lineNumber) % ScreenData::FullSizeY;
+		int32 PixelInTileY = ActualCoordY % 8;
+		const uint8* MapRow = &Memory.VRAM[MapAddress - 0x8000 + (ActualCoordY / 8) * ScreenData::FullTileSizeX];
 
-		//Add scroll support
-		for (int32 X = 0; X < ScreenData::SizeX; ++X)
+		//21 tiles cover the line whatever the fine scroll, copy whole rows and start at the scrolled pixel
+		uint8 TilePixels[(ScreenData::TileSizeX + 1) * 8];
+		int32 FirstTileX = ScrollX / 8;
+		for (int32 Tile = 0; Tile <= ScreenData::TileSizeX; ++Tile)
 		{
-			int32 ActualCoordX = ScrollX + X;
-			ActualCoordX = ActualCoordX % ScreenData::FullSizeX;
-			int32 ActualCoordY = ScrollY + lineNumber;
-			ActualCoordY = ActualCoordY % ScreenData::FullSizeY;
-
-			int32 TileX = ActualCoordX / 8;
-			int32 TileY = ActualCoordY / 8;
-
-			int32 PixelInTileX = ActualCoordX % 8;
-			int32 PixelInTileY = ActualCoordY % 8;
-
-			uint16 BGMapAddress = MapAddress + (TileY * ScreenData::FullTileSizeX) + TileX;
-			//direct VRAM access
-			uint8 TileIndex = InGPU->m_VRAM[BGMapAddress - 0x8000];
-
-			uint16 TileDataBaseAddress = 0;
-			if (GetBit(4, InGPU->m_LCDControl))
-			{
-				TileDataBaseAddress = BgWinTileDataAddress + (16 * TileIndex) + (2 * PixelInTileY);
-			}
-			else
-			{
-				TileDataBaseAddress = BgWinTileDataAddress + (16 * int8(TileIndex)) + (2 * PixelInTileY);
-			}
-
-			uint16 TileDataAddressA = TileDataBaseAddress + 0;
-			uint16 TileDataAddressB = TileDataBaseAddress + 1;
-
-			uint8 PixelColorIndexA = InGPU->m_VRAM[TileDataAddressA - 0x8000];
-			uint8 PixelColorIndexB = InGPU->m_VRAM[TileDataAddressB - 0x8000];
-
-			uint8 Col = ((uint8)GetBit(7 - PixelInTileX, PixelColorIndexA) ) | ((uint8)GetBit(7 - PixelInTileX, PixelColorIndexB) << 1);
-
-			//int32 TileInitAddress = (ScreenData::SizeX * lineNumber) + X;
-
-			m_LineBuffer[X] = PaletteArray[Col];
-			m_BGLinePixels[X] = Col;
+			uint8 TileIndex = MapRow[(FirstTileX + Tile) % ScreenData::FullTileSizeX];
+			const uint8* TileRow = Memory.TileCache->GetTileRow(GBTileCache::GetBGTile(TileIndex, UnsignedAddressing), PixelInTileY);
+			memcpy(&TilePixels[Tile * 8], TileRow, 8);
 		}
+
+		memcpy(m_BGLinePixels, &TilePixels[ScrollX % 8], ScreenData::SizeX);
+		LineCompositor::ApplyPalette(m_BGLinePixels, PaletteArray, m_LineBuffer, ScreenData::SizeX);
 	}
 }
 
-void GBRendering::DrawLineWindow(class GameBoyCPU* CPU, class GPU* InGPU, int32 lineNumber)
+void GBRendering::DrawLineWindow(const GBLineState& State, GBVideoMemory& Memory, int32 lineNumber)
 {
-	if (InGPU->IsLCDEnabled())
+	if (State.IsLCDEnabled())
 	{
 		bool ShouldDraw = false;
-		ShouldDraw = InGPU->IsWinEnabled();
+		ShouldDraw = State.IsWinEnabled();
 
 		if (!ShouldDraw)
 		{
@@ -211,95 +168,70 @@ void GBRendering::DrawLineWindow(class GameBoyCPU* CPU, class GPU* InGPU, int32
 		}
 
 		//Background
-		uint16 MapAddress = 0;
-		MapAddress = InGPU->GetWinTileMapAddress();
-
-		uint16 BgWinTileDataAddress = InGPU->GetBGWinTileDataAddress();
+		uint16 MapAddress = State.GetWinTileMapAddress();
+		bool UnsignedAddressing = State.IsUnsignedTileData();
 
-		uint8 ScrollX = InGPU->m_WinPosX - 7;
-		uint8 ScrollY = InGPU->m_WinPosY;
+		uint8 ScrollX = State.WinPosX - 7;
+		uint8 ScrollY = State.WinPosY;
 
 		int WinY = lineNumber - ScrollY;
 
-		if (WinY < 0)
+		if ((WinY < 0) || (ScrollX >= ScreenData::SizeX))
 		{
 			//not visible
 			return;
 		}
 
-		uint8 Palette = CPU->ReadMemory(MemRegisters::BGPalette, true);
-		uint8 PaletteArray[4];
-		PaletteArray[0] = Palette & 0x03;
-		PaletteArray[1] = (Palette >> 2) & 0x03;
-		PaletteArray[2] = (Palette >> 4) & 0x03;
-		PaletteArray[3] = (Palette >> 6) & 0x03;
-
-		//Add scroll support
-		for (int32 X = 0; X < ScreenData::SizeX; ++X)
-		{
-			if (X < ScrollX)
-			{
-				continue;
-			}
-
-			int32 TileX = uint8((X - ScrollX) / 8);
-			int32 TileY = uint8(WinY / 8);
-
-			int32 PixelInTileX = (X - ScrollX) % 8;
-			int32 PixelInTileY = WinY % 8;
-
-			uint16 WinMapAddress = MapAddress + (TileY * ScreenData::FullTileSizeX) + TileX;
-			uint8 TileIndex = CPU->ReadMemory(WinMapAddress, true);
-
-			uint16 TileDataBaseAddress = 0;
-			if (GetBit(4, InGPU->m_LCDControl))
-			{
-				TileDataBaseAddress = BgWinTileDataAddress + (16 * TileIndex) + (2 * PixelInTileY);
-			}
-			else
-			{
-				TileDataBaseAddress = BgWinTileDataAddress + (16 * int8(TileIndex)) + (2 * PixelInTileY);
-			}
-
-			uint16 TileDataAddressA = TileDataBaseAddress + 0;
-			uint16 TileDataAddressB = TileDataBaseAddress + 1;
+		uint8 Palette = State.BGPalette;
+		GBColor PaletteArray[4];
+		PaletteArray[0] = m_Colors[Palette & 0x03];
+		PaletteArray[1] = m_Colors[(Palette >> 2) & 0x03];
+		PaletteArray[2] = m_Colors[(Palette >> 4) & 0x03];
+		PaletteArray[3] = m_Colors[(Palette >> 6) & 0x03];
 
-			uint8 PixelColorIndexA = CPU->ReadMemory(TileDataAddressA, true);
-			uint8 PixelColorIndexB = CPU->ReadMemory(TileDataAddressB, true);
+		int32 PixelInTileY = WinY % 8;
+		const uint8* MapRow = &Memory.VRAM[MapAddress - 0x8000 + uint8(WinY / 8) * ScreenData::FullTileSizeX];
 
-			uint8 Col = ((uint8)GetBit(7 - PixelInTileX, PixelColorIndexA)) | ((uint8)GetBit(7 - PixelInTileX, PixelColorIndexB) << 1);
-			m_LineBuffer[X] = m_Colors[PaletteArray[Col]];
+		//the window always starts on a tile boundary, gather whole tile rows then color them in one go
+		uint8 TilePixels[ScreenData::SizeX + 8];
+		int32 Count = ScreenData::SizeX - ScrollX;
+		for (int32 TileX = 0; TileX * 8 < Count; ++TileX)
+		{
+			const uint8* TileRow = Memory.TileCache->GetTileRow(GBTileCache::GetBGTile(MapRow[TileX], UnsignedAddressing), PixelInTileY);
+			memcpy(&TilePixels[TileX * 8], TileRow, 8);
 		}
+
+		LineCompositor::ApplyPalette(TilePixels, PaletteArray, &m_LineBuffer[ScrollX], Count);
 	}
 }
 
-void GBRendering::CopyLineInTexture(int32 lineNumber)
+void GBRendering::Render()
 {
-	SDL_Rect lineRect;
-	lineRect.x = 0;
-	lineRect.y = lineNumber;
-	lineRect.w = ScreenData::SizeX;
-	lineRect.h = 1;
-	SDL_UpdateTexture(m_Texture, &lineRect, m_LineBuffer, ScreenData::SizeX * 4);
-}
+	//the next frame draws over this one, whichever is presented holds only its own lines
+	if (m_PresentSuppressed)
+	{
+		return;
+	}
 
-bool GBRendering::PollEvents()
-{
-	bool shouldGoOn = true;
-	//window management
-	SDL_Event e;
-	while (SDL_PollEvent(&e) != 0)
+	//a skipped frame drew nothing, the front buffer keeps the last drawn one
+	if (!m_SkippingFrame)
 	{
-		if (e.type == SDL_QUIT)
+		m_BackBuffer ^= 1;
+		if (m_VideoSink != nullptr)
 		{
-			shouldGoOn = false;
+			m_VideoSink->PresentFrame(GetFrameBuffer());
 		}
 	}
-	return shouldGoOn;
-}
 
-void GBRendering::Render(class GameBoyCPU* CPU)
-{
-	SDL_RenderCopy(m_Renderer, m_Texture, NULL, NULL);
-	SDL_RenderPresent(m_Renderer);
+	//decide for the frame starting now
+	if (m_FrameSkip > 0)
+	{
+		m_FrameCounter = (m_FrameCounter + 1) % (m_FrameSkip + 1);
+		m_SkippingFrame = (m_FrameCounter != 0);
+	}
+	else
+	{
+		m_SkippingFrame = m_BehindSchedule && (m_SkippedInRow + 1 < MaxAutoFrameSkip);
+	}
+	m_SkippedInRow = m_SkippingFrame ? m_SkippedInRow + 1 : 0;
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 
 #include "Types.h"
 #include "Constants.h"
+#include "Platform.h"
+#include "BinaryOps.h"
+#include "TileCache.h"
+#include <algorithm>
 
 struct GBColor
 {
@@ -11,32 +15,100 @@ struct GBColor
 	uint8 R;
 };
 
+//Registers the renderer needs for one line, captured by the GPU when the line is drawn
+struct GBLineState
+{
+	static constexpr uint32 MaxSpritesPerLine = 10;
+
+	uint8 LCDControl = 0;
+	uint8 ScrollX = 0;
+	uint8 ScrollY = 0;
+	uint8 WinPosX = 0;
+	uint8 WinPosY = 0;
+	uint8 BGPalette = 0;
+	uint8 ObjPalette0 = 0;
+	uint8 ObjPalette1 = 0;
+
+	//OAM entries picked by the OAM scan, in drawing priority order
+	uint8 SpriteCount = 0;
+	uint8 Sprites[MaxSpritesPerLine];
+
+	bool IsLCDEnabled() const { return BinaryOps::GetBit(7, LCDControl); }
+	bool IsBGEnabled() const { return BinaryOps::GetBit(0, LCDControl); }
+	bool IsWinEnabled() const { return BinaryOps::GetBit(0, LCDControl) && BinaryOps::GetBit(5, LCDControl); }
+	bool AreSpritesEnabled() const { return BinaryOps::GetBit(1, LCDControl); }
+	uint8 GetSpriteHeight() const { return BinaryOps::GetBit(2, LCDControl) ? 16 : 8; }
+
+	uint16 GetBGTileMapAddress() const
+	{
+		return BinaryOps::GetBit(3, LCDControl) ? MemAreas::BgTileMapBit31 : MemAreas::BgTileMapBit30;
+	}
+
+	uint16 GetWinTileMapAddress() const
+	{
+		return BinaryOps::GetBit(6, LCDControl) ? MemAreas::WindowTileMapBit61 : MemAreas::WindowTileMapBit60;
+	}
+
+	//unsigned tile indices from 0x8000, signed ones around 0x9000
+	bool IsUnsignedTileData() const { return BinaryOps::GetBit(4, LCDControl); }
+};
+
+//VRAM and OAM as the renderer reads them, either the GPU's own or a render thread's copy
+struct GBVideoMemory
+{
+	const uint8* VRAM = nullptr;
+	const uint8* OAM = nullptr;
+	GBTileCache* TileCache = nullptr;
+};
+
 class GBRendering
 {
 public:
+	//automatic skipping still draws at least one frame out of this many
+	static constexpr uint32 MaxAutoFrameSkip = 4;
+	//what lines and frames are cleared to: black with a zero alpha, not the opaque GBColor{}
+	static const GBColor BlankColor;
 
-	~GBRendering();
-
-	bool Init();
-	void InitLine()
+	bool Init(IVideoSink* VideoSink);
+	//lines are drawn straight into their row of the back buffer
+	void InitLine(int32 lineNumber)
 	{
-		memset(m_LineBuffer, 0, ScreenData::SizeX * sizeof(GBColor));
+		m_LineBuffer = &m_FrameBuffers[m_BackBuffer][lineNumber * ScreenData::SizeX];
+		std::fill(m_LineBuffer, m_LineBuffer + ScreenData::SizeX, BlankColor);
 	}
-	void Render(class GameBoyCPU* CPU);
-	void DrawLineBackground(class GameBoyCPU* CPU, class GPU* InGPU, int32 lineNumber);
-	void DrawLineWindow(class GameBoyCPU* CPU, class GPU* InGPU, int32 lineNumber);
-	void DrawSpriteLine(class GameBoyCPU* CPU, class GPU* InGPU, int32 lineNumber);
-	void CopyLineInTexture(int32 lineNumber);
+	//VBlank: the finished frame becomes the front buffer and goes to the sink
+	void Render();
+	//background, window and sprites of one line
+	void DrawLine(int32 lineNumber, const GBLineState& State, GBVideoMemory& Memory);
+	void DrawLineBackground(const GBLineState& State, GBVideoMemory& Memory, int32 lineNumber);
+	void DrawLineWindow(const GBLineState& State, GBVideoMemory& Memory, int32 lineNumber);
+	void DrawSpriteLine(const GBLineState& State, GBVideoMemory& Memory, int32 lineNumber);
 
-	bool PollEvents();
+	//0 draws every frame, N draws one frame out of N + 1
+	void SetFrameSkip(uint32 Skip) { m_FrameSkip = Skip; }
+	//with no fixed skip, frames are skipped while this is set
+	void SetBehindSchedule(bool Behind) { m_BehindSchedule = Behind; }
+	bool IsSkippingFrame() const { return m_SkippingFrame; }
+	//run-ahead: frames are still drawn but not presented, and don't count for frame skipping
+	void SetPresentSuppressed(bool Suppressed) { m_PresentSuppressed = Suppressed; }
+	bool IsPresentSuppressed() const { return m_PresentSuppressed; }
+
+	//last complete frame, ScreenData::SizeY rows of ScreenData::SizeX colors
+	const GBColor* GetFrameBuffer() const { return m_FrameBuffers[m_BackBuffer ^ 1]; }
 
 private:
 	GBColor m_Colors[4];
-	GBColor m_LineBuffer[ScreenData::SizeX];
+	GBColor m_FrameBuffers[2][ScreenData::SizeX * ScreenData::SizeY];
+	uint32 m_BackBuffer = 0;
+	GBColor* m_LineBuffer = m_FrameBuffers[0];
 	uint8 m_BGLinePixels[ScreenData::SizeX];
 
-	struct SDL_Window* m_Window = nullptr;
-	struct SDL_Renderer* m_Renderer = nullptr;
-	struct SDL_Texture* m_Texture = nullptr;
-	struct SDL_Texture* m_RenderTarget = nullptr;
+	uint32 m_FrameSkip = 0;
+	uint32 m_FrameCounter = 0;
+	uint32 m_SkippedInRow = 0;
+	bool m_BehindSchedule = false;
+	bool m_SkippingFrame = false;
+	bool m_PresentSuppressed = false;
+
+	IVideoSink* m_VideoSink = nullptr;
 };
\ No newline at end of file
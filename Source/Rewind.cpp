@@ -0,0 +1,238 @@
+#include "Rewind.h"
+#include <assert.h>
+
+namespace
+{
+	//a literal run only ends on this many unchanged bytes, shorter gaps are cheaper kept inline
+	constexpr uint32 MinZeroRun = 4;
+
+	void WriteVarint(std::vector<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.push_back(uint8(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.push_back(uint8(Value));
+	}
+
+	uint32 ReadVarint(const uint8*& Data, const uint8* End)
+	{
+		uint32 Value = 0;
+		for (uint32 Shift = 0; (Data < End) && (Shift < 32); Shift += 7)
+		{
+			uint8 Byte = *Data++;
+			Value |= uint32(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				break;
+			}
+		}
+		return Value;
+	}
+
+	uint8 XorAt(const uint8* Base, const uint8* Raw, uint32 Index)
+	{
+		return Base ? uint8(Raw[Index] ^ Base[Index]) : Raw[Index];
+	}
+
+	//first byte at or after Index that differs from the base
+	uint32 SkipUnchanged(const uint8* Base, const uint8* Raw, uint32 Index, uint32 Size)
+	{
+		//whole words first, most of the state is unchanged
+		static const uint64 Zero = 0;
+		while (Index + sizeof(uint64) <= Size)
+		{
+			const uint8* Expected = Base ? Base + Index : reinterpret_cast<const uint8*>(&Zero);
+			if (memcmp(Raw + Index, Expected, sizeof(uint64)) != 0)
+			{
+				break;
+			}
+			Index += sizeof(uint64);
+		}
+
+		while ((Index < Size) && (XorAt(Base, Raw, Index) == 0))
+		{
+			++Index;
+		}
+		return Index;
+	}
+}
+
+void GBRewindBuffer::SetBudget(size_t Bytes)
+{
+	m_Budget = Bytes;
+	while ((m_MemoryUsed > m_Budget) && (m_KeyframeCount > 1))
+	{
+		DropOldestKeyframe();
+	}
+}
+
+void GBRewindBuffer::Clear()
+{
+	m_Entries.clear();
+	m_KeyframeValid = false;
+	m_KeyframeCount = 0;
+	m_FramesSinceKeyframe = 0;
+	m_MemoryUsed = 0;
+}
+
+void GBRewindBuffer::Encode(const uint8* Base, const uint8* Raw, uint32 Size, std::vector<uint8>& Out)
+{
+	//raw size, then (unchanged count, changed count, changed bytes XOR base) until the end
+	Out.clear();
+	WriteVarint(Out, Size);
+
+	uint32 Index = 0;
+	while (Index < Size)
+	{
+		uint32 LiteralStart = SkipUnchanged(Base, Raw, Index, Size);
+		uint32 LiteralEnd = LiteralStart;
+		while (LiteralEnd < Size)
+		{
+			if (XorAt(Base, Raw, LiteralEnd) != 0)
+			{
+				++LiteralEnd;
+				continue;
+			}
+
+			uint32 ZeroEnd = LiteralEnd;
+			while ((ZeroEnd < Size) && (ZeroEnd - LiteralEnd < MinZeroRun) && (XorAt(Base, Raw, ZeroEnd) == 0))
+			{
+				++ZeroEnd;
+			}
+
+			if ((ZeroEnd - LiteralEnd >= MinZeroRun) || (ZeroEnd == Size))
+			{
+				break;
+			}
+			LiteralEnd = ZeroEnd;
+		}
+
+		WriteVarint(Out, LiteralStart - Index);
+		WriteVarint(Out, LiteralEnd - LiteralStart);
+		for (uint32 i = LiteralStart; i < LiteralEnd; ++i)
+		{
+			Out.push_back(XorAt(Base, Raw, i));
+		}
+		Index = LiteralEnd;
+	}
+}
+
+void GBRewindBuffer::Decode(const uint8* Base, const std::vector<uint8>& Data, std::vector<uint8>& Out)
+{
+	const uint8* Read = Data.data();
+	const uint8* End = Read + Data.size();
+
+	uint32 Size = ReadVarint(Read, End);
+	Out.resize(Size);
+
+	uint32 Index = 0;
+	while ((Index < Size) && (Read < End))
+	{
+		uint32 Unchanged = ReadVarint(Read, End);
+		uint32 Changed = ReadVarint(Read, End);
+		assert((Index + Unchanged + Changed <= Size) && (Read + Changed <= End));
+
+		for (uint32 i = 0; (i < Unchanged) && (Index < Size); ++i, ++Index)
+		{
+			Out[Index] = Base ? Base[Index] : 0;
+		}
+
+		for (uint32 i = 0; (i < Changed) && (Index < Size) && (Read < End); ++i, ++Index)
+		{
+			uint8 Value = *Read++;
+			Out[Index] = Base ? uint8(Value ^ Base[Index]) : Value;
+		}
+	}
+}
+
+void GBRewindBuffer::Push(const GBSaveState& State)
+{
+	State.Serialize(m_Serialized);
+
+	//a new keyframe once in a while so deltas stay small, and whenever the layout changed
+	bool IsKeyframe = !m_KeyframeValid
+		|| (m_FramesSinceKeyframe >= m_KeyframeInterval)
+		|| (m_Serialized.size() != m_Keyframe.size());
+
+	//encoded into scratch space first so every entry is allocated at its exact size
+	Encode(IsKeyframe ? nullptr : m_Keyframe.data(), m_Serialized.data(), uint32(m_Serialized.size()), m_Encoded);
+
+	Entry NewEntry;
+	NewEntry.Data.assign(m_Encoded.begin(), m_Encoded.end());
+	NewEntry.IsKeyframe = IsKeyframe;
+
+	if (IsKeyframe)
+	{
+		m_Keyframe = m_Serialized;
+		m_KeyframeValid = true;
+		m_FramesSinceKeyframe = 0;
+		m_KeyframeCount++;
+	}
+	m_FramesSinceKeyframe++;
+
+	m_MemoryUsed += NewEntry.Data.size();
+	m_Entries.push_back(std::move(NewEntry));
+
+	//the newest keyframe is always kept, even if it alone is over budget
+	while ((m_MemoryUsed > m_Budget) && (m_KeyframeCount > 1))
+	{
+		DropOldestKeyframe();
+	}
+}
+
+bool GBRewindBuffer::Pop(GBSaveState& State)
+{
+	if (m_Entries.empty())
+	{
+		return false;
+	}
+
+	if (!m_KeyframeValid)
+	{
+		//the previous group's keyframe, the last one left
+		m_FramesSinceKeyframe = 0;
+		for (auto It = m_Entries.rbegin(); It != m_Entries.rend(); ++It)
+		{
+			m_FramesSinceKeyframe++;
+			if (It->IsKeyframe)
+			{
+				Decode(nullptr, It->Data, m_Keyframe);
+				m_KeyframeValid = true;
+				break;
+			}
+		}
+	}
+
+	Entry& Last = m_Entries.back();
+	if (Last.IsKeyframe)
+	{
+		m_Serialized = m_Keyframe;
+		m_KeyframeValid = false;
+		m_KeyframeCount--;
+		m_FramesSinceKeyframe = 0;
+	}
+	else
+	{
+		Decode(m_Keyframe.data(), Last.Data, m_Serialized);
+		m_FramesSinceKeyframe = (m_FramesSinceKeyframe > 0) ? m_FramesSinceKeyframe - 1 : 0;
+	}
+
+	m_MemoryUsed -= Last.Data.size();
+	m_Entries.pop_back();
+
+	return State.Deserialize(m_Serialized.data(), m_Serialized.size());
+}
+
+void GBRewindBuffer::DropOldestKeyframe()
+{
+	//the keyframe and every delta against it
+	do
+	{
+		m_MemoryUsed -= m_Entries.front().Data.size();
+		m_Entries.pop_front();
+	} while (!m_Entries.empty() && !m_Entries.front().IsKeyframe);
+
+	m_KeyframeCount--;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Types.h"
+#include "SaveState.h"
+#include <deque>
+
+//History of per frame snapshots for rewinding. Every KeyframeInterval frames a keyframe is stored,
+//the frames in between are stored as the XOR against their keyframe, run length encoded. Most of
+//RAM and VRAM doesn't change from one frame to the next so those deltas are a few hundred bytes.
+//The oldest keyframe and its deltas are dropped together once the memory budget is exceeded
+class GBRewindBuffer
+{
+public:
+	static constexpr size_t DefaultBudget = 8 * 1024 * 1024;
+	static constexpr uint32 DefaultKeyframeInterval = 60;
+
+	void SetBudget(size_t Bytes);
+	void SetKeyframeInterval(uint32 Frames) { m_KeyframeInterval = (Frames > 0) ? Frames : 1; }
+
+	void Push(const GBSaveState& State);
+	//most recent snapshot, removed from the history. False once the history is empty
+	bool Pop(GBSaveState& State);
+	void Clear();
+
+	uint32 GetFrameCount() const { return uint32(m_Entries.size()); }
+	//encoded bytes held, what the budget is checked against
+	size_t GetMemoryUsed() const { return m_MemoryUsed; }
+
+private:
+	struct Entry
+	{
+		std::vector<uint8> Data;
+		bool IsKeyframe = false;
+	};
+
+	//Base nullptr encodes against zeros, that's how keyframes are stored
+	static void Encode(const uint8* Base, const uint8* Raw, uint32 Size, std::vector<uint8>& Out);
+	static void Decode(const uint8* Base, const std::vector<uint8>& Data, std::vector<uint8>& Out);
+
+	void DropOldestKeyframe();
+
+	std::deque<Entry> m_Entries;
+
+	//decoded keyframe of the newest entries, rebuilt on demand after its entry was popped
+	std::vector<uint8> m_Keyframe;
+	bool m_KeyframeValid = false;
+	uint32 m_FramesSinceKeyframe = 0;
+	uint32 m_KeyframeCount = 0;
+
+	std::vector<uint8> m_Serialized;
+	std::vector<uint8> m_Encoded;
+	size_t m_Budget = DefaultBudget;
+	size_t m_MemoryUsed = 0;
+	uint32 m_KeyframeInterval = DefaultKeyframeInterval;
+};
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "SDLFrontend.h"
+#include "Rendering.h"
+#include "GBSound.h"
+#include <algorithm>
+
+SDLFrontend::~SDLFrontend()
+{
+	if (m_Device != 0)
+	{
+		SDL_CloseAudioDevice(m_Device);
+	}
+
+	SDL_DestroyTexture(m_Texture);
+	SDL_DestroyRenderer(m_Renderer);
+	SDL_DestroyWindow(m_Window);
+
+	if (m_IsSDLInitialized)
+	{
+		SDL_Quit();
+	}
+}
+
+bool SDLFrontend::Init()
+{
+	if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
+	{
+		return false;
+	}
+	m_IsSDLInitialized = true;
+
+	m_Window = SDL_CreateWindow("Gameboy Emulator", 100, 100, ScreenData::SizeX * 4, ScreenData::SizeY * 4, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+	if (m_Window == nullptr)
+	{
+		return false;
+	}
+
+	m_Renderer = SDL_CreateRenderer(m_Window, -1, SDL_RENDERER_ACCELERATED /*| SDL_RENDERER_PRESENTVSYNC*/);
+	if (m_Renderer == nullptr)
+	{
+		return false;
+	}
+
+	m_Texture = SDL_CreateTexture(m_Renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, ScreenData::SizeX, ScreenData::SizeY);
+	if (m_Texture == nullptr)
+	{
+		return false;
+	}
+
+	SDL_AudioSpec Want, Have;
+	SDL_zero(Want);
+	Want.freq = GBSound::Frequency;
+	Want.format = AUDIO_F32;
+	Want.channels = 2;
+	Want.samples = GBSound::BufferSize / 2;
+	Want.callback = &SDLFrontend::AudioCallback;
+	Want.userdata = this;
+
+	//the APU synthesizes at whatever rate the device prefers, 44.1 or 48kHz usually
+	m_Device = SDL_OpenAudioDevice(NULL, 0, &Want, &Have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+	if (m_Device != 0)
+	{
+		m_SampleRate = Have.freq;
+	}
+	SDL_PauseAudioDevice(m_Device, 0);
+
+	return true;
+}
+
+GBPlatform SDLFrontend::GetPlatform()
+{
+	GBPlatform platform;
+	platform.Video = this;
+	platform.Audio = this;
+	platform.Input = this;
+	return platform;
+}
+
+void SDLFrontend::PresentFrame(const GBColor* Frame)
+{
+	//one upload per frame instead of one per line
+	SDL_UpdateTexture(m_Texture, NULL, Frame, ScreenData::SizeX * sizeof(GBColor));
+	SDL_RenderCopy(m_Renderer, m_Texture, NULL, NULL);
+	SDL_RenderPresent(m_Renderer);
+}
+
+void SDLFrontend::QueueSamples(const GBSoundSample* Samples, uint32 Count)
+{
+	//never blocks, if the device fell that far behind the overflow is dropped
+	m_AudioRing.Push(Samples, Count);
+}
+
+void SDLFrontend::AudioCallback(void* UserData, Uint8* Stream, int Length)
+{
+	SDLFrontend* Frontend = static_cast<SDLFrontend*>(UserData);
+	GBSoundSample* Samples = reinterpret_cast<GBSoundSample*>(Stream);
+	uint32 Count = uint32(Length) / sizeof(GBSoundSample);
+
+	//play silence on underrun
+	uint32 Read = Frontend->m_AudioRing.Pop(Samples, Count);
+	std::fill(Samples + Read, Samples + Count, GBSoundSample{ 0.0f, 0.0f });
+}
+
+void SDLFrontend::GetInputState(uint8& Joypad, uint8& Buttons)
+{
+	if (!m_PumpedExternally)
+	{
+		SDL_PumpEvents();
+		ReadKeyboard();
+	}
+	Joypad = m_Joypad.load(std::memory_order_relaxed);
+	Buttons = m_Buttons.load(std::memory_order_relaxed);
+}
+
+void SDLFrontend::ReadKeyboard()
+{
+	const Uint8 *keys = SDL_GetKeyboardState(NULL);
+	uint8 Joypad = JOYPAD_NONE;
+	uint8 Buttons = JOYPAD_NONE;
+
+	if (keys[SDL_SCANCODE_UP])
+	{
+		Joypad |= JOYPAD_INPUT_UP;
+	}
+
+	if (keys[SDL_SCANCODE_LEFT])
+	{
+		Joypad |= JOYPAD_INPUT_LEFT;
+	}
+
+	if (keys[SDL_SCANCODE_DOWN])
+	{
+		Joypad |= JOYPAD_INPUT_DOWN;
+	}
+
+	if (keys[SDL_SCANCODE_RIGHT])
+	{
+		Joypad |= JOYPAD_INPUT_RIGHT;
+	}
+
+	if (keys[SDL_SCANCODE_Z])
+	{
+		Buttons |= JOYPAD_BUTTONS_A;
+	}
+
+	if (keys[SDL_SCANCODE_X])
+	{
+		Buttons |= JOYPAD_BUTTONS_B;
+	}
+
+	if (keys[SDL_SCANCODE_RETURN])
+	{
+		Buttons |= JOYPAD_BUTTONS_START;
+	}
+
+	if (keys[SDL_SCANCODE_RSHIFT])
+	{
+		Buttons |= JOYPAD_BUTTONS_SELECT;
+	}
+
+	m_Joypad.store(Joypad, std::memory_order_relaxed);
+	m_Buttons.store(Buttons, std::memory_order_relaxed);
+	m_RewindHeld.store(keys[SDL_SCANCODE_BACKSPACE] != 0, std::memory_order_relaxed);
+}
+
+bool SDLFrontend::IsRewindHeld()
+{
+	if (!m_PumpedExternally)
+	{
+		ReadKeyboard();
+	}
+	return m_RewindHeld.load(std::memory_order_relaxed);
+}
+
+bool SDLFrontend::PollEvents()
+{
+	return m_PumpedExternally ? !m_QuitRequested.load(std::memory_order_relaxed) : PumpEvents();
+}
+
+bool SDLFrontend::PumpEvents()
+{
+	//window management
+	SDL_Event e;
+	while (SDL_PollEvent(&e) != 0)
+	{
+		if (e.type == SDL_QUIT)
+		{
+			m_QuitRequested.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	ReadKeyboard();
+	return !m_QuitRequested.load(std::memory_order_relaxed);
+}
\ No newline at end of file
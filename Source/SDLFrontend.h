@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Types.h"
+#include "Platform.h"
+#include "GBSound.h"
+#include "AudioRing.h"
+#include "Input.h"
+#include "SDL.h"
+#include <atomic>
+
+//Desktop frontend: window, audio device and keyboard through SDL. The window, renderer and texture
+//belong to the thread that calls Init, only it calls into SDL apart from the audio callback
+class SDLFrontend : public IVideoSink, public IAudioSink, public IInputSource
+{
+public:
+	~SDLFrontend();
+
+	bool Init();
+	GBPlatform GetPlatform();
+
+	//When emulation runs on another thread, the thread that called Init pumps events here instead
+	//and the input source calls only read what the last pump saw. False once the window is closed
+	void SetPumpedExternally(bool External) { m_PumpedExternally = External; }
+	bool PumpEvents();
+
+	//IVideoSink
+	virtual void PresentFrame(const GBColor* Frame) override;
+
+	//IAudioSink
+	virtual void QueueSamples(const GBSoundSample* Samples, uint32 Count) override;
+	virtual uint32 GetSampleRate() override { return m_SampleRate; }
+	virtual uint32 GetBufferedSamples() override { return m_AudioRing.GetFillLevel(); }
+	virtual uint32 GetBufferCapacity() override { return m_AudioRing.GetCapacity(); }
+
+	//IInputSource
+	virtual void GetInputState(uint8& Joypad, uint8& Buttons) override;
+	virtual bool PollEvents() override;
+	virtual bool IsRewindHeld() override;
+
+private:
+	//runs on the SDL audio thread
+	static void AudioCallback(void* UserData, Uint8* Stream, int Length);
+	void ReadKeyboard();
+
+	SDL_Window* m_Window = nullptr;
+	SDL_Renderer* m_Renderer = nullptr;
+	SDL_Texture* m_Texture = nullptr;
+
+	SDL_AudioDeviceID m_Device = 0;
+	uint32 m_SampleRate = GBSound::Frequency;
+	AudioRing m_AudioRing;
+	bool m_IsSDLInitialized = false;
+
+	//keyboard as of the last pump, read by the emulation thread
+	bool m_PumpedExternally = false;
+	std::atomic<uint8> m_Joypad{ JOYPAD_NONE };
+	std::atomic<uint8> m_Buttons{ JOYPAD_NONE };
+	std::atomic<bool> m_RewindHeld{ false };
+	std::atomic<bool> m_QuitRequested{ false };
+};
\ No newline at end of file
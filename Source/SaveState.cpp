@@ -0,0 +1,47 @@
+#include "SaveState.h"
+
+void GBSaveState::Serialize(std::vector<uint8>& Out) const
+{
+	Header Head;
+	Head.Magic = Magic;
+	Head.Version = Version;
+	Head.MachineSize = sizeof(GBMachineState);
+	Head.CartridgeRAMSize = uint32(CartridgeRAM.size());
+
+	Out.resize(sizeof(Header) + sizeof(GBMachineState) + CartridgeRAM.size());
+	uint8* Data = Out.data();
+	memcpy(Data, &Head, sizeof(Header));
+	memcpy(Data + sizeof(Header), &Machine, sizeof(GBMachineState));
+	if (!CartridgeRAM.empty())
+	{
+		memcpy(Data + sizeof(Header) + sizeof(GBMachineState), CartridgeRAM.data(), CartridgeRAM.size());
+	}
+}
+
+bool GBSaveState::Deserialize(const uint8* Data, size_t Size)
+{
+	Header Head;
+	if ((Data == nullptr) || (Size < sizeof(Header)))
+	{
+		return false;
+	}
+
+	memcpy(&Head, Data, sizeof(Header));
+	if ((Head.Magic != Magic) || (Head.Version != Version) || (Head.MachineSize != sizeof(GBMachineState)))
+	{
+		return false;
+	}
+
+	if (Size != sizeof(Header) + sizeof(GBMachineState) + Head.CartridgeRAMSize)
+	{
+		return false;
+	}
+
+	memcpy(&Machine, Data + sizeof(Header), sizeof(GBMachineState));
+	CartridgeRAM.resize(Head.CartridgeRAMSize);
+	if (Head.CartridgeRAMSize > 0)
+	{
+		memcpy(CartridgeRAM.data(), Data + sizeof(Header) + sizeof(GBMachineState), Head.CartridgeRAMSize);
+	}
+	return true;
+}
\ No newline at end of file
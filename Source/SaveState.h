@@ -0,0 +1,170 @@
+#pragma once
+
+#include "Types.h"
+#include "Scheduler.h"
+#include "Rendering.h"
+
+//Plain state blocks, one per component. They only hold machine state: host side output
+//(rendered frames, queued audio, frame skip and pacing) is left alone by a restore.
+
+struct GBCPUState
+{
+	uint16 AF;
+	uint16 BC;
+	uint16 DE;
+	uint16 HL;
+	uint16 PC;
+	uint16 SP;
+	uint8 BootSequence;
+	uint8 InterruptEnabled;
+	uint8 IsHalted;
+	uint64 FullCycles;
+};
+
+struct GBSchedulerState
+{
+	//GBScheduler::Never for events that aren't queued
+	uint64 Deadlines[GBEvents::Count];
+};
+
+struct GBMemoryState
+{
+	uint8 InternalRAM[0x2000];
+	uint8 HInternalRAM[0x7F];
+	uint8 IsBooting;
+	uint8 InterruptFlags;
+	uint8 InterruptEnabled;
+};
+
+struct GBGPUState
+{
+	uint8 VRAM[0x2000];
+	uint8 OAM[0x100];
+
+	int32 ModeCycles;
+	uint64 LastUpdateCycle;
+	int32 DMATransferRemainingCycles;
+
+	uint8 LY;
+	uint8 LYCompare;
+	uint8 LCDControl;
+	uint8 LCDStatus;
+	uint8 ScrollX;
+	uint8 ScrollY;
+	uint8 WinPosX;
+	uint8 WinPosY;
+	uint8 BGPalette;
+	uint8 ObjPalette0;
+	uint8 ObjPalette1;
+
+	//result of the last OAM scan
+	uint8 SpriteCount;
+	uint8 Sprites[GBLineState::MaxSpritesPerLine];
+};
+
+struct GBCounterState
+{
+	uint8 Value;
+	uint8 ReloadValue;
+	uint8 IsRunning;
+	int32 CounterCycles;
+	int32 CurrentCycles;
+};
+
+struct GBTimerState
+{
+	uint64 LastUpdateCycle;
+	GBCounterState Divider;
+	GBCounterState Timer;
+	uint8 TimerModulo;
+	uint8 TimerControl;
+};
+
+struct GBInputState
+{
+	uint8 SelectColumn;
+	uint8 Buttons;
+	uint8 Joypad;
+};
+
+//one layout for all four channels, each one only uses its own fields
+struct GBChannelState
+{
+	uint8 SoundLength;
+	uint8 Envelope;
+	uint8 FrequencyLo;
+	uint8 FrequencyHiControl;
+	uint8 Sweep;
+	uint8 OnOff;
+	uint8 Amplitude;
+	uint8 Output;
+	int32 PeriodTimer;
+	int32 EnvelopeTimer;
+	int32 SweepTimer;
+	int32 Step;
+	uint16 ShiftRegister;
+	uint8 Waveform[32];
+};
+
+struct GBSoundState
+{
+	uint8 WavePattern[16];
+	uint8 NR50;
+	uint8 NR51;
+	uint8 NR52;
+	uint8 FrameSequencerStep;
+	int32 FrameSequencerCycles;
+	uint64 FrameStartCycle;
+	uint64 LastUpdateCycle;
+	GBChannelState Channels[4];
+};
+
+struct GBCartridgeState
+{
+	uint8 IsRAMEnabled;
+	uint8 ROMBank;
+	uint8 ROMRAMBankUpper;
+	uint8 ROMRAMMode;
+	uint8 RAMBank;
+	uint8 RTCRegisters[5];
+};
+
+struct GBMachineState
+{
+	GBCPUState CPU;
+	GBSchedulerState Scheduler;
+	GBMemoryState Memory;
+	GBGPUState GPU;
+	GBTimerState Timer;
+	GBInputState Input;
+	GBSoundState Sound;
+	GBCartridgeState Cartridge;
+};
+
+//Snapshot of the whole machine. Taking and restoring one is a handful of memcpys, the
+//buffers are reused so a snapshot that is saved over and over doesn't allocate.
+//Serialized form: header, the machine block as is, then the cartridge RAM. The block is
+//copied raw, so snapshots only load into builds with the same version and block layout
+struct GBSaveState
+{
+	static constexpr uint32 Magic = 0x53534247; //"GBSS"
+	static constexpr uint32 Version = 1;
+
+	struct Header
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 MachineSize;
+		uint32 CartridgeRAMSize;
+	};
+
+	//padding bytes are serialized too, zeroed so equal machines give equal bytes
+	GBSaveState() { memset(&Machine, 0, sizeof(Machine)); }
+
+	GBMachineState Machine;
+	std::vector<uint8> CartridgeRAM;
+
+	void Serialize(std::vector<uint8>& Out) const;
+	//false if the data is truncated or comes from another version or layout, the state is then unchanged
+	bool Deserialize(const uint8* Data, size_t Size);
+};
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "Scheduler.h"
+#include "SaveState.h"
+
+GBScheduler::GBScheduler()
+{
+	for (int32 i = 0; i < GBEvents::Count; ++i)
+	{
+		m_Heap[i] = 0;
+		m_HeapIndex[i] = -1;
+		m_Deadlines[i] = Never;
+		m_Handlers[i] = nullptr;
+	}
+}
+
+bool GBScheduler::IsEarlier(uint8 A, uint8 B) const
+{
+	//ties go to the lower id so the order is deterministic
+	if (m_Deadlines[A] != m_Deadlines[B])
+	{
+		return m_Deadlines[A] < m_Deadlines[B];
+	}
+	return A < B;
+}
+
+void GBScheduler::Swap(int32 A, int32 B)
+{
+	uint8 Temp = m_Heap[A];
+	m_Heap[A] = m_Heap[B];
+	m_Heap[B] = Temp;
+
+	m_HeapIndex[m_Heap[A]] = A;
+	m_HeapIndex[m_Heap[B]] = B;
+}
+
+void GBScheduler::SiftUp(int32 Index)
+{
+	while (Index > 0)
+	{
+		int32 Parent = (Index - 1) / 2;
+		if (!IsEarlier(m_Heap[Index], m_Heap[Parent]))
+		{
+			break;
+		}
+		Swap(Index, Parent);
+		Index = Parent;
+	}
+}
+
+void GBScheduler::SiftDown(int32 Index)
+{
+	while (true)
+	{
+		int32 Smallest = Index;
+		int32 Left = Index * 2 + 1;
+		int32 Right = Left + 1;
+
+		if ((Left < m_HeapSize) && IsEarlier(m_Heap[Left], m_Heap[Smallest]))
+		{
+			Smallest = Left;
+		}
+
+		if ((Right < m_HeapSize) && IsEarlier(m_Heap[Right], m_Heap[Smallest]))
+		{
+			Smallest = Right;
+		}
+
+		if (Smallest == Index)
+		{
+			break;
+		}
+
+		Swap(Index, Smallest);
+		Index = Smallest;
+	}
+}
+
+void GBScheduler::RemoveAt(int32 Index)
+{
+	uint8 EventId = m_Heap[Index];
+	m_HeapSize--;
+	if (Index != m_HeapSize)
+	{
+		Swap(Index, m_HeapSize);
+		SiftDown(Index);
+		SiftUp(Index);
+	}
+
+	m_HeapIndex[EventId] = -1;
+	m_Deadlines[EventId] = Never;
+}
+
+void GBScheduler::Schedule(uint8 EventId, uint64 Deadline)
+{
+	int32 Index = m_HeapIndex[EventId];
+	if (Index < 0)
+	{
+		Index = m_HeapSize++;
+		m_Heap[Index] = EventId;
+		m_HeapIndex[EventId] = Index;
+	}
+
+	m_Deadlines[EventId] = Deadline;
+	SiftUp(Index);
+	SiftDown(m_HeapIndex[EventId]);
+}
+
+void GBScheduler::Deschedule(uint8 EventId)
+{
+	int32 Index = m_HeapIndex[EventId];
+	if (Index >= 0)
+	{
+		RemoveAt(Index);
+	}
+}
+
+void GBScheduler::RunDueEvents(uint64 Now)
+{
+	while ((m_HeapSize > 0) && (m_Deadlines[m_Heap[0]] <= Now))
+	{
+		uint8 EventId = m_Heap[0];
+		uint64 Deadline = m_Deadlines[EventId];
+		RemoveAt(0);
+
+		if (m_Handlers[EventId] != nullptr)
+		{
+			m_Handlers[EventId]->OnEvent(EventId, Deadline, Now);
+		}
+	}
+}
+
+void GBScheduler::SaveState(GBSchedulerState& State) const
+{
+	for (int32 i = 0; i < GBEvents::Count; ++i)
+	{
+		State.Deadlines[i] = GetDeadline(uint8(i));
+	}
+}
+
+void GBScheduler::LoadState(const GBSchedulerState& State)
+{
+	for (int32 i = 0; i < GBEvents::Count; ++i)
+	{
+		if (State.Deadlines[i] == Never)
+		{
+			Deschedule(uint8(i));
+		}
+		else
+		{
+			Schedule(uint8(i), State.Deadlines[i]);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Types.h"
+
+struct GBSchedulerState;
+
+namespace GBEvents
+{
+	static constexpr uint8 FrameEnd = 0;
+	static constexpr uint8 GPUMode = 1;
+	static constexpr uint8 TimerOverflow = 2;
+	static constexpr uint8 SoundBuffer = 3;
+	static constexpr uint8 Count = 4;
+}
+
+class IEventHandler
+{
+public:
+	virtual ~IEventHandler() = default;
+
+	//Deadline is the cycle count the event was scheduled for, Now the instruction boundary it is
+	//handled on, always >= Deadline
+	virtual void OnEvent(uint8 EventId, uint64 Deadline, uint64 Now) = 0;
+};
+
+//Cycle timestamped event queue. Every event id is in the queue at most once,
+//components reschedule their own event whenever their timing changes.
+class GBScheduler
+{
+public:
+	static constexpr uint64 Never = ~0ull;
+
+	GBScheduler();
+
+	void SetHandler(uint8 EventId, IEventHandler* Handler) { m_Handlers[EventId] = Handler; }
+
+	void Schedule(uint8 EventId, uint64 Deadline);
+	void Deschedule(uint8 EventId);
+	bool IsScheduled(uint8 EventId) const { return m_HeapIndex[EventId] >= 0; }
+	uint64 GetDeadline(uint8 EventId) const { return IsScheduled(EventId) ? m_Deadlines[EventId] : Never; }
+
+	uint64 GetNextDeadline() const
+	{
+		return (m_HeapSize > 0) ? m_Deadlines[m_Heap[0]] : Never;
+	}
+
+	//runs every event whose deadline is <= Now, earliest first
+	void RunDueEvents(uint64 Now);
+
+	//deadlines only, handlers stay as they are
+	void SaveState(GBSchedulerState& State) const;
+	void LoadState(const GBSchedulerState& State);
+
+private:
+	bool IsEarlier(uint8 A, uint8 B) const;
+	void SiftUp(int32 Index);
+	void SiftDown(int32 Index);
+	void Swap(int32 A, int32 B);
+	void RemoveAt(int32 Index);
+
+	//binary min-heap of event ids, m_HeapIndex maps an id back to its heap slot (-1 if not queued)
+	uint8 m_Heap[GBEvents::Count];
+	int32 m_HeapIndex[GBEvents::Count];
+	uint64 m_Deadlines[GBEvents::Count];
+	IEventHandler* m_Handlers[GBEvents::Count];
+	int32 m_HeapSize = 0;
+};
\ No newline at end of file
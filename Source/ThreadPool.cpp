@@ -0,0 +1,134 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace
+{
+	//pool and queue of the worker running on this thread, nullptr on other threads
+	thread_local GBThreadPool* t_WorkerPool = nullptr;
+	thread_local uint32 t_WorkerIndex = 0;
+}
+
+GBThreadPool::GBThreadPool(uint32 Threads)
+{
+	if (Threads == 0)
+	{
+		Threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	for (uint32 i = 0; i < Threads; ++i)
+	{
+		m_Queues.push_back(std::make_unique<WorkQueue>());
+	}
+
+	for (uint32 i = 0; i < Threads; ++i)
+	{
+		m_Workers.emplace_back(&GBThreadPool::WorkerMain, this, i);
+	}
+}
+
+GBThreadPool::~GBThreadPool()
+{
+	Wait();
+
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_Stopping = true;
+	}
+	m_WorkReady.notify_all();
+
+	for (std::thread& Worker : m_Workers)
+	{
+		Worker.join();
+	}
+}
+
+void GBThreadPool::Submit(Task NewTask)
+{
+	uint32 Index = (t_WorkerPool == this) ? t_WorkerIndex : (m_NextQueue.fetch_add(1, std::memory_order_relaxed) % GetThreadCount());
+
+	m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+	//counted before the push, a worker may take the task as soon as it is queued and must not
+	//take the count below zero. Under the pool lock so a worker going to sleep can't miss it
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_Queued.fetch_add(1, std::memory_order_release);
+	}
+
+	{
+		WorkQueue& Queue = *m_Queues[Index];
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		Queue.Tasks.push_back(std::move(NewTask));
+	}
+	m_WorkReady.notify_one();
+}
+
+void GBThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> Lock(m_Mutex);
+	m_AllDone.wait(Lock, [this]() { return m_Pending.load(std::memory_order_acquire) == 0; });
+}
+
+bool GBThreadPool::PopOwn(uint32 Index, Task& Out)
+{
+	//newest first, its data is the most likely to still be in cache
+	WorkQueue& Queue = *m_Queues[Index];
+	std::lock_guard<std::mutex> Lock(Queue.Mutex);
+	if (Queue.Tasks.empty())
+	{
+		return false;
+	}
+
+	Out = std::move(Queue.Tasks.back());
+	Queue.Tasks.pop_back();
+	return true;
+}
+
+bool GBThreadPool::Steal(uint32 Index, Task& Out)
+{
+	//oldest first, the opposite end from the owner
+	uint32 Count = GetThreadCount();
+	for (uint32 i = 1; i < Count; ++i)
+	{
+		WorkQueue& Queue = *m_Queues[(Index + i) % Count];
+		std::lock_guard<std::mutex> Lock(Queue.Mutex);
+		if (!Queue.Tasks.empty())
+		{
+			Out = std::move(Queue.Tasks.front());
+			Queue.Tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void GBThreadPool::WorkerMain(uint32 Index)
+{
+	t_WorkerPool = this;
+	t_WorkerIndex = Index;
+
+	Task Current;
+	while (true)
+	{
+		if (PopOwn(Index, Current) || Steal(Index, Current))
+		{
+			m_Queued.fetch_sub(1, std::memory_order_relaxed);
+			Current();
+			Current = nullptr;
+
+			if (m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+				m_AllDone.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> Lock(m_Mutex);
+		m_WorkReady.wait(Lock, [this]() { return m_Stopping || (m_Queued.load(std::memory_order_acquire) > 0); });
+		if (m_Stopping && (m_Queued.load(std::memory_order_acquire) == 0))
+		{
+			return;
+		}
+	}
+}
\ No newline at end of file
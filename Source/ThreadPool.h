@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Types.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//Work stealing pool for independent jobs of very different lengths. Every worker has its own queue,
+//takes its newest task first and steals the oldest task of another worker once its queue runs dry,
+//so a worker stuck on a long job never leaves short ones waiting behind it
+class GBThreadPool
+{
+public:
+	using Task = std::function<void()>;
+
+	//0 uses every hardware thread
+	explicit GBThreadPool(uint32 Threads = 0);
+	~GBThreadPool();
+
+	//tasks submitted from a worker go to its own queue, others are spread round robin
+	void Submit(Task NewTask);
+	//returns once every submitted task has finished, tasks may still submit more meanwhile
+	void Wait();
+
+	uint32 GetThreadCount() const { return uint32(m_Queues.size()); }
+
+private:
+	struct WorkQueue
+	{
+		std::mutex Mutex;
+		std::deque<Task> Tasks;
+	};
+
+	bool PopOwn(uint32 Index, Task& Out);
+	bool Steal(uint32 Index, Task& Out);
+	void WorkerMain(uint32 Index);
+
+	std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+	std::vector<std::thread> m_Workers;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkReady;
+	std::condition_variable m_AllDone;
+	//tasks sitting in a queue, and tasks submitted but not finished yet
+	std::atomic<uint32> m_Queued{ 0 };
+	std::atomic<uint32> m_Pending{ 0 };
+	std::atomic<uint32> m_NextQueue{ 0 };
+	bool m_Stopping = false;
+};
\ No newline at end of file
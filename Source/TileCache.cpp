@@ -0,0 +1,20 @@
+#include "TileCache.h"
+#include "LineCompositor.h"
+#include <algorithm>
+
+void GBTileCache::Init(const uint8* TileData)
+{
+	m_TileData = TileData;
+	InvalidateAll();
+}
+
+void GBTileCache::InvalidateAll()
+{
+	std::fill(m_Dirty, m_Dirty + TileCount, true);
+}
+
+void GBTileCache::Decode(uint32 Tile)
+{
+	LineCompositor::DecodeTile(m_TileData + Tile * TileSizeBytes, m_Pixels[Tile]);
+	m_Dirty[Tile] = false;
+}
\ No newline at end of file
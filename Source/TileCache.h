@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Types.h"
+
+//Decoded copy of the 384 tiles in VRAM, one color index (0-3) per byte.
+//Tiles are decoded lazily on first use after a write invalidated them.
+class GBTileCache
+{
+public:
+	static constexpr uint32 TileCount = 384;
+	static constexpr uint32 TileSizeBytes = 16;
+	static constexpr uint32 TilePixels = 64;
+	static constexpr uint16 TileDataSize = TileCount * TileSizeBytes; //0x8000-0x97FF
+
+	//TileData points at the start of VRAM and must outlive the cache
+	void Init(const uint8* TileData);
+
+	//Offset is relative to 0x8000, map writes are ignored
+	void Invalidate(uint16 Offset)
+	{
+		if (Offset < TileDataSize)
+		{
+			m_Dirty[Offset / TileSizeBytes] = true;
+		}
+	}
+	void InvalidateAll();
+
+	//8 color indices of one row, leftmost pixel first
+	const uint8* GetTileRow(uint32 Tile, uint32 Row)
+	{
+		if (m_Dirty[Tile])
+		{
+			Decode(Tile);
+		}
+		return &m_Pixels[Tile][Row * 8];
+	}
+
+	//Tile index as the BG and window maps see it, signed addressing starts at tile 256
+	static uint32 GetBGTile(uint8 MapEntry, bool UnsignedAddressing)
+	{
+		return UnsignedAddressing ? MapEntry : uint32(256 + int8(MapEntry));
+	}
+
+private:
+	void Decode(uint32 Tile);
+
+	const uint8* m_TileData = nullptr;
+	uint8 m_Pixels[TileCount][TilePixels];
+	bool m_Dirty[TileCount];
+};
\ No newline at end of file
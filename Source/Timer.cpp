@@ -1,3 +0,0 @@
-#include "Timer.h"
-
-double Timer::SecondsPerCycle = 0.0;
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
+#include "Platform.h"
+#include <chrono>
 
 class Timer
 {
@@ -11,27 +11,31 @@ public:
 
 	}
 
-	static void InitTimer()
+	static double GetSeconds()
 	{
-		LARGE_INTEGER IntFrequency;
-		QueryPerformanceFrequency(&IntFrequency);
-		SecondsPerCycle = 1.0 / IntFrequency.QuadPart;
+		using namespace std::chrono;
+		return duration<double>(steady_clock::now().time_since_epoch()).count();
 	}
 
 	void Start()
 	{
-		QueryPerformanceCounter(&StartTime);
+		StartTime = GetSeconds();
 	}
 
 	double End()
 	{
-		LARGE_INTEGER EndTimer;
-		QueryPerformanceCounter(&EndTimer);
-
-		return (double(EndTimer.QuadPart)  - double(StartTime.QuadPart))* SecondsPerCycle;
+		return GetSeconds() - StartTime;
 	}
 
 private:
-	static double SecondsPerCycle;
-	LARGE_INTEGER StartTime;
+	double StartTime = 0.0;
+};
+
+class SteadyClock : public IClock
+{
+public:
+	virtual double GetSeconds() override
+	{
+		return Timer::GetSeconds();
+	}
 };
\ No newline at end of file
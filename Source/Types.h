@@ -1,15 +1,17 @@
 #pragma once
 #include <memory>
 #include <string>
-#include <xstring>
-#include <codecvt>
+#include <cstring>
 #include <unordered_map>
 #include <vector>
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#pragma warning(disable :4251)
 
+#if defined(_MSC_VER)
+#pragma warning(disable :4251)
 #define ALIGN(val) __declspec(align(val))
+#else
+#define ALIGN(val) __attribute__((aligned(val)))
+#define __forceinline inline
+#endif
 
 using int32 = signed int;
 using int64 = signed long long;
@@ -19,6 +21,7 @@ using uint64 = unsigned long long;
 using uint8 = unsigned char;
 using int8 = signed char;
 using uint16 = unsigned short;
+using int16 = signed short;
 using INT16 = signed short;
 
 
@@ -2,8 +2,12 @@
 #include <windows.h>
 #include "CPU.h"
 #include "Cartridge.h"
-#include "Timer.h"
+#include "SDLFrontend.h"
 #include <commdlg.h>
+#include <atomic>
+#include <cwchar>
+#include <cstdlib>
+#include <thread>
 
 
 int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
@@ -13,7 +17,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 {
 	GameBoyCPU CPU;
 	Cartridge cart;
-	Timer::InitTimer();
+	SDLFrontend frontend;
 
 	if (IsDebuggerPresent())
 	{
@@ -79,9 +83,81 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 		}
 	}
 
+	if (!frontend.Init())
+	{
+		return 0;
+	}
+
+	CPU.SetPlatform(frontend.GetPlatform());
 	CPU.SetCartridge(&cart);
+
+	//-unthrottled runs as fast as possible, -speed N runs at N times real time,
+	//-audiosync paces off the audio device instead of the clock
+	if (wcsstr(lpCmdLine, L"-unthrottled") != nullptr)
+	{
+		CPU.GetDefaultPacer().SetMode(EPacingMode::Unthrottled);
+	}
+	else if (const wchar_t* speedArg = wcsstr(lpCmdLine, L"-speed"))
+	{
+		CPU.GetDefaultPacer().SetMode(EPacingMode::Multiplier, std::wcstod(speedArg + 6, nullptr));
+	}
+	else if (wcsstr(lpCmdLine, L"-audiosync") != nullptr)
+	{
+		CPU.SetAudioSync(0.05);
+	}
+
+	//-threaded draws on a render thread, see below for presenting
+	bool threaded = wcsstr(lpCmdLine, L"-threaded") != nullptr;
+	CPU.SetThreadedRendering(threaded);
+
+	//-frameskip N draws one frame out of N + 1, -autoskip only skips while running late
+	if (const wchar_t* skipArg = wcsstr(lpCmdLine, L"-frameskip"))
+	{
+		CPU.SetFrameSkip(uint32(std::wcstoul(skipArg + 10, nullptr, 10)));
+	}
+	else if (wcsstr(lpCmdLine, L"-autoskip") != nullptr)
+	{
+		CPU.SetAutoFrameSkip(true);
+	}
 	
+	//-runahead N shows the frame N frames ahead of the real one
+	if (const wchar_t* aheadArg = wcsstr(lpCmdLine, L"-runahead"))
+	{
+		CPU.SetRunAhead(uint32(std::wcstoul(aheadArg + 9, nullptr, 10)));
+	}
+
+	//-rewind N keeps N MB of history, played back while backspace is held
+	GBRewindBuffer rewind;
+	if (const wchar_t* rewindArg = wcsstr(lpCmdLine, L"-rewind"))
+	{
+		rewind.SetBudget(size_t(std::wcstoul(rewindArg + 7, nullptr, 10)) * 1024 * 1024);
+		CPU.SetRewindBuffer(&rewind);
+	}
+
 	CPU.TurnOn();
-	CPU.Run(true);
+	if (!threaded)
+	{
+		CPU.Run(true);
+		return 0;
+	}
+
+	//Emulation moves to its own thread, this one keeps the window: it pumps events and presents
+	//frames as the render thread finishes them, so emulation never waits on vsync or the driver
+	frontend.SetPumpedExternally(true);
+	std::atomic<bool> running(true);
+	std::thread emulation([&]()
+	{
+		CPU.Run(true);
+		running.store(false);
+	});
+
+	while (running.load())
+	{
+		//closing the window ends Run at its next frame
+		frontend.PumpEvents();
+		CPU.PresentRenderedFrame(4);
+	}
+
+	emulation.join();
 	return 0;
 }
\ No newline at end of file